@@ -0,0 +1,32 @@
+﻿
+using UnityEditor;
+using UnityEditor.Build;
+using UnityEditor.Build.Reporting;
+using UnityEngine;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 打包前重新编译预编译的表, 发布版本不会用到过期的表
+    /// 地块构造表是C#代码, 打包时已经编译好, 不能在这里重新生成, 过期时打包失败
+    /// </summary>
+    public class ConceptTableBuilder : IPreprocessBuildWithReport
+    {
+        // 本地化的json和语言列表配置在这个预制体上
+        public const string LocalizationPrefabPath = "Assets/Scripts/Core/Concept/Localization.prefab";
+
+        public int callbackOrder => 0;
+
+        public void OnPreprocessBuild(BuildReport report) {
+            if (!TileFactoryGenerator.IsCurrent()) {
+                throw new BuildFailedException($"地块构造表过期, 请先执行菜单 Weathering/生成地块构造表 ({TileFactoryGenerator.OutputPath})");
+            }
+
+            AttributesPreprocessor.CompileTableToResources();
+
+            GameObject prefab = AssetDatabase.LoadAssetAtPath<GameObject>(LocalizationPrefabPath);
+            if (prefab == null) throw new BuildFailedException($"找不到 {LocalizationPrefabPath}");
+            prefab.GetComponent<Localization>().CompileTables();
+        }
+    }
+}
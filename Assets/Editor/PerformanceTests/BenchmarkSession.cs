@@ -0,0 +1,94 @@
+﻿
+using System;
+using System.Collections;
+using System.IO;
+using UnityEditor;
+using UnityEditor.SceneManagement;
+using UnityEditor.TestTools;
+using UnityEngine;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 性能测试的运行环境
+    /// 1. 游戏代码没有程序集定义, 测试只能放在Assembly-CSharp-Editor, 以编辑模式测试运行, 自己进入播放模式
+    /// 2. 进入播放模式前把存档目录换成临时目录, 每次都是新游戏, 不读写玩家存档
+    /// 3. 地图等单例要在播放模式里由场景创建, 所以测试在这里等待GameEntry进入初始地图
+    /// </summary>
+    public static class BenchmarkSession
+    {
+        public const string ScenePath = "Assets/Scenes/SampleScene.unity";
+        public const string Category = "Benchmark";
+
+        // 大小为50和149的两颗行星, 星球大小范围是50到149
+        public const string SmallPlanetKey = "Weathering.MapOfPlanet#=1,4=13,47=22,15";
+        public const string LargePlanetKey = "Weathering.MapOfPlanet#=1,4=6,92=1,10";
+
+        private static string PersistentRoot => Path.Combine(Path.GetTempPath(), "WeatheringBenchmark");
+
+        public static IEnumerator Enter() {
+            if (!Application.isPlaying) {
+                string root = PersistentRoot;
+                if (Directory.Exists(root)) Directory.Delete(root, true);
+                Directory.CreateDirectory(root);
+                Environment.SetEnvironmentVariable(DataPersistence.PersistentRootVariable, root); // 进程级, 域重载后仍然有效
+                EditorSceneManager.OpenScene(ScenePath);
+                yield return new EnterPlayMode();
+            }
+            while (GameEntry.Ins == null || MapView.Ins == null || MapView.Ins.TheOnlyActiveMap == null) {
+                yield return null;
+            }
+            GameConfig.CheatMode = true; // 建造不消耗资源
+            UI.Ins.Active = false;
+        }
+
+        public static IEnumerator Exit() {
+            if (Application.isPlaying) {
+                DataPersistence.Ins.FlushSaves();
+                yield return new ExitPlayMode();
+            }
+            Environment.SetEnvironmentVariable(DataPersistence.PersistentRootVariable, null);
+        }
+
+        /// <summary>
+        /// 进入地图并等一帧, 让MapView画完整个视野
+        /// </summary>
+        public static IEnumerator EnterMap(string mapKey) {
+            GameEntry.Ins.EnterMap(mapKey);
+            UI.Ins.Active = false;
+            yield return null;
+        }
+
+        /// <summary>
+        /// 按GameEntry.EnterMap的步骤新建地图, 但不加入常驻地图, 也不存档
+        /// 上级地块和地形生成要求地图处于活跃状态, 所以临时切换活跃地图, 用完调用Restore
+        /// 临时地图要与当前活跃地图在同一个恒星系, 通常就用当前地图的MapKey
+        /// </summary>
+        public static IMapDefinition ConstructDetached(string mapKey, bool enable = true) {
+            if (savedActiveMap == null) {
+                savedActiveMap = MapView.Ins.TheOnlyActiveMap;
+                savedCameraPosition = MapView.Ins.CameraPosition;
+            }
+            IMapDefinition map = Activator.CreateInstance(TypeRegistry.Find(mapKey.Split(GameEntry.MAGIC_CHAR)[0])) as IMapDefinition;
+            if (map == null) throw new Exception(mapKey);
+            map.MapKey = mapKey;
+            map.HashCode = HashUtility.Hash(mapKey);
+            MapView.Ins.TheOnlyActiveMap = map;
+            map.OnConstruct();
+            if (enable) map.OnEnable();
+            return map;
+        }
+        private static IMap savedActiveMap = null;
+        private static Vector2 savedCameraPosition;
+
+        /// <summary>
+        /// 换回ConstructDetached之前的活跃地图和镜头位置
+        /// </summary>
+        public static void Restore() {
+            if (savedActiveMap == null) return;
+            MapView.Ins.TheOnlyActiveMap = savedActiveMap;
+            MapView.Ins.CameraPosition = savedCameraPosition;
+            savedActiveMap = null;
+        }
+    }
+}
@@ -0,0 +1,225 @@
+﻿
+using System;
+using System.Collections;
+using NUnit.Framework;
+using Unity.PerformanceTesting;
+using UnityEngine;
+using UnityEngine.TestTools;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 核心系统的性能测试, 结果由Performance Testing记录, compare.py与基线比较
+    /// 每个测试在临时存档的新游戏里运行, 见BenchmarkSession
+    /// </summary>
+    [TestFixture, Category(BenchmarkSession.Category)]
+    public class CoreBenchmarks
+    {
+        private const int warmupCount = 1;
+        private const int measurementCount = 10;
+
+        [UnitySetUp]
+        public IEnumerator SetUp() {
+            yield return BenchmarkSession.Enter();
+        }
+
+        [UnityTearDown]
+        public IEnumerator TearDown() {
+            BenchmarkSession.Restore();
+            yield return BenchmarkSession.Exit();
+        }
+
+        // 建造地图
+
+        [UnityTest, Performance]
+        public IEnumerator ConstructMapBody_Planet50() => ConstructMapBody(BenchmarkSession.SmallPlanetKey);
+        [UnityTest, Performance]
+        public IEnumerator ConstructMapBody_Planet149() => ConstructMapBody(BenchmarkSession.LargePlanetKey);
+
+        private static IEnumerator ConstructMapBody(string mapKey) {
+            yield return BenchmarkSession.EnterMap(mapKey);
+            IMapDefinition map = null;
+            Measure.Method(() => GameEntry.ConstructMapBody(map))
+                .SetUp(() => map = BenchmarkSession.ConstructDetached(mapKey))
+                .CleanUp(BenchmarkSession.Restore)
+                .WarmupCount(warmupCount)
+                .MeasurementCount(measurementCount)
+                .GC()
+                .Run();
+        }
+
+        // 读档
+
+        [UnityTest, Performance]
+        public IEnumerator LoadMapBody_Planet50() => LoadMapBody(BenchmarkSession.SmallPlanetKey);
+        [UnityTest, Performance]
+        public IEnumerator LoadMapBody_Planet149() => LoadMapBody(BenchmarkSession.LargePlanetKey);
+
+        private static IEnumerator LoadMapBody(string mapKey) {
+            yield return BenchmarkSession.EnterMap(mapKey);
+            IDataPersistence data = DataPersistence.Ins;
+
+            // 先在临时存档里写一份完整的地图
+            IMapDefinition source = BenchmarkSession.ConstructDetached(mapKey);
+            GameEntry.ConstructMapBody(source);
+            data.BeginSave(TimeUtility.GetTicks());
+            data.SaveMapBody(source);
+            data.EndSave();
+            data.FlushSaves();
+            BenchmarkSession.Restore();
+
+            IMapDefinition map = null;
+            Measure.Method(() => data.LoadMapBody(map, mapKey))
+                .SetUp(() => map = BenchmarkSession.ConstructDetached(mapKey))
+                .CleanUp(BenchmarkSession.Restore)
+                .WarmupCount(warmupCount)
+                .MeasurementCount(measurementCount)
+                .GC()
+                .Run();
+        }
+
+        // 存档序列化, 记录耗时和大小。主线程只复制快照(Capture), 编码和压缩在存档线程, 分开记录
+
+        [UnityTest, Performance]
+        public IEnumerator SaveMapBody_Planet50() => SaveMapBody(BenchmarkSession.SmallPlanetKey);
+        [UnityTest, Performance]
+        public IEnumerator SaveMapBody_Planet149() => SaveMapBody(BenchmarkSession.LargePlanetKey);
+
+        private static IEnumerator SaveMapBody(string mapKey) {
+            yield return BenchmarkSession.EnterMap(mapKey);
+            IMapDefinition map = BenchmarkSession.ConstructDetached(mapKey);
+            GameEntry.ConstructMapBody(map);
+            MapBodySnapshot snapshot = null;
+            Measure.Method(() => snapshot = MapBodySnapshot.Capture(map, false))
+                .WarmupCount(warmupCount)
+                .MeasurementCount(measurementCount)
+                .SampleGroup(new SampleGroup("Capture", SampleUnit.Millisecond))
+                .GC()
+                .Run();
+            byte[] bytes = null;
+            Measure.Method(() => bytes = MapBodyFormat.Serialize(snapshot, 1, GameConfig.CompressSaves))
+                .WarmupCount(warmupCount)
+                .MeasurementCount(measurementCount)
+                .SampleGroup(new SampleGroup("Serialize", SampleUnit.Millisecond))
+                .GC()
+                .Run();
+            Measure.Custom(new SampleGroup("SerializedBytes", SampleUnit.Byte), bytes.Length);
+            BenchmarkSession.Restore();
+        }
+
+        // 地形生成。地形在OnEnable里生成, 清空地形缓存后用PerformanceCounters只取GenerateNoise一段
+
+        [UnityTest, Performance]
+        public IEnumerator GenerateNoise_Planet50() => GenerateNoise(BenchmarkSession.SmallPlanetKey);
+        [UnityTest, Performance]
+        public IEnumerator GenerateNoise_Planet149() => GenerateNoise(BenchmarkSession.LargePlanetKey);
+
+        private static IEnumerator GenerateNoise(string mapKey) {
+            yield return BenchmarkSession.EnterMap(mapKey);
+            SampleGroup group = new SampleGroup(nameof(PerformanceSection.GenerateNoise), SampleUnit.Millisecond);
+            string diskPath = TerrainFieldCache.DiskPath;
+            TerrainFieldCache.DiskPath = null;
+            PerformanceCounters.SetRecording(true);
+            try {
+                for (int i = 0; i < warmupCount + measurementCount; i++) {
+                    TerrainFieldCache.ClearMemory();
+                    IMapDefinition map = BenchmarkSession.ConstructDetached(mapKey, false);
+                    PerformanceCounters.EndFrame(i, 0, 0);
+                    map.OnEnable();
+                    PerformanceCounters.EndFrame(i, 0, 0);
+                    BenchmarkSession.Restore();
+                    if (i >= warmupCount) Measure.Custom(group, PerformanceCounters.SectionMs(PerformanceSection.GenerateNoise));
+                }
+            } finally {
+                PerformanceCounters.SetRecording(false);
+                TerrainFieldCache.DiskPath = diskPath;
+            }
+        }
+
+        // 背包按标签移除。所有概念类型各放一堆, 按最常用的标签移除
+
+        [UnityTest, Performance]
+        public IEnumerator Inventory_RemoveWithTag() {
+            Inventory inventory = Inventory.GetOne();
+            inventory.QuantityCapacity = long.MaxValue / 4;
+            inventory.TypeCapacity = int.MaxValue;
+            foreach (Type type in AttributesPreprocessor.Ins.DependAttributeList) {
+                inventory.Add(type, 1_000_000_000);
+            }
+            Measure.Method(() => inventory.RemoveWithTag<DiscardableSolid>(10))
+                .WarmupCount(warmupCount)
+                .MeasurementCount(measurementCount)
+                .IterationsPerMeasurement(1000)
+                .GC()
+                .Run();
+            Measure.Custom(new SampleGroup("InventoryTypes", SampleUnit.Undefined), inventory.TypeCount);
+            yield break;
+        }
+
+        // 全图自动建立物流。每隔一行铺满道路, 测量一次完整的连接和之后的重复扫描
+
+        [UnityTest, Performance]
+        public IEnumerator LinkUtility_AutoLinkMap() {
+            yield return BenchmarkSession.EnterMap(BenchmarkSession.LargePlanetKey);
+            IMapDefinition map = MapView.Ins.TheOnlyActiveMap as IMapDefinition;
+            ConstructionBatch batch = new ConstructionBatch(map);
+            for (int j = 0; j < map.Height; j += 2) {
+                for (int i = 0; i < map.Width; i++) {
+                    batch.Add<RoadForSolid>(new Vector2Int(i, j));
+                }
+            }
+            Assert.Greater(batch.Commit(), 0);
+
+            SampleGroup first = new SampleGroup("AutoLinkMap.First", SampleUnit.Millisecond);
+            System.Diagnostics.Stopwatch stopwatch = System.Diagnostics.Stopwatch.StartNew();
+            LinkUtility.AutoLinkMap(map);
+            Measure.Custom(first, stopwatch.Elapsed.TotalMilliseconds);
+
+            Measure.Method(() => LinkUtility.AutoLinkMap(map))
+                .WarmupCount(warmupCount)
+                .MeasurementCount(measurementCount)
+                .GC()
+                .Run();
+            Measure.Custom(new SampleGroup("LinkNodes", SampleUnit.Undefined), map.LinkGraph.NodeCount);
+        }
+
+        // 镜头平移时的地图渲染, 每帧横向移动半格, 纵向移动四分之一格
+
+        [UnityTest, Performance]
+        public IEnumerator MapView_UpdateMap_CameraPan() => CameraPan(false);
+        [UnityTest, Performance]
+        public IEnumerator MapView_UpdateMap_CameraPan_Chunked() => CameraPan(true);
+
+        private static IEnumerator CameraPan(bool chunked) {
+            yield return BenchmarkSession.EnterMap(BenchmarkSession.LargePlanetKey);
+            const int frames = 240;
+            Vector2 start = MapView.Ins.CameraPosition;
+            bool useChunkedRenderer = MapView.Ins.UseChunkedRenderer;
+            MapView.Ins.UseChunkedRenderer = chunked;
+            yield return null;
+            SampleGroup setTile = new SampleGroup(nameof(PerformanceCounter.TilemapSetTile), SampleUnit.Undefined);
+            SampleGroup chunkRebuild = new SampleGroup(nameof(PerformanceCounter.ChunkRebuild), SampleUnit.Undefined);
+            SampleGroup spriteKeyRefresh = new SampleGroup(nameof(PerformanceCounter.SpriteKeyRefresh), SampleUnit.Undefined);
+            PerformanceCounters.SetRecording(true);
+            try {
+                using (Measure.ProfilerMarkers(new SampleGroup($"Weathering.{nameof(PerformanceSection.UpdateMap)}", SampleUnit.Millisecond))) {
+                    for (int f = 0; f < frames; f++) {
+                        MapView.Ins.CameraPosition = start + new Vector2(f * 0.5f, f * 0.25f);
+                        yield return null;
+                        PerformanceCounters.EndFrame(f, Time.realtimeSinceStartup, Time.unscaledDeltaTime);
+                        if (chunked) {
+                            Measure.Custom(chunkRebuild, PerformanceCounters.CounterValue(PerformanceCounter.ChunkRebuild));
+                        } else {
+                            Measure.Custom(setTile, PerformanceCounters.CounterValue(PerformanceCounter.TilemapSetTile));
+                        }
+                        Measure.Custom(spriteKeyRefresh, PerformanceCounters.CounterValue(PerformanceCounter.SpriteKeyRefresh));
+                    }
+                }
+            } finally {
+                PerformanceCounters.SetRecording(false);
+                MapView.Ins.CameraPosition = start;
+                MapView.Ins.UseChunkedRenderer = useChunkedRenderer;
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+﻿
+using UnityEditor;
+using UnityEditor.U2D;
+using UnityEngine;
+using UnityEngine.U2D;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 把Assets/Tiles下的贴图打进一个图集, ChunkedMapRenderer的每个子网格因此通常只有一张贴图
+    /// 项目设置里Sprite Packer为Always Enabled, 打包后编辑器和游戏里的sprite.texture都是图集
+    /// </summary>
+    public static class TileAtlasBuilder
+    {
+        public const string AtlasPath = "Assets/Tiles/TileAtlas.spriteatlas";
+        public const string TilesFolder = "Assets/Tiles";
+
+        [MenuItem("Weathering/打包地块图集")]
+        public static void Build() {
+            SpriteAtlas atlas = AssetDatabase.LoadAssetAtPath<SpriteAtlas>(AtlasPath);
+            if (atlas == null) {
+                atlas = new SpriteAtlas();
+                AssetDatabase.CreateAsset(atlas, AtlasPath);
+            }
+
+            // 像素画: 不旋转, 不紧密打包, 留出间隔防止采样到相邻贴图
+            atlas.SetPackingSettings(new SpriteAtlasPackingSettings {
+                enableRotation = false,
+                enableTightPacking = false,
+                padding = 2,
+            });
+            atlas.SetTextureSettings(new SpriteAtlasTextureSettings {
+                readable = false,
+                generateMipMaps = false,
+                sRGB = true,
+                filterMode = FilterMode.Point,
+            });
+            atlas.SetPlatformSettings(new TextureImporterPlatformSettings {
+                name = "DefaultTexturePlatform",
+                maxTextureSize = 4096,
+                format = TextureImporterFormat.Automatic,
+                textureCompression = TextureImporterCompression.Uncompressed,
+            });
+            atlas.SetIncludeInBuild(true);
+
+            atlas.Remove(atlas.GetPackables());
+            atlas.Add(new Object[] { AssetDatabase.LoadAssetAtPath<DefaultAsset>(TilesFolder) });
+            EditorUtility.SetDirty(atlas);
+            AssetDatabase.SaveAssets();
+
+            SpriteAtlasUtility.PackAtlases(new SpriteAtlas[] { atlas }, EditorUserBuildSettings.activeBuildTarget);
+            Debug.Log($"地块图集已打包: {AtlasPath}, 共{atlas.spriteCount}张贴图");
+        }
+    }
+}
@@ -0,0 +1,66 @@
+﻿
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+using UnityEditor;
+using UnityEngine;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 生成TypeRegistry.Factories.cs, 每个地块类型一个 () => new T() 的构造委托, 运行时不用反射创建地块
+    /// 新增或删除地块类型后重新生成。打包前ConceptTableBuilder检查, 过期时打包失败
+    /// </summary>
+    public static class TileFactoryGenerator
+    {
+        public const string OutputPath = "Assets/Scripts/Core/TypeRegistry.Factories.cs";
+
+        [MenuItem("Weathering/生成地块构造表")]
+        public static void Generate() {
+            File.WriteAllText(OutputPath, Source(), new UTF8Encoding(true));
+            AssetDatabase.Refresh();
+            Debug.Log($"地块构造表已生成: {OutputPath}, 共{TypeRegistry.TileCount}种地块");
+        }
+
+        public static bool IsCurrent() {
+            return File.Exists(OutputPath) && File.ReadAllText(OutputPath) == Source();
+        }
+
+        public static string Source() {
+            List<string> lines = new List<string>();
+            for (int id = 1; id <= TypeRegistry.TileCount; id++) {
+                Type type = TypeRegistry.TileType(id);
+                if (!IsAccessible(type)) throw new Exception($"地块类型不能是私有的嵌套类型 {type.FullName}");
+                string name = "global::" + type.FullName.Replace('+', '.');
+                lines.Add($"            {{ typeof({name}), () => new {name}() }},");
+            }
+
+            StringBuilder sb = new StringBuilder();
+            sb.Append("\r\n");
+            sb.Append("// 由TileFactoryGenerator生成, 不要手动修改。菜单: Weathering/生成地块构造表\r\n");
+            sb.Append("using System;\r\n");
+            sb.Append("using System.Collections.Generic;\r\n");
+            sb.Append("\r\n");
+            sb.Append("namespace Weathering\r\n");
+            sb.Append("{\r\n");
+            sb.Append("    public static partial class TypeRegistry\r\n");
+            sb.Append("    {\r\n");
+            sb.Append("        private static readonly Dictionary<Type, Func<ITileDefinition>> generatedTileFactories = new Dictionary<Type, Func<ITileDefinition>> {\r\n");
+            foreach (var line in lines) {
+                sb.Append(line).Append("\r\n");
+            }
+            sb.Append("        };\r\n");
+            sb.Append("    }\r\n");
+            sb.Append("}\r\n");
+            return sb.ToString();
+        }
+
+        private static bool IsAccessible(Type type) {
+            for (Type t = type; t.IsNested; t = t.DeclaringType) {
+                if (!t.IsNestedPublic && !t.IsNestedAssembly && !t.IsNestedFamORAssem) return false;
+            }
+            return true;
+        }
+    }
+}
@@ -48,6 +48,7 @@ namespace Weathering
 
         public override string SpriteKey { get => typeof(AbstractFactoryStatic).Name; }
         public override string SpriteKeyHighLight { get => Running ? GlobalLight.Decorated(SpriteKey) : null; }
+        public override int SpriteIdHighLight => Running ? GlobalLight.Decorated(SpriteId) : Res.NoSprite;
 
 
         private IRef in_0Ref; // 输入
@@ -546,7 +547,7 @@ namespace Weathering
             UI.Ins.ShowItems($"{Localization.Ins.Get(GetType())}建筑控制", items);
         }
         private void BuildingProductionStatisticsPage() {
-            var items = UI.Ins.GetItems();
+            var items = UI.Ins.GetReusableItems();
 
             items.Add(UIItem.CreateReturnButton(OnTap));
 
@@ -577,6 +578,22 @@ namespace Weathering
                 items.Add(UIItem.CreateButton($"物流输出产量 {Localization.Ins.Val(res, Map.Refs.GetOrCreate(Out3.Item1).Value)}", () => UIPreset.OnTapItem(BuildingProductionStatisticsPage, res)));
             }
 
+            // 物流图: 当前输入, 以及上游缺少什么
+            if (HasIn_0 || HasIn_1 || HasIn_2 || HasIn_3) {
+                items.Add(UIItem.CreateSeparator());
+                LinkGraph graph = (Map as IMapDefinition).LinkGraph;
+                foreach (var edge in graph.InputsOf(Pos)) {
+                    if (edge != null) items.Add(UIItem.CreateText($"物流输入 {Localization.Ins.Val(edge.Type, edge.Quantity)}"));
+                }
+                List<LinkGraph.Shortage> shortages = graph.FindShortages(Pos);
+                if (shortages.Count == 0) {
+                    items.Add(UIItem.CreateText("上游物流需求均已满足"));
+                }
+                foreach (var shortage in shortages) {
+                    items.Add(UIItem.CreateText($"{Localization.Ins.Get(Map.Get(shortage.Pos).GetType())}({shortage.Pos.x},{shortage.Pos.y}) 缺少{Localization.Ins.Val(shortage.Type, shortage.Quantity)}"));
+                }
+            }
+
             UI.Ins.ShowItems($"{Localization.Ins.Get(GetType())}产量", items);
         }
 
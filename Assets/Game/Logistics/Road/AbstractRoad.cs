@@ -41,13 +41,11 @@ namespace Weathering
             }
         }
 
-        public override string SpriteKeyRoad {
-            get {
-                int index = TileUtility.Calculate4x4RuleTileIndex(this, (tile, direction) => Refs.Has(direction) || ((RoadRef.Type == null) && (tile is AbstractRoad) && (tile as AbstractRoad).RoadRef.Type == null)
+        public override string SpriteKeyRoad => $"{(SpriteKeyRoadBase == null ? "Road" : SpriteKeyRoadBase)}_{SpriteRoadIndex}";
+        // 不拼接字符串, 直接查id表
+        public override int SpriteIdRoad => Res.SpriteIds(SpriteKeyRoadBase == null ? "Road" : SpriteKeyRoadBase, 16)[SpriteRoadIndex];
+        protected virtual int SpriteRoadIndex => TileUtility.Calculate4x4RuleTileIndex(this, (tile, direction) => Refs.Has(direction) || ((RoadRef.Type == null) && (tile is AbstractRoad) && (tile as AbstractRoad).RoadRef.Type == null)
                 );
-                return $"{(SpriteKeyRoadBase == null ? "Road" : SpriteKeyRoadBase)}_{index}";
-            }
-        }
         protected virtual string SpriteKeyRoadBase { get; } = null;
 
         public IRef RoadRef { get; private set; }
@@ -11,15 +11,10 @@ namespace Weathering
     public class RoadAsBridge : AbstractRoad
     {
 
-        public override string SpriteKeyRoad {
-            get {
-                int index = TileUtility.Calculate4x4RuleTileIndex(this, (tile, direction) => Refs.Has(direction)
+        protected override int SpriteRoadIndex => TileUtility.Calculate4x4RuleTileIndex(this, (tile, direction) => Refs.Has(direction)
                 || (tile is IPassable passable && passable.Passable)
                 || ((RoadRef.Type == null) && (tile is AbstractRoad) && (tile as AbstractRoad).RoadRef.Type == null)
                 );
-                return $"Bridge_{index}";
-            }
-        }
 
         protected override bool PreserveLandscape => true;
 
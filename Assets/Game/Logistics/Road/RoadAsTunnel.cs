@@ -12,14 +12,10 @@ namespace Weathering
     {
         protected override bool PreserveLandscape => true;
 
-        public override string SpriteKeyRoad {
-            get {
-                int index = TileUtility.Calculate4x4RuleTileIndex(this, (tile, direction) => Refs.Has(direction) 
+        protected override int SpriteRoadIndex => TileUtility.Calculate4x4RuleTileIndex(this, (tile, direction) => Refs.Has(direction) 
                 || (tile is IPassable passable && passable.Passable) || ((RoadRef.Type == null) && (tile is AbstractRoad) && (tile as AbstractRoad).RoadRef.Type == null)
                 );
-                return $"RoadAsTunnel_{index}";
-            }
-        }
+        protected override string SpriteKeyRoadBase => "RoadAsTunnel";
         public override long LinkQuantityRestriction => RoadForSolid.CAPACITY;
 
         public override Type LinkTypeRestriction => typeof(DiscardableSolid);
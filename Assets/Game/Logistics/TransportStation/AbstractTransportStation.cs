@@ -20,6 +20,7 @@ namespace Weathering
 
         public override string SpriteKeyRoad => GetType().Name;
         public override string SpriteKeyHighLight => GlobalLight.Decorated(SpriteKeyRoad);
+        public override int SpriteIdHighLight => GlobalLight.Decorated(SpriteIdRoad);
 
         public override string SpriteKey => RefOfDelivery.Value > 0 ? RefOfDelivery.Type.Name : null;
 
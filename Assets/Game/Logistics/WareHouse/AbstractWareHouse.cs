@@ -32,7 +32,20 @@ namespace Weathering
         }
 
         public override string SpriteKey { get => GetType().Name; }
-        public override string SpriteKeyHighLight { get => ValueOfResource.Inc != 0 ? GlobalLight.Decorated(SpriteKey) : null; }
+        // 有输入且未满时高亮, 满的时刻由ValueScheduler通知
+        private bool Filling => ValueOfResource.Inc != 0 && !ValueOfResource.Maxed;
+        public override string SpriteKeyHighLight { get => Filling ? GlobalLight.Decorated(SpriteKey) : null; }
+        public override int SpriteIdHighLight => Filling ? GlobalLight.Decorated(SpriteId) : Res.NoSprite;
+
+        private ValueScheduler.Subscription whenFull;
+        private void WatchFull() {
+            whenFull?.Cancel();
+            whenFull = Filling ? ValueScheduler.WhenMaxed(ValueOfResource, Map, OnFull) : null;
+        }
+        private void OnFull() {
+            whenFull = null;
+            NeedUpdateSpriteKeys = true;
+        }
 
         public override string SpriteLeft => GetSprite(Vector2Int.left, typeof(ILeft));
         public override string SpriteRight => GetSprite(Vector2Int.right, typeof(IRight));
@@ -52,6 +65,7 @@ namespace Weathering
                 RefOfSupply.Type = null;
                 TypeOfResource.Type = null;
             }
+            WatchFull();
             NeedUpdateSpriteKeys = true;
         }
 
@@ -99,6 +113,7 @@ namespace Weathering
             RefOfSupply = Refs.Get<AbstractWareHouse>();
             ValueOfResource = Values.Get<WareHouseResource>();
             TypeOfResource = Refs.Get<WareHouseResource>();
+            WatchFull();
         }
 
         public override void OnTap() {
@@ -141,6 +156,7 @@ namespace Weathering
             return true;
         }//; ValueOfResource.Val == 0 && !LinkUtility.HasAnyLink(this);
         public override void OnDestruct(ITile tile) {
+            whenFull?.Cancel();
             if (TypeOfResource.Type != null) {
                 if (!Map.Inventory.CanAdd((TypeOfResource.Type, ValueOfResource.Val))) {
                     throw new Exception();
@@ -162,6 +178,7 @@ namespace Weathering
                 RefOfSupply.Type = null;
                 TypeOfResource.Type = null;
             }
+            WatchFull();
             NeedUpdateSpriteKeys = true;
 
             // OnTap();
@@ -53,6 +53,18 @@ namespace Weathering
 
 
         public override string SpriteKey => $"{typeof(Wardenclyffe).Name}{MapView.Ins.AnimationIndex % 6}";
+        private static int[] spriteIds = null;
+        public override int SpriteId {
+            get {
+                if (spriteIds == null) {
+                    spriteIds = new int[6];
+                    for (int i = 0; i < 6; i++) {
+                        spriteIds[i] = Res.SpriteId($"{typeof(Wardenclyffe).Name}{i}");
+                    }
+                }
+                return spriteIds[MapView.Ins.AnimationIndex % 6];
+            }
+        }
 
         public int HasFrameAnimation => 1;
     }
@@ -17,7 +17,7 @@ namespace Weathering
     //public class ClearColorB { }
 
 
-    public abstract class StandardMap : IMapDefinition
+    public abstract class StandardMap : IMapDefinition, ISaveDirty
     {
 
         public virtual bool ControlCharacter => false;
@@ -41,6 +41,12 @@ namespace Weathering
         public virtual string GetSpriteKeyWater(Vector2Int pos) => null;
         public virtual string GetSpriteKeyTree(Vector2Int pos) => null;
         public virtual string GetSpriteKeyHill(Vector2Int pos) => null;
+        // 兼容只重写了字符串版本的地图
+        public virtual int GetSpriteIdBedrock(Vector2Int pos) => Res.SpriteId(GetSpriteKeyBedrock(pos));
+        public virtual int GetSpriteIdGrass(Vector2Int pos) => Res.SpriteId(GetSpriteKeyGrass(pos));
+        public virtual int GetSpriteIdWater(Vector2Int pos) => Res.SpriteId(GetSpriteKeyWater(pos));
+        public virtual int GetSpriteIdTree(Vector2Int pos) => Res.SpriteId(GetSpriteKeyTree(pos));
+        public virtual int GetSpriteIdHill(Vector2Int pos) => Res.SpriteId(GetSpriteKeyHill(pos));
 
 
 
@@ -108,7 +114,7 @@ namespace Weathering
                 altitudeConfig = GetAltitudeConfig;
                 moistureConfig = GetMoistureConfig;
                 temporatureConfig = GetTemporatureConfig;
-                GenerateNoise();
+                LoadOrGenerateNoise();
 
                 Vector2 cameraPos = Vector2.zero;
                 cameraPos.x = Values.Get<CameraX>().Max / factor;
@@ -133,19 +139,55 @@ namespace Weathering
             }
         }
 
-        public IValues Values { get; protected set; }
+        private IValues values;
+        private IRefs refs;
+        private IInventory inventory;
+        private IInventory inventoryOfSupply;
+        public IValues Values { get => values; protected set { values = value; SaveDirty.Attach(value, this); } }
         public void SetValues(IValues values) => Values = values;
-        public IRefs Refs { get; set; }
+        public IRefs Refs { get => refs; set { refs = value; SaveDirty.Attach(value, this); } }
 
         public void SetRefs(IRefs refs) => Refs = refs;
-        public IInventory Inventory { get; protected set; }
+        public IInventory Inventory { get => inventory; protected set { inventory = value; SaveDirty.Attach(value, this); } }
         public void SetInventory(IInventory inventory) => Inventory = inventory;
 
-        public IInventory InventoryOfSupply { get; protected set; }
+        public IInventory InventoryOfSupply { get => inventoryOfSupply; protected set { inventoryOfSupply = value; SaveDirty.Attach(value, this); } }
         public void SetInventoryOfSupply(IInventory inventory) => InventoryOfSupply = inventory;
 
         // ------------------------------------------------------------
 
+        // 增量存档。地图自身数据修改时标记HeadSaveDirty, 地块修改时标记所在区块
+        public bool HeadSaveDirty { get; private set; } = true;
+        public bool BodySaveDirty => SaveDirtyChunkCount > 0;
+        public int SaveDirtyChunkCount { get; private set; } = 0;
+        private bool[] saveDirtyChunks;
+        private int saveDirtyChunkCountX;
+
+        public void MarkSaveDirty() => HeadSaveDirty = true;
+        public void MarkSaveDirty(Vector2Int pos) {
+            if (saveDirtyChunks == null) {
+                saveDirtyChunkCountX = MapBodyFormat.ChunkCountX(Width);
+                saveDirtyChunks = new bool[MapBodyFormat.ChunkCount(this)];
+            }
+            int k = pos.x / MapBodyFormat.ChunkSize + pos.y / MapBodyFormat.ChunkSize * saveDirtyChunkCountX;
+            if (!saveDirtyChunks[k]) {
+                saveDirtyChunks[k] = true;
+                SaveDirtyChunkCount++;
+            }
+        }
+        public bool IsChunkSaveDirty(int chunkX, int chunkY) {
+            return saveDirtyChunks != null && saveDirtyChunks[chunkX + chunkY * saveDirtyChunkCountX];
+        }
+        public void ClearHeadSaveDirty() => HeadSaveDirty = false;
+        public void ClearBodySaveDirty() {
+            if (saveDirtyChunks != null) {
+                Array.Clear(saveDirtyChunks, 0, saveDirtyChunks.Length);
+            }
+            SaveDirtyChunkCount = 0;
+        }
+
+        // ------------------------------------------------------------
+
 
         public bool CanUpdateAt<T>(Vector2Int pos) => CanUpdateAt(typeof(T), pos.x, pos.y);
         public bool CanUpdateAt(Type type, Vector2Int pos) => CanUpdateAt(type, pos.x, pos.y);
@@ -153,11 +195,12 @@ namespace Weathering
         public abstract bool CanUpdateAt(Type type, int i, int j);
 
 
+        // 稀疏存储时, 为null的格子是没有修改过的默认地块, 第一次访问时才创建
         protected ITileDefinition[,] Tiles;
 
         public ITile Get(int i, int j) {
             Validate(ref i, ref j);
-            ITile result = Tiles[i, j];
+            ITile result = Tiles[i, j] ?? MaterializeDefaultTile(i, j);
             return result;
         }
 
@@ -234,7 +277,11 @@ namespace Weathering
 
             // 通过建造验证
 
-            ITileDefinition tile = (Activator.CreateInstance(type) as ITileDefinition);
+            return ReplaceTile(type, i, j, oldTileDefinition, true);
+        }
+
+        private ITileDefinition ReplaceTile(Type type, int i, int j, ITileDefinition oldTileDefinition, bool updateNeighbors) {
+            ITileDefinition tile = TypeRegistry.CreateTile(type);
             if (tile == null) throw new Exception();
 
             Vector2Int pos = new Vector2Int(i, j);
@@ -245,14 +292,120 @@ namespace Weathering
             // Tiles[i, j] = tile;
             SetTile(pos, tile, true);
 
-            LinkUtility.NeedUpdateNeighbors8(tile);
+            if (updateNeighbors) LinkUtility.NeedUpdateNeighbors8(tile);
 
+            ITile oldTile = oldTileDefinition;
             oldTileDefinition.OnDestruct(tile); // new tile
             tile.OnConstruct(oldTile); // old tile
+            ComponentStore?.Release(oldTile);
 
             tile.OnEnable();
+            linkGraph?.OnTileChanged(tile);
+            OnTileReplaced(tile);
             return tile;
         }
+        /// <summary>
+        /// 建造或拆除后, 新地块OnEnable之后调用
+        /// </summary>
+        protected virtual void OnTileReplaced(ITile tile) { }
+
+        public int UpdateAt(ConstructionBatch batch) {
+            if (batch.Map != this) throw new Exception();
+
+            // 能建造的位置。在提交前按当前地图判断, 不考虑同一批次里先建造的地块
+            List<ValueTuple<Type, ITileDefinition>> accepted = new List<ValueTuple<Type, ITileDefinition>>();
+            foreach (var placement in batch.Placements) {
+                Type type = placement.Item1;
+                Vector2Int pos = Validate(placement.Item2);
+                ITileDefinition oldTile = Get(pos) as ITileDefinition;
+                if (oldTile == null) throw new Exception();
+                if (oldTile.GetType() == type) continue;
+                if (type == DefaultTileType && !oldTile.CanDestruct()) continue;
+                if (!CanUpdateAt(type, pos)) continue;
+                accepted.Add((type, oldTile));
+            }
+            if (accepted.Count == 0) return 0;
+
+            Dictionary<Type, long> costs = new Dictionary<Type, long>();
+            Dictionary<Type, long> refunds = new Dictionary<Type, long>();
+            if (!GameConfig.CheatMode) {
+                // 逐个累计同类建筑数量的变化, 费用与逐个建造一致
+                Dictionary<Type, long> countOffsets = new Dictionary<Type, long>();
+                foreach (var pair in accepted) {
+                    Type type = pair.Item1;
+                    Type oldType = pair.Item2.GetType();
+                    countOffsets.TryGetValue(oldType, out long oldOffset);
+                    CostInfo desctructOldCost = ConstructionCostBaseAttribute.GetCost(oldType, this, false, oldOffset);
+                    countOffsets[oldType] = oldOffset - 1;
+                    countOffsets.TryGetValue(type, out long newOffset);
+                    CostInfo constructNewCost = ConstructionCostBaseAttribute.GetCost(type, this, true, newOffset);
+                    countOffsets[type] = newOffset + 1;
+
+                    if (desctructOldCost.CostType != null && constructNewCost.CostType != null) throw new Exception(); // 与单个建造一致
+                    if (desctructOldCost.CostType != null) {
+                        refunds.TryGetValue(desctructOldCost.CostType, out long refund);
+                        refunds[desctructOldCost.CostType] = refund + desctructOldCost.RealCostQuantity;
+                    }
+                    if (constructNewCost.CostType != null) {
+                        costs.TryGetValue(constructNewCost.CostType, out long cost);
+                        costs[constructNewCost.CostType] = cost + constructNewCost.RealCostQuantity;
+                    }
+                }
+
+                // 先整体检查返还空间与建造费用, 全部满足后再改动背包
+                Dictionary<Type, InventoryItemData> refundItems = new Dictionary<Type, InventoryItemData>();
+                foreach (var pair in refunds) {
+                    refundItems.Add(pair.Key, new InventoryItemData { value = pair.Value });
+                }
+                if (!Inventory.CanAddEverything(refundItems)) {
+                    List<string> refundTexts = new List<string>();
+                    foreach (var pair in refunds) {
+                        refundTexts.Add(Localization.Ins.Val(pair.Key, pair.Value));
+                    }
+                    UI.Ins.ShowItems("背包空间不足", UIItem.CreateMultilineText($"{string.Join(" ", refundTexts)} 被拆建筑资源无法返还"));
+                    return 0;
+                }
+                // 不同费用的标签可能重叠, 累计预计算避免同一资源被重复计入
+                Dictionary<Type, InventoryItemData> canRemove = new Dictionary<Type, InventoryItemData>();
+                foreach (var pair in costs) {
+                    if (Inventory.CanRemoveWithTag(pair.Key, canRemove, pair.Value) < pair.Value) {
+                        GameMenu.Ins.PushNotification($"建造{accepted.Count}个地块, 建筑资源{Localization.Ins.Val(pair.Key, pair.Value)}不足");
+                        return 0;
+                    }
+                }
+                foreach (var pair in canRemove) {
+                    Inventory.Remove(pair.Key, pair.Value.value);
+                }
+                foreach (var pair in refunds) {
+                    Inventory.Add(pair.Key, pair.Value);
+                }
+            }
+
+            HashSet<Vector2Int> neighbors = new HashSet<Vector2Int>();
+            foreach (var pair in accepted) {
+                Vector2Int pos = pair.Item2.GetPos();
+                ReplaceTile(pair.Item1, pos.x, pos.y, pair.Item2, false);
+                for (int di = -1; di <= 1; di++) {
+                    for (int dj = -1; dj <= 1; dj++) {
+                        neighbors.Add(Validate(new Vector2Int(pos.x + di, pos.y + dj)));
+                    }
+                }
+            }
+            // 与LinkUtility.NeedUpdateNeighbors8相同, 每个格子只标记一次
+            foreach (var pos in neighbors) {
+                Get(pos).NeedUpdateSpriteKeys = true;
+            }
+
+            string summary = $"建造{accepted.Count}个地块";
+            foreach (var pair in costs) {
+                summary += $", 花费{Localization.Ins.Val(pair.Key, pair.Value)}";
+            }
+            foreach (var pair in refunds) {
+                summary += $", 返还{Localization.Ins.Val(pair.Key, pair.Value)}";
+            }
+            GameMenu.Ins.PushNotification(summary);
+            return accepted.Count;
+        }
 
         public Vector2Int Validate(Vector2Int pos) {
             pos.x %= Width;
@@ -268,7 +421,68 @@ namespace Weathering
             if (j < 0) j += Height;
         }
 
-        // modify
+        /// <summary>
+        /// 默认地块在第一次OnConstruct之后不需要存档时, 可以稀疏存储。没有修改过的默认地块不占内存
+        /// </summary>
+        public virtual bool SparseDefaultTiles => typeof(IDontSave).IsAssignableFrom(DefaultTileType);
+
+        public bool IsTileMaterialized(int i, int j) => Tiles != null && Tiles[i, j] != null;
+
+        /// <summary>
+        /// 地块的Values和Refs存到地图级的ComponentStore, 避免每个地块一个字典和许多小对象
+        /// </summary>
+        protected virtual bool UseComponentStore => false;
+        private ComponentStore componentStore = null;
+        public ComponentStore ComponentStore {
+            get {
+                if (componentStore == null && UseComponentStore) {
+                    componentStore = new ComponentStore();
+                }
+                return componentStore;
+            }
+        }
+
+        /// <summary>
+        /// 物流图, 第一次使用时扫描全图
+        /// </summary>
+        private LinkGraph linkGraph = null;
+        public LinkGraph LinkGraph {
+            get {
+                if (linkGraph == null) {
+                    linkGraph = new LinkGraph(this);
+                }
+                return linkGraph;
+            }
+        }
+
+        public void ConstructSparseDefaultTiles() {
+            if (!SparseDefaultTiles) throw new Exception();
+            if (Tiles == null) {
+                Tiles = new ITileDefinition[Width, Height];
+            }
+            // 与逐个SetTile(pos, tile, true)的建筑计数一致
+            Refs.GetOrCreate(DefaultTileType).Value += Width * Height;
+        }
+
+        private Func<ITileDefinition> defaultTileFactory;
+        private ITileDefinition MaterializeDefaultTile(int i, int j) {
+            if (!SparseDefaultTiles) throw new Exception($"地块不存在 {i},{j}");
+            if (defaultTileFactory == null) {
+                defaultTileFactory = TypeRegistry.TileFactory(DefaultTileType);
+            }
+            // 与ConstructMapBody创建的默认地块一致, 但不算修改, 不标记存档
+            ITileDefinition tile = defaultTileFactory();
+            tile.Map = this;
+            tile.Pos = new Vector2Int(i, j);
+            tile.TileHashCode = HashUtility.Hash(i, j, Width, Height, (int)HashCode);
+            Tiles[i, j] = tile;
+            tile.OnConstruct(null);
+            tile.NeedUpdateSpriteKeys = true;
+            tile.OnEnable();
+            return tile;
+        }
+
+        // modify. 稀疏存储时tile可以为null, 表示没有修改过的默认地块
         public void SetTile(Vector2Int pos, ITileDefinition tile, bool inConstruction = false) {
             if (Tiles == null) {
                 Tiles = new ITileDefinition[Width, Height];
@@ -277,16 +491,18 @@ namespace Weathering
             // 建筑计数
             if (inConstruction) {
                 ITile oldTile = Tiles[pos.x, pos.y];
-                if (oldTile != null) {
-                    Refs.Get(oldTile.GetType()).Value--;
+                Type oldType = oldTile != null ? oldTile.GetType() : (SparseDefaultTiles ? DefaultTileType : null);
+                if (oldType != null) {
+                    Refs.Get(oldType).Value--;
                     // Debug.LogWarning($"{oldTile.GetType().Name}--");
                 }
-                Refs.GetOrCreate(tile.GetType()).Value++;
+                Refs.GetOrCreate(tile == null ? DefaultTileType : tile.GetType()).Value++;
                 // Debug.LogWarning($"{tile.GetType().Name}++");
             }
 
 
             Tiles[pos.x, pos.y] = tile;
+            MarkSaveDirty(pos);
         }
 
         // public virtual void AfterGeneration() { }
@@ -354,23 +570,73 @@ namespace Weathering
         private TemporatureConfig temporatureConfig;
 
 
-        public int[,] Altitudes { get; private set; }
-        public Type[,] AltitudeTypes { get; private set; }
-        public int[,] Moistures { get; private set; }
-        public Type[,] MoistureTypes { get; private set; }
-        public int[,] Temporatures { get; private set; }
-        public Type[,] TemporatureTypes { get; private set; }
+        /// <summary>
+        /// 地形噪声, 扁平数组, 下标为 i + j * Width, 见FieldIndex
+        /// </summary>
+        public int[] Altitudes { get; private set; }
+        public AltitudeTypeId[] AltitudeTypes { get; private set; }
+        public int[] Moistures { get; private set; }
+        public MoistureTypeId[] MoistureTypes { get; private set; }
+        public int[] Temporatures { get; private set; }
+        public TemporatureTypeId[] TemporatureTypes { get; private set; }
         public Type[,] ResourceTypes { get; private set; }
+        public int FieldIndex(int i, int j) => i + j * Width;
 
 
         protected virtual int RandomSeed { get; } = 0;
         private int autoInc = 0;
         private int AutoInc { get => autoInc++; }
+        /// <summary>
+        /// 生成参数相同则噪声相同, 签名包含所有参数
+        /// 缓动函数无法比较, 由地图类型决定
+        /// </summary>
+        private string NoiseSignature {
+            get {
+                var inv = System.Globalization.CultureInfo.InvariantCulture;
+                AltitudeConfig a = altitudeConfig;
+                MoistureConfig m = moistureConfig;
+                TemporatureConfig t = temporatureConfig;
+                return $"{TerrainFieldCache.GeneratorVersion}|{GetType().FullName}|{HashCode}|{RandomSeed}|{Width}x{Height}"
+                    + $"|{a.CanGenerate},{a.BaseNoiseSize},{a.Min},{a.Max},{a.EaseFunction != null}"
+                    + $"|{m.CanGenerate},{m.BaseNoiseSize},{m.Min},{m.Max}"
+                    + $"|{t.CanGenearate},{t.BaseNoiseSize},{t.Min},{t.Max},{t.AltitudeInfluence.ToString("R", inv)}";
+            }
+        }
+        private void LoadOrGenerateNoise() {
+            if (!altitudeConfig.CanGenerate && !moistureConfig.CanGenerate && !temporatureConfig.CanGenearate) {
+                GenerateNoise();
+                return;
+            }
+            string signature = NoiseSignature;
+            if (TerrainFieldCache.TryGet(MapKey, signature, out TerrainFields fields)) {
+                Altitudes = fields.Altitudes;
+                AltitudeTypes = fields.AltitudeTypes;
+                Moistures = fields.Moistures;
+                MoistureTypes = fields.MoistureTypes;
+                Temporatures = fields.Temporatures;
+                TemporatureTypes = fields.TemporatureTypes;
+                return;
+            }
+            GenerateNoise();
+            TerrainFieldCache.Put(MapKey, new TerrainFields {
+                Signature = signature,
+                Width = Width,
+                Height = Height,
+                Altitudes = Altitudes,
+                AltitudeTypes = AltitudeTypes,
+                Moistures = Moistures,
+                MoistureTypes = MoistureTypes,
+                Temporatures = Temporatures,
+                TemporatureTypes = TemporatureTypes,
+            });
+        }
         private void GenerateNoise() {
-            GenerateAltitude();
-            GenerateMoisture();
-            GenerateTemporature();
-            GenerateResources();
+            using (PerformanceCounters.Measure(PerformanceSection.GenerateNoise)) {
+                GenerateAltitude();
+                GenerateMoisture();
+                GenerateTemporature();
+                GenerateResources();
+            }
         }
         private void GenerateResources() {
             if (altitudeConfig.CanGenerate && moistureConfig.CanGenerate) {
@@ -378,37 +644,63 @@ namespace Weathering
             }
         }
 
+        /// <summary>
+        /// 每格的结果只依赖坐标, 按行并行计算, 结果与逐格计算完全相同
+        /// 调试输出贴图时只能在主线程
+        /// </summary>
+        private void ForEachRow(bool mainThreadOnly, Action<int> row) {
+            if (mainThreadOnly) {
+                for (int j = 0; j < Height; j++) {
+                    row(j);
+                }
+            } else {
+                System.Threading.Tasks.Parallel.For(0, Height, row);
+            }
+        }
+
         private void GenerateAltitude() {
             bool debugAltitude = false;
             Texture2D texAltitude = null;
             if (debugAltitude) texAltitude = new Texture2D(Width, Height);
             if (altitudeConfig.CanGenerate) {
 
+                int width = Width;
+                int height = Height;
                 int noise0Size = altitudeConfig.BaseNoiseSize;
                 int noise1Size = noise0Size * 2;
                 int noise2Size = noise1Size * 2;
-                Altitudes = new int[Width, Height];
-                AltitudeTypes = new Type[Width, Height];
+                int[] altitudes = new int[width * height];
+                AltitudeTypeId[] altitudeTypes = new AltitudeTypeId[width * height];
                 int offset0 = AutoInc;
                 int offset1 = AutoInc;
                 int offset2 = AutoInc;
-                for (int i = 0; i < Width; i++) {
-                    for (int j = 0; j < Height; j++) {
+                int hashCode = (int)HashCode;
+                AltitudeConfig config = altitudeConfig;
+                ForEachRow(debugAltitude, j => {
+                    float[] noise0Row = new float[width];
+                    float[] noise1Row = new float[width];
+                    float[] noise2Row = new float[width];
+                    HashUtility.PerlinNoiseRow(noise0Size, j, width, height, offset0 + hashCode, noise0Row);
+                    HashUtility.PerlinNoiseRow(noise1Size, j, width, height, offset1 + hashCode, noise1Row);
+                    HashUtility.PerlinNoiseRow(noise2Size, j, width, height, offset2 + hashCode, noise2Row);
+                    for (int i = 0; i < width; i++) {
                         //float noise0 = HashUtility.PerlinNoise((float)noise0Size * i / Width, (float)noise0Size * j / Height, noise0Size, noise0Size, offset0 + HashCode);
                         //float floatResult = (noise0+1)/2;
-                        float noise0 = HashUtility.PerlinNoise((float)noise0Size * i / Width, (float)noise0Size * j / Height, noise0Size, noise0Size, offset0 + (int)HashCode);
-                        float noise1 = HashUtility.PerlinNoise((float)noise1Size * i / Width, (float)noise1Size * j / Height, noise1Size, noise1Size, offset1 + (int)HashCode);
-                        float noise2 = HashUtility.PerlinNoise((float)noise2Size * i / Width, (float)noise2Size * j / Height, noise2Size, noise2Size, offset2 + (int)HashCode);
+                        float noise0 = noise0Row[i];
+                        float noise1 = noise1Row[i];
+                        float noise2 = noise2Row[i];
                         float floatResult = (noise0 * 4 + noise1 * 2 + noise2 * 1 + 7) / 14;
-                        if (altitudeConfig.EaseFunction != null) floatResult = altitudeConfig.EaseFunction(floatResult);
+                        if (config.EaseFunction != null) floatResult = config.EaseFunction(floatResult);
 
-                        int altitude = (int)Mathf.Lerp(altitudeConfig.Min, altitudeConfig.Max, floatResult);
-                        Altitudes[i, j] = altitude;
-                        AltitudeTypes[i, j] = GeographyUtility.GetAltitudeType(altitude);
+                        int altitude = (int)Mathf.Lerp(config.Min, config.Max, floatResult);
+                        altitudes[i + j * width] = altitude;
+                        altitudeTypes[i + j * width] = GeographyUtility.GetAltitudeTypeId(altitude);
 
                         if (debugAltitude) texAltitude.SetPixel(i, j, Color.Lerp(Color.black, Color.white, floatResult));
                     }
-                }
+                });
+                Altitudes = altitudes;
+                AltitudeTypes = altitudeTypes;
             }
             if (debugAltitude) System.IO.File.WriteAllBytes(Application.streamingAssetsPath + "/altitude.png", texAltitude.EncodeToPNG());
         }
@@ -417,22 +709,30 @@ namespace Weathering
             Texture2D texMoisture = null;
             if (debugMoisture) texMoisture = new Texture2D(Width, Height);
             if (moistureConfig.CanGenerate) {
+                int width = Width;
+                int height = Height;
                 int size = moistureConfig.BaseNoiseSize;
-                Moistures = new int[Width, Height];
-                MoistureTypes = new Type[Width, Height];
+                int[] moistures = new int[width * height];
+                MoistureTypeId[] moistureTypes = new MoistureTypeId[width * height];
                 int offset = AutoInc;
-                for (int i = 0; i < Width; i++) {
-                    for (int j = 0; j < Height; j++) {
-                        float noise = HashUtility.PerlinNoise((float)size * i / Width, (float)size * j / Height, size, size, offset + (int)HashCode);
+                int hashCode = (int)HashCode;
+                MoistureConfig config = moistureConfig;
+                ForEachRow(debugMoisture, j => {
+                    float[] noiseRow = new float[width];
+                    HashUtility.PerlinNoiseRow(size, j, width, height, offset + hashCode, noiseRow);
+                    for (int i = 0; i < width; i++) {
+                        float noise = noiseRow[i];
                         float floatResult = (noise + 1) / 2;
 
-                        int moisture = (int)Mathf.Lerp(moistureConfig.Min, moistureConfig.Max, floatResult); ;
-                        Moistures[i, j] = moisture;
-                        MoistureTypes[i, j] = GeographyUtility.GetMoistureType(moisture);
+                        int moisture = (int)Mathf.Lerp(config.Min, config.Max, floatResult); ;
+                        moistures[i + j * width] = moisture;
+                        moistureTypes[i + j * width] = GeographyUtility.GetMoistureTypeId(moisture);
 
                         if (debugMoisture) texMoisture.SetPixel(i, j, Color.Lerp(Color.black, Color.white, floatResult));
                     }
-                }
+                });
+                Moistures = moistures;
+                MoistureTypes = moistureTypes;
             }
             if (debugMoisture) System.IO.File.WriteAllBytes(Application.streamingAssetsPath + "/moisture.png", texMoisture.EncodeToPNG());
         }
@@ -442,31 +742,41 @@ namespace Weathering
             if (debugTemporature) texTemporature = new Texture2D(Width, Height);
             if (temporatureConfig.CanGenearate) {
                 if (!altitudeConfig.CanGenerate) throw new Exception();
+                int width = Width;
+                int height = Height;
                 int size = temporatureConfig.BaseNoiseSize;
-                Temporatures = new int[Width, Height];
-                TemporatureTypes = new Type[Width, Height];
+                int[] temporatures = new int[width * height];
+                TemporatureTypeId[] temporatureTypes = new TemporatureTypeId[width * height];
                 int offset = AutoInc;
-                for (int i = 0; i < Width; i++) {
-                    for (int j = 0; j < Height; j++) {
-                        float noise = HashUtility.PerlinNoise((float)size * i / Width, (float)size * j / Height, size, size, offset + (int)HashCode);
+                int hashCode = (int)HashCode;
+                int[] altitudes = Altitudes;
+                int altitudeMax = altitudeConfig.Max;
+                TemporatureConfig config = temporatureConfig;
+                ForEachRow(debugTemporature, j => {
+                    float[] noiseRow = new float[width];
+                    HashUtility.PerlinNoiseRow(size, j, width, height, offset + hashCode, noiseRow);
+                    for (int i = 0; i < width; i++) {
+                        float noise = noiseRow[i];
                         noise = (noise + 1) / 2;
-                        float latitude = Mathf.Sin(Mathf.PI * j / Width);
-                        float floatResult = Mathf.Lerp(noise, latitude, temporatureConfig.AltitudeInfluence);
+                        float latitude = Mathf.Sin(Mathf.PI * j / width);
+                        float floatResult = Mathf.Lerp(noise, latitude, config.AltitudeInfluence);
 
                         // 海拔升高, 温度降低
-                        int altitude = Altitudes[i, j];
-                        if (altitude > 0 && altitudeConfig.Max > 0) {
-                            float t = 0.02f * altitude / altitudeConfig.Max;
-                            floatResult = Mathf.Lerp(floatResult, temporatureConfig.Min, t);
+                        int altitude = altitudes[i + j * width];
+                        if (altitude > 0 && altitudeMax > 0) {
+                            float t = 0.02f * altitude / altitudeMax;
+                            floatResult = Mathf.Lerp(floatResult, config.Min, t);
                         }
 
-                        int temporature = temporatureConfig.Min + (int)(floatResult * (temporatureConfig.Max - temporatureConfig.Min));
-                        Temporatures[i, j] = temporature;
-                        TemporatureTypes[i, j] = GeographyUtility.GetTemporatureType(temporature);
+                        int temporature = config.Min + (int)(floatResult * (config.Max - config.Min));
+                        temporatures[i + j * width] = temporature;
+                        temporatureTypes[i + j * width] = GeographyUtility.GetTemporatureTypeId(temporature);
 
                         if (debugTemporature) texTemporature.SetPixel(i, j, Color.Lerp(Color.black, Color.white, floatResult));
                     }
-                }
+                });
+                Temporatures = temporatures;
+                TemporatureTypes = temporatureTypes;
             }
             if (debugTemporature) System.IO.File.WriteAllBytes(Application.streamingAssetsPath + "/temporature.png", texTemporature.EncodeToPNG());
         }
@@ -488,7 +798,7 @@ namespace Weathering
         public virtual void Delete() {}
 
         public ITileDefinition GetTileFast(int i, int j) {
-            return Tiles[i, j];
+            return Tiles[i, j] ?? MaterializeDefaultTile(i, j);
         }
 
         public virtual void AfterConstructMapBody() {
@@ -13,17 +13,51 @@ namespace Weathering
     /// 3. SpriteKey
     /// 4. Construct, Destruct, Enable
     /// </summary>
-    public abstract class StandardTile : ITileDefinition
+    public abstract class StandardTile : ITileDefinition, ISaveDirty
     {
-        public bool NeedUpdateSpriteKeys { get; set; } = true;
+        private bool needUpdateSpriteKeys = true;
+        public bool NeedUpdateSpriteKeys {
+            get => needUpdateSpriteKeys;
+            set {
+                needUpdateSpriteKeys = value;
+                // 通知MapView重画, MapView不再每帧检查视野内所有地块
+                if (value) MapView.Ins?.InvalidateTile(this);
+            }
+        }
         public int NeedUpdateSpriteKeysPositionX { get; set; }
         public int NeedUpdateSpriteKeysPositionY { get; set; }
 
-        public IValues Values { get; protected set; } = null;
+        private IValues values = null;
+        private IRefs refs = null;
+        private IInventory inventory = null;
+        public IValues Values {
+            get => values;
+            protected set {
+                // 地图使用ComponentStore时, 值存进地图的数组
+                ComponentStore store = (Map as IMapDefinition)?.ComponentStore;
+                if (store != null) {
+                    value = store.Adopt(value);
+                    if (values != value) (values as StoredValues)?.Release();
+                }
+                values = value;
+                SaveDirty.Attach(value, this);
+            }
+        }
         public void SetValues(IValues values) => Values = values;
-        public IRefs Refs { get; set; } = null;
+        public IRefs Refs {
+            get => refs;
+            set {
+                ComponentStore store = (Map as IMapDefinition)?.ComponentStore;
+                if (store != null) {
+                    value = store.Adopt(value);
+                    if (refs != value) (refs as StoredRefs)?.Release();
+                }
+                refs = value;
+                SaveDirty.Attach(value, this);
+            }
+        }
         public void SetRefs(IRefs refs) => Refs = refs;
-        public IInventory Inventory { get; protected set; }
+        public IInventory Inventory { get => inventory; protected set { inventory = value; SaveDirty.Attach(value, this); } }
         public void SetInventory(IInventory inventory) => Inventory = inventory;
         public IInventory InventoryOfSupply { get => throw new NotImplementedException(); protected set => throw new NotImplementedException(); }
         public void SetInventoryOfSupply(IInventory inventory) => throw new NotImplementedException(); // InventoryOfSupply = inventory;
@@ -36,6 +70,9 @@ namespace Weathering
         public uint TileHashCode { get; set; }
         public uint GetTileHashCode() => TileHashCode;
 
+        // 增量存档, 数据被修改时标记所在区块
+        public void MarkSaveDirty() => (Map as IMapDefinition)?.MarkSaveDirty(Pos);
+
 
         /// <summary>
         /// SpriteKeyBackground和SpriteKeyBase都是Map定义的
@@ -57,6 +94,26 @@ namespace Weathering
         public virtual string SpriteUp { get => null; }
         public virtual string SpriteDown { get => null; }
 
+        /// <summary>
+        /// 渲染时使用的贴图id。默认由字符串转换, 每帧可能刷新的地块应该重写并返回缓存好的id
+        /// 地形层直接取Map的id版本, 重写SpriteKeyBedrock等地形字符串的地块也要重写对应的id
+        /// </summary>
+        public virtual int SpriteIdBedrock => Map.GetSpriteIdBedrock(Pos);
+        public virtual int SpriteIdWater => Map.GetSpriteIdWater(Pos);
+        public virtual int SpriteIdGrass => PreserveLandscape ? Map.GetSpriteIdGrass(Pos) : Res.NoSprite;
+        public virtual int SpriteIdTree => PreserveLandscape ? Map.GetSpriteIdTree(Pos) : Res.NoSprite;
+        public virtual int SpriteIdHill => PreserveLandscape ? Map.GetSpriteIdHill(Pos) : Res.NoSprite;
+
+        public virtual int SpriteIdRoad => Res.SpriteId(SpriteKeyRoad);
+        public virtual int SpriteId => Res.SpriteId(SpriteKey);
+        public virtual int SpriteIdHighLight => Res.SpriteId(SpriteKeyHighLight);
+        public virtual int SpriteIdOverlay => Res.SpriteId(SpriteKeyOverlay);
+
+        public virtual int SpriteIdLeft => Res.SpriteId(SpriteLeft);
+        public virtual int SpriteIdRight => Res.SpriteId(SpriteRight);
+        public virtual int SpriteIdUp => Res.SpriteId(SpriteUp);
+        public virtual int SpriteIdDown => Res.SpriteId(SpriteDown);
+
         public Tile TileSpriteKeyBedrockBuffer { get; set; }
         public Tile TileSpriteKeyWaterBuffer { get; set; }
         public Tile TileSpriteKeyGrassBuffer { get; set; }
@@ -0,0 +1,181 @@
+﻿
+using System;
+using System.Collections.Generic;
+using UnityEngine;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 一张地图的物流图。节点为ILinkProvider, ILinkConsumer地块, 边为相邻地块之间的连接
+    /// 连接本身仍存在地块的Refs里, 以方向为键。此图只是索引, 第一次使用时扫描全图, 之后在连接, 取消连接, 建造时增量更新
+    /// </summary>
+    public class LinkGraph
+    {
+        public class Edge
+        {
+            public Vector2Int Provider;
+            public Vector2Int Consumer;
+            public Type Type;
+            public long Quantity;
+        }
+
+        /// <summary>
+        /// 需求未满足的地块
+        /// </summary>
+        public struct Shortage
+        {
+            public Vector2Int Pos;
+            public Type Type;
+            public long Quantity;
+        }
+
+        // 与LinkUtility一致的方向顺序, 需求方在某方向上的连接, 供给方在该方向的相邻地块
+        public static readonly Type[] Directions = { typeof(IUp), typeof(IDown), typeof(ILeft), typeof(IRight) };
+        private static readonly Vector2Int[] offsets = { Vector2Int.up, Vector2Int.down, Vector2Int.left, Vector2Int.right };
+        public static int DirectionIndex(Type direction) {
+            for (int k = 0; k < Directions.Length; k++) {
+                if (Directions[k] == direction) return k;
+            }
+            throw new Exception($"不是方向 {direction?.Name}");
+        }
+
+        private readonly IMapDefinition map;
+        private readonly HashSet<Vector2Int> nodes = new HashSet<Vector2Int>();
+        // inputs[pos][k]: pos作为需求方, 在方向k上的输入; outputs[pos][k]: pos作为供给方, 在方向k上的输出
+        private readonly Dictionary<Vector2Int, Edge[]> inputs = new Dictionary<Vector2Int, Edge[]>();
+        private readonly Dictionary<Vector2Int, Edge[]> outputs = new Dictionary<Vector2Int, Edge[]>();
+
+        public int EdgeCount { get; private set; } = 0;
+        public int NodeCount => nodes.Count;
+        public IEnumerable<Vector2Int> Nodes => nodes;
+
+        public LinkGraph(IMapDefinition map) {
+            this.map = map;
+            int width = map.Width;
+            int height = map.Height;
+            for (int i = 0; i < width; i++) {
+                for (int j = 0; j < height; j++) {
+                    if (!map.IsTileMaterialized(i, j)) continue;
+                    AddNode(map.GetTileFast(i, j));
+                }
+            }
+        }
+
+        private void AddNode(ITile tile) {
+            if (!(tile is ILinkConsumer) && !(tile is ILinkProvider)) return;
+            nodes.Add(tile.GetPos());
+            for (int k = 0; k < Directions.Length; k++) {
+                SyncLink(tile, k);
+            }
+        }
+
+        /// <summary>
+        /// 地块被替换后调用
+        /// </summary>
+        public void OnTileChanged(ITile tile) {
+            Vector2Int pos = tile.GetPos();
+            nodes.Remove(pos);
+            if (inputs.TryGetValue(pos, out Edge[] ins)) {
+                foreach (var edge in ins) {
+                    if (edge != null) RemoveEdge(edge);
+                }
+            }
+            if (outputs.TryGetValue(pos, out Edge[] outs)) {
+                foreach (var edge in outs) {
+                    if (edge != null) RemoveEdge(edge);
+                }
+            }
+            AddNode(tile);
+        }
+
+        /// <summary>
+        /// 需求方在consumerDir方向的连接修改后调用, 重新读取这一对连接
+        /// </summary>
+        public void SyncLink(ITile consumer, Type consumerDir) => SyncLink(consumer, DirectionIndex(consumerDir));
+        private void SyncLink(ITile consumer, int k) {
+            Vector2Int pos = consumer.GetPos();
+            if (inputs.TryGetValue(pos, out Edge[] ins) && ins[k] != null) {
+                RemoveEdge(ins[k]);
+            }
+            IRefs refs = consumer.Refs;
+            if (refs == null || !refs.TryGet(Directions[k], out IRef link) || link.Value <= 0) return;
+
+            Vector2Int providerPos = Wrap(pos + offsets[k]);
+            Edge edge = new Edge { Provider = providerPos, Consumer = pos, Type = link.Type, Quantity = link.Value };
+            SlotsOf(inputs, pos)[k] = edge;
+            SlotsOf(outputs, providerPos)[Opposite(k)] = edge;
+            EdgeCount++;
+        }
+
+        private void RemoveEdge(Edge edge) {
+            int k = IndexOf(inputs[edge.Consumer], edge);
+            inputs[edge.Consumer][k] = null;
+            outputs[edge.Provider][Opposite(k)] = null;
+            EdgeCount--;
+        }
+
+        private static Edge[] SlotsOf(Dictionary<Vector2Int, Edge[]> dict, Vector2Int pos) {
+            if (!dict.TryGetValue(pos, out Edge[] slots)) {
+                slots = new Edge[4];
+                dict.Add(pos, slots);
+            }
+            return slots;
+        }
+        private static int IndexOf(Edge[] slots, Edge edge) {
+            for (int k = 0; k < slots.Length; k++) {
+                if (slots[k] == edge) return k;
+            }
+            throw new Exception();
+        }
+        private static int Opposite(int k) => k ^ 1; // 上下, 左右
+        private Vector2Int Wrap(Vector2Int pos) {
+            // 地图首尾相接, 与IMap.Get一致
+            int x = pos.x % map.Width;
+            int y = pos.y % map.Height;
+            return new Vector2Int(x < 0 ? x + map.Width : x, y < 0 ? y + map.Height : y);
+        }
+
+        /// <summary>
+        /// 方向k上的相邻地块
+        /// </summary>
+        public Vector2Int Neighbor(Vector2Int pos, int k) => Wrap(pos + offsets[k]);
+
+        private static readonly Edge[] noEdges = new Edge[4];
+        /// <summary>
+        /// 按方向的4个槽, 空槽为null
+        /// </summary>
+        public Edge[] InputsOf(Vector2Int pos) => inputs.TryGetValue(pos, out Edge[] slots) ? slots : noEdges;
+        public Edge[] OutputsOf(Vector2Int pos) => outputs.TryGetValue(pos, out Edge[] slots) ? slots : noEdges;
+
+        private readonly List<IRef> refsBuffer = new List<IRef>();
+        /// <summary>
+        /// 沿输入边向上游查找需求未满足的地块, 包括自己。无限容量的需求(如仓库)不算
+        /// </summary>
+        public List<Shortage> FindShortages(Vector2Int start) {
+            List<Shortage> result = new List<Shortage>();
+            HashSet<Vector2Int> visited = new HashSet<Vector2Int> { start };
+            Queue<Vector2Int> queue = new Queue<Vector2Int>();
+            queue.Enqueue(start);
+            while (queue.Count > 0) {
+                Vector2Int pos = queue.Dequeue();
+                if (map.Get(pos.x, pos.y) is ILinkConsumer consumer) {
+                    if (refsBuffer.Count != 0) throw new Exception();
+                    consumer.Consume(refsBuffer);
+                    foreach (var r in refsBuffer) {
+                        if (r.Type == null || r.BaseValue == long.MaxValue) continue;
+                        if (r.Value < r.BaseValue) {
+                            result.Add(new Shortage { Pos = pos, Type = r.Type, Quantity = r.BaseValue - r.Value });
+                        }
+                    }
+                    refsBuffer.Clear();
+                }
+                foreach (var edge in InputsOf(pos)) {
+                    if (edge != null && visited.Add(edge.Provider)) {
+                        queue.Enqueue(edge.Provider);
+                    }
+                }
+            }
+            return result;
+        }
+    }
+}
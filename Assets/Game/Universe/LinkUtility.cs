@@ -345,6 +345,7 @@ namespace Weathering
                                     provider.Refs.Remove(providerDir);
                                     consumer.Refs.Remove(consumerDir);
                                 }
+                                SyncLinkGraph(consumerTile, consumerDir);
 
                                 NeedUpdateNeighbors(providerTile);
                                 NeedUpdateNeighbors(consumerTile);
@@ -448,6 +449,7 @@ namespace Weathering
                             consumerLink.Value += quantity; // consumerLink以正值表示输入
                             providerRef.Value -= quantity;
                             consumerRef.Value += quantity;
+                            SyncLinkGraph(consumerTile, consumerDir);
 
                             //providerTile.NeedUpdateSpriteKeys = true;
                             //consumerTile.NeedUpdateSpriteKeys = true;
@@ -522,6 +524,7 @@ namespace Weathering
                                     provider.Refs.Remove(providerDir);
                                     consumer.Refs.Remove(consumerDir);
                                 }
+                                SyncLinkGraph(consumerTile, consumerDir);
 
                                 NeedUpdateNeighbors(providerTile);
                                 NeedUpdateNeighbors(consumerTile);
@@ -640,6 +643,7 @@ namespace Weathering
                             consumerLink.Value += quantity; // consumerLink以正值表示输入
                             providerRef.Value -= quantity;
                             consumerRef.Value += quantity;
+                            SyncLinkGraph(consumerTile, consumerDir);
 
                             NeedUpdateNeighbors(providerTile);
                             NeedUpdateNeighbors(consumerTile);
@@ -672,6 +676,47 @@ namespace Weathering
             providerRefsBuffer.Clear();
         }
 
+        private static void SyncLinkGraph(ITile consumerTile, Type consumerDir) {
+            (consumerTile.GetMap() as IMapDefinition)?.LinkGraph.SyncLink(consumerTile, consumerDir);
+        }
+
+        /// <summary>
+        /// 全图自动建立输入连接。先按位置顺序对每个需求方执行一次AutoConsume
+        /// 某个地块新连上输入后, 它作为供给方可能有了新的输出, 只把它还没有连接输出的相邻需求方再放回队列, 使上游先连上的链条也能传到下游
+        /// </summary>
+        public static int AutoLinkMap(IMapDefinition map) {
+            LinkGraph graph = map.LinkGraph;
+            List<Vector2Int> consumers = new List<Vector2Int>();
+            foreach (var pos in graph.Nodes) {
+                if (map.Get(pos) is ILinkConsumer) consumers.Add(pos);
+            }
+            consumers.Sort((a, b) => a.y != b.y ? a.y.CompareTo(b.y) : a.x.CompareTo(b.x));
+
+            Queue<Vector2Int> queue = new Queue<Vector2Int>(consumers);
+            HashSet<Vector2Int> queued = new HashSet<Vector2Int>(consumers);
+            int before = graph.EdgeCount;
+            while (queue.Count > 0) {
+                Vector2Int pos = queue.Dequeue();
+                queued.Remove(pos);
+                ITile tile = map.Get(pos);
+                if (!(tile is ILinkConsumer)) continue;
+
+                int edgeCount = graph.EdgeCount;
+                AutoConsume(tile);
+                if (graph.EdgeCount == edgeCount || !(tile is ILinkProvider)) continue;
+
+                LinkGraph.Edge[] outputs = graph.OutputsOf(pos);
+                for (int k = 0; k < LinkGraph.Directions.Length; k++) {
+                    if (outputs[k] != null) continue; // 这个方向已经在输出
+                    Vector2Int neighbor = graph.Neighbor(pos, k);
+                    if (map.Get(neighbor) is ILinkConsumer && queued.Add(neighbor)) {
+                        queue.Enqueue(neighbor);
+                    }
+                }
+            }
+            return graph.EdgeCount - before;
+        }
+
         public static void NeedUpdateNeighbors(ITile tile) {
             IMap map = tile.GetMap();
             Vector2Int pos = tile.GetPos();
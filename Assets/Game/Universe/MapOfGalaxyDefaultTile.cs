@@ -77,12 +77,12 @@ namespace Weathering
 
             string title = $"{typeof(MapOfStarSystem).Name}#{Pos.x},{Pos.y}";
             if (isStar) {
-
+                GameEntry.Ins.PrefetchChildMap(typeof(MapOfStarSystem), Map as IMapDefinition, Pos);
                 items.Add(UIItem.CreateButton($"进入{title}", () => {
                     Map.EnterChildMap(Pos);
                 }));
             } else {
-
+                GameEntry.Ins.PrefetchParentMap(typeof(MapOfUniverse), Map as IMapDefinition);
                 items.Add(UIItem.CreateButton($"离开此银河系", () => {
                     Map.EnterParentMap();
                 }));
@@ -68,7 +68,7 @@ namespace Weathering
                 if (waterSurfaceBuffer == null) waterSurfaceBuffer = $"{PlanetType.Name}_WaterSurface";
                 if (waterWaveBuffer == null) waterWaveBuffer = $"{PlanetType.Name}_WaterWave";
 
-                return GetRealTerrainType(pos + Vector2Int.up) == typeof(TerrainType_Sea) ? waterSurfaceBuffer : waterWaveBuffer;
+                return (SeaPlane.Mask(pos.x, pos.y) & NeighborMaskPlane.Up) != 0 ? waterSurfaceBuffer : waterWaveBuffer;
 
                 //int index = TileUtility.Calculate4x4RuleTileIndex(Get(pos), (otherTile, b) => GetRealTerrainType(otherTile.GetPos()) == typeof(TerrainType_Sea));
                 //if ((pos.x + pos.y) % 2 == 0) {
@@ -88,24 +88,8 @@ namespace Weathering
         private System.Collections.Generic.Dictionary<int, string> grassBuffer = new System.Collections.Generic.Dictionary<int, string>();
 
         public override string GetSpriteKeyGrass(Vector2Int pos) {
-            ITile tile = Get(pos);
-            uint tileHashCode = tile.GetTileHashCode();
-
-            Type type = GetRealTerrainType(pos);
-
-            if (type != typeof(TerrainType_Sea)) {
-                int index = TileUtility.Calculate4x4RuleTileIndex(Get(pos), (otherTile, direction) => {
-
-                    Vector2Int otherPos = otherTile.GetPos();
-                    Type otherType = GetRealTerrainType(otherPos);
-                    bool hasGrass = otherType != typeof(TerrainType_Sea);
-
-                    return hasGrass;
-
-                });
-                if (index == 5) { // center
-                    index = 16 + (int)(tile.GetTileHashCode() % 16);
-                }
+            int index = GrassIndex(pos);
+            if (index >= 0) {
                 if (grassBuffer.TryGetValue(index, out string result)) {
                     return result;
                 } else {
@@ -117,23 +101,24 @@ namespace Weathering
             return null;
             // return null;
         }
+        // 海洋返回-1
+        private int GrassIndex(Vector2Int pos) {
+            pos = Validate(pos);
+            if (!SeaPlane.Has(pos.x, pos.y)) {
+                // 非海洋即有草
+                int index = TileUtility.Calculate4x4RuleTileIndex((byte)~SeaPlane.Mask(pos.x, pos.y));
+                if (index == 5) { // center
+                    index = 16 + (int)(HashUtility.Hash(pos.x, pos.y, Width, Height, (int)HashCode) % 16);
+                }
+                return index;
+            }
+            return -1;
+        }
 
         private string treeBuffer = null;
         public override string GetSpriteKeyTree(Vector2Int pos) {
-            ITile tile = Get(pos);
-            uint tileHashCode = tile.GetTileHashCode();
-            Type type = GetRealTerrainType(pos);
-
-            if (type == typeof(TerrainType_Forest)) {
-                int index = TileUtility.Calculate4x4RuleTileIndex(Get(pos), (otherTile, dir) => {
-
-                    Vector2Int otherPos = otherTile.GetPos();
-                    Type otherType = GetRealTerrainType(otherPos);
-                    bool isForest = otherType == typeof(TerrainType_Forest);
-                    // bool smallAltitudeDifference = Math.Abs(Altitudes[otherPos.x, otherPos.y] - Altitudes[pos.x, pos.y]) <= 500 && (Altitudes[otherPos.x, otherPos.y] - Altitudes[pos.x, pos.y] < 0);
-
-                    return isForest;
-                });
+            if (ForestPlane.Has(pos.x, pos.y)) {
+                // int index = TileUtility.Calculate4x4RuleTileIndex(ForestPlane.Mask(pos.x, pos.y));
                 if (treeBuffer == null) treeBuffer = $"{PlanetType.Name}_Tree";
                 return treeBuffer;
                 // return $"PlanetLandForm_Tree";
@@ -143,25 +128,57 @@ namespace Weathering
         }
 
         public override string GetSpriteKeyHill(Vector2Int pos) {
-            ITile tile = Get(pos);
-            uint tileHashCode = tile.GetTileHashCode();
-            Type type = GetRealTerrainType(pos);
-
-            if (type == typeof(TerrainType_Mountain)) {
+            int index = HillIndex(pos);
+            return index >= 0 ? $"{PlanetType.Name}_Hill_{index}" : null;
+        }
+        // 不是山地返回-1
+        private int HillIndex(Vector2Int pos) {
+            if (MountainPlane.Has(pos.x, pos.y)) {
                 // 显示矿物
-                int index = TileUtility.Calculate6x8RuleTileIndex(Get(pos), otherTile => {
-
-                    Vector2Int otherPos = otherTile.GetPos();
-                    Type otherType = GetRealTerrainType(otherPos);
-                    bool isMountain = otherType == typeof(TerrainType_Mountain);
-                    // bool smallAltitudeDifference = Math.Abs(Altitudes[otherPos.x, otherPos.y] - Altitudes[pos.x, pos.y]) <= 500 && (Altitudes[otherPos.x, otherPos.y] - Altitudes[pos.x, pos.y] < 0);
+                return TileUtility.Calculate6x8RuleTileIndex(MountainPlane.Mask(pos.x, pos.y));
+            }
+            return -1;
+        }
 
-                    return isMountain;
-                });
-                return $"{PlanetType.Name}_Hill_{index}";
+        // 渲染用的贴图id, 与上面的字符串版本一致, 不拼接字符串
+        private int bedrockId = Res.NoSprite;
+        private int waterSurfaceId = Res.NoSprite;
+        private int waterWaveId = Res.NoSprite;
+        private int treeId = Res.NoSprite;
+        private int[] grassIds = null;
+        private int[] hillIds = null;
+        public override int GetSpriteIdBedrock(Vector2Int pos) {
+            if (bedrockId == Res.NoSprite) bedrockId = Res.SpriteId(GetSpriteKeyBedrock(pos));
+            return bedrockId;
+        }
+        public override int GetSpriteIdWater(Vector2Int pos) {
+            if (SeaPlane.Has(pos.x, pos.y)) {
+                if (waterSurfaceId == Res.NoSprite) waterSurfaceId = Res.SpriteId($"{PlanetType.Name}_WaterSurface");
+                if (waterWaveId == Res.NoSprite) waterWaveId = Res.SpriteId($"{PlanetType.Name}_WaterWave");
+                return (SeaPlane.Mask(pos.x, pos.y) & NeighborMaskPlane.Up) != 0 ? waterSurfaceId : waterWaveId;
             }
-            return null;
+            return Res.NoSprite;
         }
+        public override int GetSpriteIdGrass(Vector2Int pos) {
+            int index = GrassIndex(pos);
+            if (index < 0) return Res.NoSprite;
+            if (grassIds == null) grassIds = Res.SpriteIds($"{PlanetType.Name}_Grass", 32);
+            return grassIds[index];
+        }
+        public override int GetSpriteIdTree(Vector2Int pos) {
+            if (ForestPlane.Has(pos.x, pos.y)) {
+                if (treeId == Res.NoSprite) treeId = Res.SpriteId($"{PlanetType.Name}_Tree");
+                return treeId;
+            }
+            return Res.NoSprite;
+        }
+        public override int GetSpriteIdHill(Vector2Int pos) {
+            int index = HillIndex(pos);
+            if (index < 0) return Res.NoSprite;
+            if (hillIds == null) hillIds = Res.SpriteIds($"{PlanetType.Name}_Hill", 48);
+            return hillIds[index];
+        }
+
 
 
 
@@ -170,6 +187,57 @@ namespace Weathering
 
 
 
+        // 各地形的8邻域掩码, 第一次渲染时计算, 之后在地块替换和改造地形时更新
+        private NeighborMaskPlane seaPlane;
+        private NeighborMaskPlane mountainPlane;
+        private NeighborMaskPlane forestPlane;
+        private NeighborMaskPlane fogPlane;
+        private NeighborMaskPlane SeaPlane { get { if (seaPlane == null) CreateTerrainPlanes(); return seaPlane; } }
+        private NeighborMaskPlane MountainPlane { get { if (mountainPlane == null) CreateTerrainPlanes(); return mountainPlane; } }
+        private NeighborMaskPlane ForestPlane { get { if (forestPlane == null) CreateTerrainPlanes(); return forestPlane; } }
+        /// <summary>
+        /// 未建造的山地, 用于MapOfPlanetDefaultTile的迷雾贴图
+        /// </summary>
+        public NeighborMaskPlane FogPlane { get { if (fogPlane == null) CreateTerrainPlanes(); return fogPlane; } }
+
+        private void CreateTerrainPlanes() {
+            Type[] terrains = new Type[Width * Height];
+            bool[] fogs = new bool[Width * Height];
+            for (int j = 0; j < Height; j++) {
+                for (int i = 0; i < Width; i++) {
+                    // 没有创建的默认地块, 地形即原始地形, 不必创建
+                    int index = FieldIndex(i, j);
+                    if (IsTileMaterialized(i, j)) {
+                        Vector2Int pos = new Vector2Int(i, j);
+                        terrains[index] = GetRealTerrainType(pos);
+                        fogs[index] = IsFog(Get(pos));
+                    } else {
+                        terrains[index] = GetOriginalTerrainType(new Vector2Int(i, j));
+                        fogs[index] = terrains[index] == typeof(TerrainType_Mountain);
+                    }
+                }
+            }
+            seaPlane = new NeighborMaskPlane(Width, Height, (i, j) => terrains[FieldIndex(i, j)] == typeof(TerrainType_Sea));
+            mountainPlane = new NeighborMaskPlane(Width, Height, (i, j) => terrains[FieldIndex(i, j)] == typeof(TerrainType_Mountain));
+            forestPlane = new NeighborMaskPlane(Width, Height, (i, j) => terrains[FieldIndex(i, j)] == typeof(TerrainType_Forest));
+            fogPlane = new NeighborMaskPlane(Width, Height, (i, j) => fogs[FieldIndex(i, j)]);
+        }
+        private static bool IsFog(ITile tile) => tile is MapOfPlanetDefaultTile defaultTile && defaultTile.TerraformedTerrainType == typeof(TerrainType_Mountain);
+
+        /// <summary>
+        /// 地块的实际地形可能改变时调用
+        /// </summary>
+        public void OnTerrainChanged(Vector2Int pos) {
+            if (seaPlane == null) return;
+            pos = Validate(pos);
+            ITile tile = Get(pos);
+            Type type = GetRealTerrainType(pos);
+            seaPlane.Set(pos.x, pos.y, type == typeof(TerrainType_Sea));
+            mountainPlane.Set(pos.x, pos.y, type == typeof(TerrainType_Mountain));
+            forestPlane.Set(pos.x, pos.y, type == typeof(TerrainType_Forest));
+            fogPlane.Set(pos.x, pos.y, IsFog(tile));
+        }
+        protected override void OnTileReplaced(ITile tile) => OnTerrainChanged(tile.GetPos());
 
         public Type GetRealTerrainType(Vector2Int pos) {
             ITile tile = Get(pos);
@@ -189,12 +257,13 @@ namespace Weathering
 
         public Type GetOriginalTerrainType(Vector2Int pos) {
             pos = Validate(pos);
+            int index = FieldIndex(pos.x, pos.y);
             // 不是海, 就是地
-            if (AltitudeTypes[pos.x, pos.y] != typeof(AltitudeSea)) {
+            if (AltitudeTypes[index] != AltitudeTypeId.Sea) {
                 // 不是森林, 就是平原/秃地
 
-                if (TemporatureTypes[pos.x, pos.y] == typeof(TemporatureTemporate)) {
-                    if (MoistureTypes[pos.x, pos.y] == typeof(MoistureForest)) {
+                if (TemporatureTypes[index] == TemporatureTypeId.Temporate) {
+                    if (MoistureTypes[index] == MoistureTypeId.Forest) {
                         return typeof(TerrainType_Forest);
                     } else {
                         return typeof(TerrainType_Plain);
@@ -203,7 +272,7 @@ namespace Weathering
                     return typeof(TerrainType_Mountain);
                 }
 
-            } else if (AltitudeTypes[pos.x, pos.y] == typeof(AltitudeSea)) {
+            } else if (AltitudeTypes[index] == AltitudeTypeId.Sea) {
                 return typeof(TerrainType_Sea);
             }
             //else if (AltitudeTypes[pos.x, pos.y] == typeof(AltitudeMountain)) {
@@ -216,6 +285,7 @@ namespace Weathering
 
 
         public override Type DefaultTileType => typeof(MapOfPlanetDefaultTile);
+        protected override bool UseComponentStore => true; // 星球地块最多
 
         public override int Width => width;
         public override int Height => height;
@@ -350,32 +420,7 @@ namespace Weathering
         /// </summary>
         public int SecondsForADay => (ParentTile as MapOfStarSystemDefaultTile).SecondsForADay;
 
-        /// <summary>
-        /// 0-1 昼夜
-        /// </summary>
-        public double ProgressOfDay {
-            get {
-                double day_count = GetTime / SecondsForADay;
-                double result = day_count - (int)day_count;
-                return result;
-            }
-        }
-
-        /// <summary>
-        /// 从1970年开始的星球天数
-        /// </summary>
-        public int DayCount => (int)(GetTime / SecondsForADay);
-
-        /// <summary>
-        /// 从1970年开始的星球月数
-        /// </summary>
-        public int MonthCount => (int)(GetTime / (DaysForAMonth * SecondsForADay));
-        /// <summary>
-        /// 从1970年开始的星球年数
-        /// </summary>
-        public int YearCount => (int)(GetTime / (DaysForAYear * SecondsForADay));
-
-        public const int MonthForAYear = 12;
+        public const int MonthForAYear = PlanetEnvironment.MonthForAYear;
         /// <summary>
         /// 一年多少天
         /// </summary>
@@ -386,86 +431,49 @@ namespace Weathering
         /// </summary>
         public int DaysForAMonth => 2 + (int)(HashCode % 15);
 
-
         /// <summary>
-        /// 0-1 季节
+        /// 本帧的环境, 每帧只计算一次
         /// </summary>
-        public double ProgressOfYear {
+        public PlanetEnvironment Environment {
             get {
-                double year_count = GetTime / (DaysForAYear * SecondsForADay);
-                return year_count - (int)(year_count);
-            }
-        }
-
-        private float windNoise_last;
-        private long windNoise_frame;
-        public float WindNoise {
-            get {
-                return GameEntry.FrameBuffer(ref windNoise_last, ref windNoise_frame, () => 2 * (float)HashUtility.SimpleValueNoise(4 * GetTime / (SecondsForADay)) - 1);
-            }
-        }
-        /// <summary>
-        /// 风力等级
-        /// </summary>
-        public float WindStrength {
-            get {
-                float noise = WindNoise;
-                return noise * noise * noise;
+                long frame = GameEntry.Ins.FrameCount;
+                if (environmentFrame != frame) {
+                    environment = new PlanetEnvironment(GetTime, SecondsForADay, DaysForAMonth);
+                    environmentFrame = frame;
+                }
+                return environment;
             }
         }
-        /// <summary>
-        /// 一年中第几天
-        /// </summary>
-        public int DayInYear => DayCount - YearCount * DaysForAYear;
-
-        /// <summary>
-        /// 一年中第几个月
-        /// </summary>
-        // public int MonthInYear => MonthCount - YearCount * MonthForAYear;
-        public int MonthInYear => MonthCount - YearCount * MonthForAYear;
-
-        /// <summary>
-        /// 一月中第几天
-        /// </summary>
-        public int DayInMonth => DayCount - MonthCount * DaysForAMonth;
+        private PlanetEnvironment environment;
+        private long environmentFrame = -1;
 
+        public double ProgressOfDay => Environment.ProgressOfDay;
+        public double ProgressOfYear => Environment.ProgressOfYear;
 
+        public int DayCount => Environment.DayCount;
+        public int MonthCount => Environment.MonthCount;
+        public int YearCount => Environment.YearCount;
 
-        public float Temporature {
-
-            get {
-                var result = -1f * (float)Math.Cos(ProgressOfYear * (2 * Mathf.PI));
-                return result;
-            }
-        }
+        public int DayInYear => Environment.DayInYear;
+        public int MonthInYear => Environment.MonthInYear;
+        public int DayInMonth => Environment.DayInMonth;
 
-        public float Tint => (float)Math.Cos(ProgressOfYear * (2 * Mathf.PI));
+        public float WindNoise => Environment.WindNoise;
+        public float WindStrength => Environment.WindStrength;
 
+        public float Temporature => Environment.Temporature;
+        public float Tint => Environment.Tint;
 
-        private float humidity_last;
-        private long humidity_frame;
-        // public float Humidity => 2 * (float)HashUtility.SimpleValueNoise((GetTime / SecondsForADay) - 1);
-        public float Humidity => GameEntry.FrameBuffer(ref humidity_last, ref humidity_frame, () => 2 * (float)HashUtility.SimpleValueNoise((GetTime / SecondsForADay) - 1)); // -1~1
+        public float Humidity => Environment.Humidity;
 
         public bool Foggy => true;
-        public float FogDensity => Mathf.Clamp01((Humidity + Mathf.Abs(WindStrength)) * 0.75f);
+        public float FogDensity => Environment.FogDensity;
 
         public bool Rainy => true;
-        public float RainDensity => 1-Snow;
+        public float RainDensity => Environment.RainDensity;
 
         public bool Snowy => true;
-        public float SnowDensity => Snow;
-
-
-        private float snow_last;
-        private long snow_frame;
-        private float Snow => GameEntry.FrameBuffer(ref snow_last, ref snow_frame, () => {
-            float t = Tint - 0.5f * (float)HashUtility.SimpleValueNoise((GetTime / SecondsForADay) - 1000) - 0.25f;
-            const float smooth = 0.1f;
-            if (t >= smooth) return 1;
-            else if (t <= -smooth) return 0;
-            else return Mathf.InverseLerp(-smooth, smooth, t);
-        });
+        public float SnowDensity => Environment.SnowDensity;
 
         #region landing
 
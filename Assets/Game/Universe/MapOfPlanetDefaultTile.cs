@@ -515,11 +515,7 @@ namespace Weathering
             get {
                 if (TerraformedTerrainType != typeof(TerrainType_Mountain)) return null;
 
-                int index = TileUtility.Calculate6x8RuleTileIndex(this,
-                    (ITile tile) =>
-                    tile is MapOfPlanetDefaultTile defaultTile &&
-                    defaultTile.TerraformedTerrainType == typeof(TerrainType_Mountain)
-                );
+                int index = TileUtility.Calculate6x8RuleTileIndex((Map as MapOfPlanet).FogPlane.Mask(Pos.x, Pos.y));
                 return $"Planet_Fog_{index}";
             }
         }
@@ -899,6 +895,7 @@ namespace Weathering
                     TerraformRef.Type = value;
                 }
                 LinkUtility.NeedUpdateNeighbors8(this);
+                (Map as MapOfPlanet)?.OnTerrainChanged(Pos);
             }
         }
 
@@ -1007,7 +1004,7 @@ namespace Weathering
             ///// 可降落
             //if (Map as ILandable == null) throw new Exception();
 
-            var items = new List<IUIItem>();
+            var items = UI.Ins.GetReusableItems();
 
             // items.Add(UIItem.CreateMultilineText($"debug pos: x {Pos.x} y {Pos.y}"));
 
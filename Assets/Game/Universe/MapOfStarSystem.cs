@@ -41,6 +41,7 @@ namespace Weathering
 
 
         public override string GetSpriteKeyBedrock(Vector2Int pos) => $"StarSystemBackground_{(Get(pos).GetTileHashCode() % 16)}";
+        public override int GetSpriteIdBedrock(Vector2Int pos) => Res.SpriteIds("StarSystemBackground", 16)[Get(pos).GetTileHashCode() % 16];
         // public override string GetSpriteKeyBedrock(Vector2Int pos) => $"GalaxyBackground_{(Get(pos).GetTileHashCode() % 16) + (16 * ((HashCode) % 6))}";
 
         public const long DefaultInventoryQuantityCapacity = 1000000;
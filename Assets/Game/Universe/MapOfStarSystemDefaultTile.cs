@@ -46,6 +46,23 @@ namespace Weathering
                 return null;
             }
         }
+        // 帧动画每次刷新都会读取, 使用预先驻留的id表
+        private int[] celestialBodySpriteIds = null;
+        public override int SpriteIdOverlay {
+            get {
+                if (IsCelestialBody) {
+                    if (celestialBodySpriteIds == null) celestialBodySpriteIds = Res.SpriteIds(CelestialBodyName, CelestialBodyType == typeof(Asteroid) ? 64 * 4 : 64);
+                    long frame = (InversedAnimation * MapView.Ins.AnimationIndex + TileHashCode) % 64;
+                    if (frame < 0) return base.SpriteIdOverlay; // 与字符串版本保持一致
+                    if (CelestialBodyType == typeof(Asteroid)) {
+                        return celestialBodySpriteIds[frame + 64 * asteroidOffset];
+                    } else {
+                        return celestialBodySpriteIds[frame];
+                    }
+                }
+                return Res.NoSprite;
+            }
+        }
         public int HasFrameAnimation => IsCelestialBody ? SlowedAnimation : 0;
         private bool IsCelestialBody => CelestialBodyType != typeof(SpaceEmptiness);
 
@@ -161,6 +178,7 @@ namespace Weathering
                 
                 ) {
                 uint childMapHashcode = GameEntry.ChildMapKeyHashCode(Map, Pos);
+                GameEntry.Ins.PrefetchChildMap(typeof(MapOfPlanet), Map as IMapDefinition, Pos);
                 items.Add(UIItem.CreateText($"星球昼夜：{SecondsForADay}秒"));
                 items.Add(UIItem.CreateText($"星球大小：{MapOfPlanet.CalculatePlanetSize(childMapHashcode)}"));
                 items.Add(UIItem.CreateText($"星球矿物稀疏度：{MapOfPlanet.CalculateMineralDensity(childMapHashcode)}"));
@@ -173,6 +191,7 @@ namespace Weathering
             } else {
 
                 OnTapVoid(items);
+                GameEntry.Ins.PrefetchParentMap(typeof(MapOfGalaxy), Map as IMapDefinition);
 
                 items.Add(UIItem.CreateSeparator());
 
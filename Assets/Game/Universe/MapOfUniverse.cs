@@ -15,6 +15,7 @@ namespace Weathering
 
 
         public override string GetSpriteKeyBedrock(Vector2Int pos) => $"UniverseBackground_{Get(pos).GetTileHashCode() % 16}";
+        public override int GetSpriteIdBedrock(Vector2Int pos) => Res.SpriteIds("UniverseBackground", 16)[Get(pos).GetTileHashCode() % 16];
 
         public const long DefaultInventoryQuantityCapacity = 1000000;
         public const int DefaultInventoryTypeCapacity = 20;
@@ -16,6 +16,7 @@ namespace Weathering
             var items = UI.Ins.GetItems();
 
             if (isGalaxy) {
+                GameEntry.Ins.PrefetchChildMap(typeof(MapOfGalaxy), Map as IMapDefinition, Pos);
                 items.Add(UIItem.CreateButton($"进入{typeof(MapOfGalaxy).Name}#{Pos.x},{Pos.y}", () => {
                     Map.EnterChildMap(Pos);
                 }));
@@ -20,6 +20,13 @@ namespace Weathering
 		public const string InitialMapKey = "Weathering.MapOfPlanet#=1,4=14,93=24,31";
 
 		public const int VersionCode = 20210417;
+
+		// 常驻内存的地图数量和估计内存上限, 见ResidentMaps
+		public static int ResidentMapCapacity = 4;
+		public static long ResidentMapMemoryBudget = 64L * 1024 * 1024;
+
+		// 地图存档的区块是否用Deflate压缩, 读档时两种都能读
+		public static bool CompressSaves = true;
 		public static void OnConstruct(IGlobals globals) {
 
 			// 全局理智
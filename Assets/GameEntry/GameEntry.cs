@@ -58,6 +58,7 @@ namespace Weathering
             // 3. Globals
             // 4. GameEntry
             data = DataPersistence.Ins;
+            residentMaps = new ResidentMaps(GameConfig.ResidentMapCapacity, GameConfig.ResidentMapMemoryBudget, WriteBackEvictedMap);
             globals = (Globals.Ins as IGlobalsDefinition);
             if (globals == null) throw new Exception();
 
@@ -218,28 +219,31 @@ namespace Weathering
             globals.PlayerPreferences[gameEntryMapKey] = mapKey;
 
             // 目前"活跃地图"以"MapView.Ins.Map"访问
-            IMap oldMap = MapView.Ins.TheOnlyActiveMap;
+            // 旧地图留在内存里, 由自动存档或被淘汰时写回, 切换地图时不再存档
             IMapDefinition oldMapDefinition = MapView.Ins.TheOnlyActiveMap as IMapDefinition;
-            if (oldMap != null) {
-                SaveGame(); // 读新图前, 保存
+            if (oldMapDefinition != null) {
+                oldMapDefinition.OnDisable();
             }
+            parentMap = null;
 
-            IMapDefinition map = null;
-            // 正好要进入parentMap
-            if (parentMap != null && parentMap.MapKey.Equals(mapKey)) {
-                map = parentMap;
-            } else {
+            // 常驻地图不用读档
+            bool resident = residentMaps.TryGet(mapKey, out IMapDefinition map);
+            if (!resident) {
                 map = Activator.CreateInstance(selfType) as IMapDefinition;
                 if (map == null) throw new Exception(mapKey);
                 map.MapKey = mapKey;
                 map.HashCode = HashUtility.Hash(mapKey);
             }
-            // 优化, 如果进入子地图, parentMap设置为oldMap
-            parentMap = enterChildMap ? oldMapDefinition : null;
 
 
             MapView.Ins.TheOnlyActiveMap = map;
 
+            if (resident) {
+                map.OnEnable();
+                RedrawMapBody(map);
+                return;
+            }
+
             // 每个IMap实例的MapKey对应一个存档里有这个地图
             if (data.HasMap(mapKey)) {
                 data.LoadMapHead(map, mapKey);
@@ -251,6 +255,7 @@ namespace Weathering
                 ConstructMapBody(map);
                 map.AfterConstructMapBody();
             }
+            residentMaps.Add(map);
 
             // 记录当前地图
 
@@ -263,6 +268,9 @@ namespace Weathering
             string mapKey = map.MapKey;
             if (map.CanDelete) {
                 map.EnterParentMap();
+                residentMaps.Remove(mapKey);
+                if (parentMap == map) parentMap = null;
+                ValueScheduler.CancelAll(map);
                 data.DeleteMap(map);
                 if (enterSelf) {
                     EnterMap(mapKey);
@@ -271,7 +279,45 @@ namespace Weathering
         }
 
 
-        private IMapDefinition parentMap = null;
+        private ResidentMaps residentMaps;
+        private IMapDefinition parentMap = null; // 当前地图的上级地图, 也在residentMaps中
+
+        private void WriteBackEvictedMap(IMapDefinition map) {
+            if (parentMap == map) parentMap = null;
+            ValueScheduler.CancelAll(map);
+            if (!map.HeadSaveDirty && !map.BodySaveDirty) return;
+            data.BeginSave(TimeUtility.GetTicks());
+            if (map.HeadSaveDirty) {
+                data.SaveMapHead(map);
+            }
+            data.SaveMapBodyIncremental(map);
+            data.EndSave();
+        }
+
+        private static void RedrawMapBody(IMapDefinition map) {
+            for (int i = 0; i < map.Width; i++) {
+                for (int j = 0; j < map.Height; j++) {
+                    if (map.IsTileMaterialized(i, j)) {
+                        map.GetTileFast(i, j).NeedUpdateSpriteKeys = true;
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// 可能马上要进入的地图, 在后台预读存档
+        /// </summary>
+        public void PrefetchMap(string mapKey) {
+            if (residentMaps.Contains(mapKey)) return;
+            if (!data.HasMap(mapKey)) return;
+            data.PrefetchMap(mapKey);
+        }
+        public void PrefetchParentMap(Type parentType, IMapDefinition mapDefinition) {
+            PrefetchMap(ConstructParentMapKey(parentType, mapDefinition.MapKey));
+        }
+        public void PrefetchChildMap(Type childType, IMapDefinition mapDefinition, Vector2Int pos) {
+            PrefetchMap($"{childType.FullName}{ConstructMapKeyIndexWithPosition(mapDefinition.MapKey, pos)}");
+        }
 
         public ITile GetParentTile(Type parentType, IMapDefinition mapDefinition) {
             if (mapDefinition != MapView.Ins.TheOnlyActiveMap) throw new Exception();
@@ -286,6 +332,10 @@ namespace Weathering
 
             if (parentMap == null) {
                 string parentMapKey = ConstructParentMapKey(parentType, mapDefinition.MapKey);
+                // 常驻地图不用读档
+                if (residentMaps.TryGet(parentMapKey, out parentMap)) {
+                    return GetParentTile(parentType, mapDefinition);
+                }
 
                 parentMap = Activator.CreateInstance(parentType) as IMapDefinition;
                 if (parentMap == null) throw new Exception(parentType.Name);
@@ -302,6 +352,7 @@ namespace Weathering
                     parentMap.OnEnable();
                     ConstructMapBody(parentMap);
                 }
+                residentMaps.Add(parentMap); // 可能淘汰其他地图, 不会淘汰刚加入的
             } else {
                 if (parentType != parentMap.GetType()) {
                     throw new ArgumentException(parentType.Name);
@@ -313,18 +364,29 @@ namespace Weathering
         }
 
 
-        private void ConstructMapBody(IMapDefinition map) {
+        /// <summary>
+        /// 用默认地块填满地图。只依赖地图本身, 性能测试直接调用
+        /// </summary>
+        public static void ConstructMapBody(IMapDefinition map) {
+            // 默认地块在第一次访问时才创建
+            if (map.SparseDefaultTiles) {
+                map.ConstructSparseDefaultTiles();
+                return;
+            }
+
             Type tileType = map.DefaultTileType;
+            if (tileType == null) throw new Exception();
+            Func<ITileDefinition> tileFactory = TypeRegistry.TileFactory(tileType);
+            uint[] tileHashCodes = new uint[map.Height];
             for (int i = 0; i < map.Width; i++) {
+                HashUtility.HashColumn(i, 0, map.Width, map.Height, (int)map.HashCode, tileHashCodes, 0, map.Height);
                 for (int j = 0; j < map.Height; j++) {
                     // Type tileType = map.GenerateTileType(new Vector2Int(i, j)); // 每个地图自己决定在ij生成什么地块
-                    if (tileType == null) throw new Exception();
-                    ITileDefinition tile = Activator.CreateInstance(tileType) as ITileDefinition;
-                    if (tile == null) throw new Exception(tileType.Name);
+                    ITileDefinition tile = tileFactory();
                     map.SetTile(new Vector2Int(i, j), tile, true);
                     tile.Map = map;
                     tile.Pos = new Vector2Int(i, j);
-                    tile.TileHashCode = HashUtility.Hash(i, j, map.Width, map.Height, (int)map.HashCode); //HashUtility.Hash((uint)(i + j * map.Width));
+                    tile.TileHashCode = tileHashCodes[j]; //HashUtility.Hash((uint)(i + j * map.Width));
                     tile.OnConstruct(null);
                 }
             }
@@ -339,14 +401,10 @@ namespace Weathering
         }
 
 
+        /// <summary>
+        /// 按帧缓存的值用它判断是否过期, 见TimeUtility.GetTicks和MapOfPlanet.Environment
+        /// </summary>
         public long FrameCount { get; private set; } = 1;
-        public static T FrameBuffer<T>(ref T lastValue, ref long lastFrame, Func<T> func) {
-            if (lastFrame != Ins.FrameCount) {
-                lastValue = func();
-                lastFrame = Ins.FrameCount;
-            }
-            return lastValue;
-        }
 
         private long lastSaveTimeInSeconds = 0;
         private IDataPersistence data;
@@ -357,6 +415,7 @@ namespace Weathering
                 SaveGame();
                 lastSaveTimeInSeconds = now;
             }
+            ValueScheduler.Update(TimeUtility.GetTicks()); // 只处理到期的数值事件
             FrameCount++;
         }
 
@@ -371,41 +430,37 @@ namespace Weathering
 
         // 存档
         public void SaveGame() {
-            IMapDefinition map = MapView.Ins.TheOnlyActiveMap as IMapDefinition;
-            if (map == null) throw new Exception();
-            map.OnDisable();
-
-
-            // 开始存档
-            const string save_complete = "__save_complete__";
-            const string incomplete = "incomplete";
+            using (PerformanceCounters.Measure(PerformanceSection.SaveGame)) {
+                IMapDefinition map = MapView.Ins.TheOnlyActiveMap as IMapDefinition;
+                if (map == null) throw new Exception();
+                map.OnDisable();
+
+
+                // 开始存档, 主线程只生成快照, 写文件和损坏校验在存档线程
+                data.BeginSave(TimeUtility.GetTicks());
+
+                // 存档
+                data.SaveGlobals();
+                data.SaveMapHead(map); // 保存地图
+                data.SaveMapBodyIncremental(map); // 只保存修改过的区块
+
+                // 其他常驻地图
+                foreach (var other in residentMaps.Maps) {
+                    if (other == map) continue;
+                    if (other.HeadSaveDirty) {
+                        data.SaveMapHead(other);
+                    }
+                    data.SaveMapBodyIncremental(other);
+                }
 
-            // 损坏校验
-            if (!DataPersistence.Ins.HasSave(save_complete)) {
-                DataPersistence.Ins.WriteSave(save_complete, TimeUtility.GetTicks().ToString());
-            }
-            if (DataPersistence.Ins.ReadSave(save_complete).StartsWith(incomplete)) {
-                throw new Exception("存档损坏");
-            }
-            DataPersistence.Ins.WriteSave(save_complete, $"{incomplete} {TimeUtility.GetTicks()}");
+                lastSaveTimeInSeconds = TimeUtility.GetSeconds();
 
-            // 存档
-            data.SaveGlobals();
-            data.SaveMapHead(map); // 保存地图
-            data.SaveMapBody(map);
+                // 结束存档
+                data.EndSave();
 
-            if (parentMap != null) {
-                data.SaveMapHead(parentMap);
-                data.SaveMapBody(parentMap);
+                // 地块数量可能变了, 重新估计内存
+                residentMaps.Refresh();
             }
-
-            lastSaveTimeInSeconds = TimeUtility.GetSeconds();
-
-            // 结束存档
-            DataPersistence.Ins.WriteSave(save_complete, TimeUtility.GetTicks().ToString());
-#if UNITY_EDITOR
-            Debug.LogWarning("Save OK");
-#endif
         }
 
         // 删除存档
@@ -418,6 +473,7 @@ namespace Weathering
 
         public void ExitGame() {
             SaveGame();
+            data.FlushSaves();
             ExitGameInternal();
         }
 
@@ -0,0 +1,131 @@
+﻿
+using System;
+using System.Collections.Generic;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 常驻内存的地图, 按最近使用排序
+    /// 地图数量超过Capacity, 或估计内存超过MemoryBudget时, 淘汰最久未使用的地图, 正在显示的和最近使用的地图不淘汰
+    /// 淘汰时由onEvict负责把未保存的修改写回存档
+    /// </summary>
+    public class ResidentMaps
+    {
+        // 每个已创建地块的估计内存, 包括Values, Refs, Inventory
+        public const long BytesPerTile = 512;
+        public const long BytesPerCell = 16;
+
+        public int Capacity { get; set; }
+        public long MemoryBudget { get; set; }
+        public long EstimatedBytes { get; private set; }
+
+        private class Entry
+        {
+            public IMapDefinition Map;
+            public long Bytes;
+        }
+        private readonly LinkedList<Entry> recent = new LinkedList<Entry>();
+        private readonly Dictionary<string, LinkedListNode<Entry>> entries = new Dictionary<string, LinkedListNode<Entry>>();
+        private readonly Action<IMapDefinition> onEvict;
+
+        public ResidentMaps(int capacity, long memoryBudget, Action<IMapDefinition> onEvict) {
+            if (capacity < 1) throw new Exception();
+            Capacity = capacity;
+            MemoryBudget = memoryBudget;
+            this.onEvict = onEvict;
+        }
+
+        public int Count => recent.Count;
+
+        public bool Contains(string mapKey) => entries.ContainsKey(mapKey);
+
+        public bool TryGet(string mapKey, out IMapDefinition map) {
+            if (entries.TryGetValue(mapKey, out var node)) {
+                recent.Remove(node);
+                recent.AddFirst(node);
+                map = node.Value.Map;
+                return true;
+            }
+            map = null;
+            return false;
+        }
+
+        /// <summary>
+        /// 新加入的地图视为最近使用
+        /// </summary>
+        public void Add(IMapDefinition map) {
+            if (entries.ContainsKey(map.MapKey)) throw new Exception($"地图已常驻 {map.MapKey}");
+            Entry entry = new Entry { Map = map, Bytes = Estimate(map) };
+            entries.Add(map.MapKey, recent.AddFirst(entry));
+            EstimatedBytes += entry.Bytes;
+            Evict();
+        }
+
+        /// <summary>
+        /// 不写回, 用于删除地图
+        /// </summary>
+        public void Remove(string mapKey) {
+            if (entries.TryGetValue(mapKey, out var node)) {
+                RemoveNode(node);
+            }
+        }
+
+        /// <summary>
+        /// 从最近到最久
+        /// </summary>
+        public IEnumerable<IMapDefinition> Maps {
+            get {
+                foreach (var entry in recent) {
+                    yield return entry.Map;
+                }
+            }
+        }
+
+        /// <summary>
+        /// 地块数量会变化, 存档时重新估计
+        /// </summary>
+        public void Refresh() {
+            EstimatedBytes = 0;
+            foreach (var entry in recent) {
+                entry.Bytes = Estimate(entry.Map);
+                EstimatedBytes += entry.Bytes;
+            }
+            Evict();
+        }
+
+        private void Evict() {
+            LinkedListNode<Entry> node = recent.Last;
+            while (node != null && node != recent.First && (recent.Count > Capacity || EstimatedBytes > MemoryBudget)) {
+                LinkedListNode<Entry> previous = node.Previous;
+                IMapDefinition map = node.Value.Map;
+                if (map != MapView.Ins.TheOnlyActiveMap) {
+                    RemoveNode(node);
+                    onEvict?.Invoke(map);
+                }
+                node = previous;
+            }
+        }
+
+        private void RemoveNode(LinkedListNode<Entry> node) {
+            recent.Remove(node);
+            entries.Remove(node.Value.Map.MapKey);
+            EstimatedBytes -= node.Value.Bytes;
+        }
+
+        public static long Estimate(IMapDefinition map) {
+            int width = map.Width;
+            int height = map.Height;
+            long tiles = 0;
+            if (map.SparseDefaultTiles) {
+                for (int i = 0; i < width; i++) {
+                    for (int j = 0; j < height; j++) {
+                        if (map.IsTileMaterialized(i, j)) tiles++;
+                    }
+                }
+            } else {
+                tiles = (long)width * height;
+            }
+            return tiles * BytesPerTile + (long)width * height * BytesPerCell;
+        }
+    }
+}
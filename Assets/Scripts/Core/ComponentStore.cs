@@ -0,0 +1,481 @@
+﻿
+using System;
+using System.Collections.Generic;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 地图级的组件存储, 可选。地图的UseComponentStore为true时, 地块的Values和Refs存在这里
+    /// 1. 所有值按结构体连续存放在数组里, 以(容器id, 类型id)为键, 不再是每个地块一个字典加一堆小对象
+    /// 2. StoredValues, StoredRefs 是容器视图, 实现IValues, IRefs, 原有地块代码不需要修改
+    /// 3. 存档时直接遍历数组
+    /// </summary>
+    public class ComponentStore
+    {
+        public readonly ComponentTable<ValueState> Values = new ComponentTable<ValueState>();
+        public readonly ComponentTable<RefState> Refs = new ComponentTable<RefState>();
+
+        /// <summary>
+        /// 把普通的Values换成本存储的视图。读档和地块构造时调用, 此时还没有别处持有其中的IValue
+        /// </summary>
+        public IValues Adopt(IValues values) {
+            if (values == null) return null;
+            if (values is StoredValues stored && stored.Store == this) return values;
+            if (!(values is Weathering.Values)) return values;
+            StoredValues result = new StoredValues(this);
+            foreach (var pair in values.Dict) {
+                result.Add(pair.Key, Value.StateOf(pair.Value));
+            }
+            return result;
+        }
+        public IRefs Adopt(IRefs refs) {
+            if (refs == null) return null;
+            if (refs is StoredRefs stored && stored.Store == this) return refs;
+            if (!(refs is Weathering.Refs)) return refs;
+            StoredRefs result = new StoredRefs(this);
+            foreach (var pair in refs.Dict) {
+                result.Add(pair.Key, RefState.Of(pair.Value));
+            }
+            return result;
+        }
+
+        /// <summary>
+        /// 地块被替换后, 释放它占用的槽位
+        /// </summary>
+        public void Release(ITile tile) {
+            (tile.Values as StoredValues)?.Release();
+            (tile.Refs as StoredRefs)?.Release();
+        }
+
+        /// <summary>
+        /// 二进制存档格式与Values.FromBinary, Refs.FromBinary一致, 直接写入数组
+        /// </summary>
+        public IValues ReadValues(System.IO.BinaryReader reader, SaveTypeTable table) {
+            int count = reader.ReadInt32();
+            if (count < 0) return null;
+            StoredValues result = new StoredValues(this);
+            for (int i = 0; i < count; i++) {
+                Type type = table.TypeOf(reader.ReadInt32());
+                result.Add(type, Value.StateFromBinary(reader));
+            }
+            return result;
+        }
+        public IRefs ReadRefs(System.IO.BinaryReader reader, SaveTypeTable table) {
+            int count = reader.ReadInt32();
+            if (count < 0) return null;
+            StoredRefs result = new StoredRefs(this);
+            for (int i = 0; i < count; i++) {
+                Type type = table.TypeOf(reader.ReadInt32());
+                result.Add(type, RefState.FromBinary(reader, table));
+            }
+            return result;
+        }
+    }
+
+    /// <summary>
+    /// 一种结构体的槽位表
+    /// 每个容器是一个整数id, 容器内的槽位用nextSlot串成链表。释放的槽位和id会被复用
+    /// </summary>
+    public class ComponentTable<TState> where TState : struct
+    {
+        public const int None = -1;
+
+        public TState[] Slots { get; private set; } = new TState[64];
+        private int[] slotType = new int[64];
+        private int[] nextSlot = new int[64];
+        private object[] views = new object[64];
+        private int slotCount = 0;
+        private int freeSlot = None;
+        public int Count { get; private set; } = 0;
+
+        private readonly List<int> firstSlotOfOwner = new List<int>();
+        private readonly List<int> countOfOwner = new List<int>();
+        private readonly Stack<int> freeOwners = new Stack<int>();
+
+        private readonly List<Type> types = new List<Type>();
+        private readonly Dictionary<Type, int> typeIds = new Dictionary<Type, int>();
+        private readonly Dictionary<long, int> slotIndex = new Dictionary<long, int>();
+
+        private static long Key(int owner, int typeId) => ((long)owner << 32) | (uint)typeId;
+
+        private int TypeId(Type type) {
+            if (typeIds.TryGetValue(type, out int id)) {
+                return id;
+            }
+            id = types.Count;
+            types.Add(type);
+            typeIds.Add(type, id);
+            return id;
+        }
+
+        public int NewOwner() {
+            if (freeOwners.Count > 0) {
+                int reused = freeOwners.Pop();
+                firstSlotOfOwner[reused] = None;
+                countOfOwner[reused] = 0;
+                return reused;
+            }
+            firstSlotOfOwner.Add(None);
+            countOfOwner.Add(0);
+            return firstSlotOfOwner.Count - 1;
+        }
+        public void ReleaseOwner(int owner) {
+            int slot = firstSlotOfOwner[owner];
+            while (slot != None) {
+                int next = nextSlot[slot];
+                FreeSlot(owner, slot);
+                slot = next;
+            }
+            firstSlotOfOwner[owner] = None;
+            countOfOwner[owner] = 0;
+            freeOwners.Push(owner);
+        }
+
+        public int CountOf(int owner) => countOfOwner[owner];
+        public int FirstOf(int owner) => firstSlotOfOwner[owner];
+        public int NextOf(int slot) => nextSlot[slot];
+        public Type TypeOf(int slot) => types[slotType[slot]];
+
+        public int Find(int owner, Type type) {
+            if (!typeIds.TryGetValue(type, out int typeId)) return None;
+            return slotIndex.TryGetValue(Key(owner, typeId), out int slot) ? slot : None;
+        }
+
+        public int Add(int owner, Type type, TState state) {
+            int typeId = TypeId(type);
+            long key = Key(owner, typeId);
+            if (slotIndex.ContainsKey(key)) throw new Exception("已有：" + type.FullName);
+
+            int slot;
+            if (freeSlot != None) {
+                slot = freeSlot;
+                freeSlot = nextSlot[slot];
+            } else {
+                if (slotCount == Slots.Length) Grow();
+                slot = slotCount++;
+            }
+            Slots[slot] = state;
+            slotType[slot] = typeId;
+            nextSlot[slot] = firstSlotOfOwner[owner];
+            firstSlotOfOwner[owner] = slot;
+            countOfOwner[owner]++;
+            slotIndex.Add(key, slot);
+            Count++;
+            return slot;
+        }
+
+        public bool Remove(int owner, Type type) {
+            int slot = Find(owner, type);
+            if (slot == None) return false;
+            // 从容器链表里摘下
+            int previous = None;
+            for (int current = firstSlotOfOwner[owner]; current != slot; current = nextSlot[current]) {
+                previous = current;
+            }
+            if (previous == None) {
+                firstSlotOfOwner[owner] = nextSlot[slot];
+            } else {
+                nextSlot[previous] = nextSlot[slot];
+            }
+            countOfOwner[owner]--;
+            FreeSlot(owner, slot);
+            return true;
+        }
+
+        private void FreeSlot(int owner, int slot) {
+            slotIndex.Remove(Key(owner, slotType[slot]));
+            if (views[slot] is IComponentView view) view.Detach();
+            views[slot] = null;
+            Slots[slot] = default;
+            nextSlot[slot] = freeSlot;
+            freeSlot = slot;
+            Count--;
+        }
+
+        /// <summary>
+        /// 每个槽位最多创建一个视图, 多次Get得到同一个对象
+        /// </summary>
+        public T ViewOf<T>(int slot, Func<int, T> create) where T : class {
+            T view = views[slot] as T;
+            if (view == null) {
+                view = create(slot);
+                views[slot] = view;
+            }
+            return view;
+        }
+
+        private void Grow() {
+            int size = Slots.Length * 2;
+            TState[] slots = Slots;
+            Array.Resize(ref slots, size);
+            Slots = slots;
+            Array.Resize(ref slotType, size);
+            Array.Resize(ref nextSlot, size);
+            Array.Resize(ref views, size);
+        }
+    }
+
+    internal interface IComponentView
+    {
+        void Detach(); // 槽位被释放
+    }
+
+    public class StoredValue : IValue, IComponentView, IWatchableValue
+    {
+        private readonly ComponentTable<ValueState> table;
+        private readonly ISaveDirty owner;
+        private int slot;
+
+        internal StoredValue(ComponentTable<ValueState> table, int slot, ISaveDirty owner) {
+            this.table = table;
+            this.slot = slot;
+            this.owner = owner;
+        }
+        private ValueState detached;
+        void IComponentView.Detach() {
+            detached = table.Slots[slot];
+            slot = ComponentTable<ValueState>.None;
+        }
+
+        // 值从容器移除后, 与移除的Value对象一样继续可用, 只是不再存档
+        private ref ValueState S {
+            get {
+                if (slot == ComponentTable<ValueState>.None) return ref detached;
+                return ref table.Slots[slot];
+            }
+        }
+        public ValueState State => S;
+
+        bool IWatchableValue.Watched { get => watched; set => watched = value; }
+        private bool watched = false;
+        private void Changed() {
+            owner.MarkSaveDirty();
+            if (watched) ValueScheduler.Reschedule(this);
+        }
+
+        public long Time { get => S.time; set { S.time = value; Changed(); } }
+        public long Max { get => S.max; set { S.SetMax(value); Changed(); } }
+        public long Del { get => S.del; set { S.SetDel(value); Changed(); } }
+        public long Inc { get => S.inc; set { S.SetInc(value); Changed(); } }
+        public long Dec { get => S.dec; set { S.SetDec(value); Changed(); } }
+        public long Sur => S.Sur;
+        public long Val { get => S.Val; set { S.SetVal(value); Changed(); } }
+        public bool Maxed => S.Maxed;
+        public string RemainingTimeString => S.RemainingTimeString;
+        public long ProgressedTicks => S.ProgressedTicks;
+    }
+
+    public class StoredValues : IValues, ISaveDirty, ISaveDirtyOwned
+    {
+        public ComponentStore Store { get; private set; }
+        private ComponentTable<ValueState> table;
+        private int id;
+        private readonly Func<int, StoredValue> createView;
+
+        internal StoredValues(ComponentStore store) {
+            Store = store;
+            table = store.Values;
+            id = table.NewOwner();
+            createView = slot => new StoredValue(table, slot, this);
+        }
+
+        internal void Release() {
+            if (id == ComponentTable<ValueState>.None) return;
+            table.ReleaseOwner(id);
+            id = ComponentTable<ValueState>.None;
+        }
+
+        public ISaveDirty SaveDirtyOwner { get; set; } = null;
+        public void MarkSaveDirty() => SaveDirtyOwner?.MarkSaveDirty();
+
+        internal void Add(Type type, ValueState state) => table.Add(id, type, state);
+
+        public int Count => table.CountOf(id);
+
+        /// <summary>
+        /// 兼容用, 每次生成新的字典。热路径请用Get/Has
+        /// </summary>
+        public Dictionary<Type, IValue> Dict {
+            get {
+                Dictionary<Type, IValue> result = new Dictionary<Type, IValue>();
+                for (int slot = table.FirstOf(id); slot != ComponentTable<ValueState>.None; slot = table.NextOf(slot)) {
+                    result.Add(table.TypeOf(slot), table.ViewOf(slot, createView));
+                }
+                return result;
+            }
+        }
+
+        public int CopyStates(List<Type> types, List<ValueState> states) {
+            int count = 0;
+            for (int slot = table.FirstOf(id); slot != ComponentTable<ValueState>.None; slot = table.NextOf(slot)) {
+                types.Add(table.TypeOf(slot));
+                states.Add(table.Slots[slot]);
+                count++;
+            }
+            return count;
+        }
+
+        public IValue Get(Type type) {
+            int slot = table.Find(id, type);
+            if (slot == ComponentTable<ValueState>.None) throw new Exception(type.Name);
+            return table.ViewOf(slot, createView);
+        }
+        public IValue Get<T>() => Get(typeof(T));
+
+        public IValue Create(Type type) {
+            if (table.Find(id, type) != ComponentTable<ValueState>.None) throw new Exception();
+            int slot = table.Add(id, type, ValueState.Create(0, 0, 0, 0, 0, TimeUtility.GetTicks()));
+            MarkSaveDirty();
+            return table.ViewOf(slot, createView);
+        }
+        public IValue Create<T>() => Create(typeof(T));
+
+        public IValue GetOrCreate(Type type) {
+            int slot = table.Find(id, type);
+            if (slot != ComponentTable<ValueState>.None) return table.ViewOf(slot, createView);
+            slot = table.Add(id, type, ValueState.Create(0, 0, 0, 0, 0, TimeUtility.GetTicks()));
+            MarkSaveDirty();
+            return table.ViewOf(slot, createView);
+        }
+        public IValue GetOrCreate<T>() => GetOrCreate(typeof(T));
+
+        public bool Has(Type type) => table.Find(id, type) != ComponentTable<ValueState>.None;
+        public bool Has<T>() => Has(typeof(T));
+
+        public bool Remove(Type type) {
+            if (table.Remove(id, type)) {
+                MarkSaveDirty();
+                return true;
+            }
+            return false;
+        }
+        public bool Remove<T>() => Remove(typeof(T));
+    }
+
+    public class StoredRef : IRef, IComponentView
+    {
+        private readonly ComponentTable<RefState> table;
+        private readonly ISaveDirty owner;
+        private int slot;
+
+        internal StoredRef(ComponentTable<RefState> table, int slot, ISaveDirty owner) {
+            this.table = table;
+            this.slot = slot;
+            this.owner = owner;
+        }
+        private RefState detached;
+        void IComponentView.Detach() {
+            detached = table.Slots[slot];
+            slot = ComponentTable<RefState>.None;
+        }
+
+        private ref RefState S {
+            get {
+                if (slot == ComponentTable<RefState>.None) return ref detached;
+                return ref table.Slots[slot];
+            }
+        }
+
+        public Type Type { get => S.type; set { S.type = value; owner.MarkSaveDirty(); } }
+        public long BaseValue { get => S.baseValue; set { S.baseValue = value; owner.MarkSaveDirty(); } }
+        public long Value { get => S.value; set { S.value = value; owner.MarkSaveDirty(); } }
+        public Type Left { get => S.left; set { S.left = value; owner.MarkSaveDirty(); } }
+        public Type Right { get => S.right; set { S.right = value; owner.MarkSaveDirty(); } }
+        public long X { get => S.x; set { S.x = value; owner.MarkSaveDirty(); } }
+        public long Y { get => S.y; set { S.y = value; owner.MarkSaveDirty(); } }
+    }
+
+    public class StoredRefs : IRefs, ISaveDirty, ISaveDirtyOwned
+    {
+        public ComponentStore Store { get; private set; }
+        private ComponentTable<RefState> table;
+        private int id;
+        private readonly Func<int, StoredRef> createView;
+
+        internal StoredRefs(ComponentStore store) {
+            Store = store;
+            table = store.Refs;
+            id = table.NewOwner();
+            createView = slot => new StoredRef(table, slot, this);
+        }
+
+        internal void Release() {
+            if (id == ComponentTable<RefState>.None) return;
+            table.ReleaseOwner(id);
+            id = ComponentTable<RefState>.None;
+        }
+
+        public ISaveDirty SaveDirtyOwner { get; set; } = null;
+        public void MarkSaveDirty() => SaveDirtyOwner?.MarkSaveDirty();
+
+        internal void Add(Type type, RefState state) => table.Add(id, type, state);
+
+        public int Count => table.CountOf(id);
+
+        /// <summary>
+        /// 兼容用, 每次生成新的字典。热路径请用Get/TryGet
+        /// </summary>
+        public Dictionary<Type, IRef> Dict {
+            get {
+                Dictionary<Type, IRef> result = new Dictionary<Type, IRef>();
+                for (int slot = table.FirstOf(id); slot != ComponentTable<RefState>.None; slot = table.NextOf(slot)) {
+                    result.Add(table.TypeOf(slot), table.ViewOf(slot, createView));
+                }
+                return result;
+            }
+        }
+
+        public int CopyStates(List<Type> types, List<RefState> states) {
+            int count = 0;
+            for (int slot = table.FirstOf(id); slot != ComponentTable<RefState>.None; slot = table.NextOf(slot)) {
+                types.Add(table.TypeOf(slot));
+                states.Add(table.Slots[slot]);
+                count++;
+            }
+            return count;
+        }
+
+        public IRef Get(Type type) {
+            int slot = table.Find(id, type);
+            if (slot == ComponentTable<RefState>.None) throw new Exception(type.Name);
+            return table.ViewOf(slot, createView);
+        }
+        public IRef Get<T>() => Get(typeof(T));
+
+        public bool TryGet(Type type, out IRef result) {
+            int slot = table.Find(id, type);
+            result = slot == ComponentTable<RefState>.None ? null : table.ViewOf(slot, createView);
+            return result != null;
+        }
+        public bool TryGet<T>(out IRef result) => TryGet(typeof(T), out result);
+
+        public IRef Create(Type type) {
+            if (table.Find(id, type) != ComponentTable<RefState>.None) throw new Exception("已有：" + type.FullName);
+            int slot = table.Add(id, type, default);
+            MarkSaveDirty();
+            return table.ViewOf(slot, createView);
+        }
+        public IRef Create<T>() => Create(typeof(T));
+
+        public IRef GetOrCreate(Type type) {
+            int slot = table.Find(id, type);
+            if (slot != ComponentTable<RefState>.None) return table.ViewOf(slot, createView);
+            slot = table.Add(id, type, default);
+            MarkSaveDirty();
+            return table.ViewOf(slot, createView);
+        }
+        public IRef GetOrCreate<T>() => GetOrCreate(typeof(T));
+
+        public bool Has(Type type) => table.Find(id, type) != ComponentTable<RefState>.None;
+        public bool Has<T>() => Has(typeof(T));
+
+        public void Remove(Type type) {
+            if (table.Remove(id, type)) {
+                MarkSaveDirty();
+                return;
+            }
+            throw new Exception(type.FullName);
+        }
+        public void Remove<T>() => Remove(typeof(T));
+    }
+}
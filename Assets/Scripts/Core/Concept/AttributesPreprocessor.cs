@@ -55,7 +55,6 @@ namespace Weathering
 
         //public readonly Dictionary<Type, Dictionary<Attribute, object>> Data
         //    = new Dictionary<Type, Dictionary<Attribute, object>>();
-        private readonly Dictionary<Type, DependAttribute> DependAttribute = new Dictionary<Type, DependAttribute>(); // 缓存
         public readonly List<Type> DependAttributeList = new List<Type>(); // 排序表
         public readonly Dictionary<Type, int> IndexDict = new Dictionary<Type, int>(); // 排序表, 逆序
         public readonly Dictionary<Type, HashSet<Type>> FinalResult = new Dictionary<Type, HashSet<Type>>(); // 一个类Depend的所有其他类
@@ -64,6 +63,15 @@ namespace Weathering
         public readonly Dictionary<Type, HashSet<Type>> FinalResultInversed = new Dictionary<Type, HashSet<Type>>(); // FinalResult的逆映射
         public readonly Dictionary<Type, List<Type>> FinalResultInversedSorted = new Dictionary<Type, List<Type>>(); // FinalResult的逆映射
 
+        /// <summary>
+        /// 按IndexDict的下标存储的结果, 概念类型的下标是稠密的
+        /// ClosureBits第i行的第j位表示 DependAttributeList[i] 依赖 DependAttributeList[j]
+        /// </summary>
+        public int ClosureStride { get; private set; } // 每行的ulong个数
+        public ulong[] ClosureBits { get; private set; }
+        public List<Type>[] FinalResultSortedByIndex { get; private set; }
+        public List<Type>[] FinalResultInversedSortedByIndex { get; private set; }
+
         /// <summary>
         /// DependAttribute 构成的偏序关系就存在这里了
         /// </summary>
@@ -75,12 +83,56 @@ namespace Weathering
         //}
 
         public static AttributesPreprocessor Ins { get; private set; }
+
+        // 预编译的依赖表, 在Resources/Concept/depend_table.bytes, 打包前由ConceptTableBuilder重新编译。编辑器里总是反射, 修改后不用重新编译
+        public const string CompiledTablePath = "Concept/depend_table";
+        public const int CompiledTableMagic = 0x57445450; // 文件头
+        public const int CompiledTableVersion = 2; // v2: 依赖声明的哈希
+
         private void Awake() {
             if (Ins != null) {
                 throw new Exception();
             }
             Ins = this;
 
+#if !UNITY_EDITOR
+            // 发布版本不反射, 表由打包前的ConceptTableBuilder编译, 过期检查也在那里
+            TextAsset compiled = Resources.Load<TextAsset>(CompiledTablePath);
+            if (compiled != null) {
+                bool loaded = TryLoadCompiledTable(compiled.bytes);
+                Resources.UnloadAsset(compiled);
+                if (loaded) {
+                    BuildTables();
+                    return;
+                }
+                Debug.LogWarning("概念依赖表版本不一致, 改为反射");
+            }
+#endif
+            List<Type> declared = new List<Type>();
+            Dictionary<Type, DependAttribute> attributes = Scan(declared);
+#if UNITY_EDITOR
+            // 编辑器里总是反射, 顺便提示Resources里的表已过期
+            TextAsset existing = Resources.Load<TextAsset>(CompiledTablePath);
+            if (existing != null) {
+                if (!IsCompiledFrom(existing.bytes, attributes)) Debug.LogWarning("概念依赖表已过期, 打包时会重新编译");
+                Resources.UnloadAsset(existing);
+            }
+#endif
+            Reflect(attributes, declared, out ulong[] bits);
+            DependAttributeList.AddRange(declared);
+            for (int i = 0; i < DependAttributeList.Count; i++) {
+                IndexDict.Add(DependAttributeList[i], i);
+            }
+            ClosureStride = (DependAttributeList.Count + 63) / 64;
+            ClosureBits = bits;
+            BuildTables();
+        }
+
+        /// <summary>
+        /// 查找所有 DependAttribute, 类型按找到的顺序加入DependAttributeList
+        /// </summary>
+        private static Dictionary<Type, DependAttribute> Scan(List<Type> DependAttributeList) {
+            Dictionary<Type, DependAttribute> DependAttribute = new Dictionary<Type, DependAttribute>();
             Assembly assembly = Assembly.GetExecutingAssembly();
 
             // 下面这段代码暂时用不到, 先注释掉了
@@ -124,6 +176,31 @@ namespace Weathering
                     }
                 }
             }
+            return DependAttribute;
+        }
+
+        /// <summary>
+        /// 依赖声明的哈希, 与类型的查找顺序无关。增删概念或修改依赖后, 旧的预编译表哈希不一致
+        /// </summary>
+        private static uint DeclarationHash(Dictionary<Type, DependAttribute> DependAttribute) {
+            List<string> lines = new List<string>();
+            List<string> names = new List<string>();
+            foreach (var pair in DependAttribute) {
+                names.Clear();
+                foreach (var dependee in pair.Value.Set) {
+                    names.Add(dependee.FullName);
+                }
+                names.Sort(StringComparer.Ordinal);
+                lines.Add($"{pair.Key.FullName}:{string.Join(",", names)}");
+            }
+            lines.Sort(StringComparer.Ordinal);
+            return HashUtility.Hash(string.Join("\n", lines));
+        }
+
+        /// <summary>
+        /// 把Scan的结果按依赖关系排序, 并计算依赖关系的传递闭包
+        /// </summary>
+        private static void Reflect(Dictionary<Type, DependAttribute> DependAttribute, List<Type> DependAttributeList, out ulong[] ClosureBits) {
 
             // 所有被依赖的都应该也有DependAttribute
             foreach (var pair in DependAttribute) {
@@ -134,7 +211,9 @@ namespace Weathering
                 }
             }
 
-            // 这里效率太低, 需要优化。建议预编译
+            bool Depend(Type type1, Type type2) => DependAttribute[type1].Set.Contains(type2);
+
+            // 这里效率太低, 发布版本使用预编译的结果
             for (int k = 0; k < DependAttributeList.Count; k++) {
                 bool changed = false;
                 for (int i = 0; i < DependAttributeList.Count; i++) {
@@ -164,56 +243,55 @@ namespace Weathering
                 }
             }
 
-            // 记录下标, 缓存
+            // 记录下标
+            Dictionary<Type, int> IndexDict = new Dictionary<Type, int>();
             for (int i = 0; i < DependAttributeList.Count; i++) {
                 IndexDict.Add(DependAttributeList[i], i);
             }
 
-            // 对于每个元素
-            for (int i = 0; i < DependAttributeList.Count; i++) {
-                Type subclass = DependAttributeList[i];
-                var set = new HashSet<Type>();
-                FinalResult.Add(subclass, set);
-                // 的依赖元素（在数组左边
-                DependAttribute attribute = DependAttribute[subclass];
-                foreach (var superclass in attribute.Set) {
-                    if (!set.Contains(superclass)) {
-                        set.Add(superclass);
-                        var superclasses = FinalResult[superclass];
-                        foreach (var superclassOfSuperclass in superclasses) {
-                            if (!set.Contains(superclassOfSuperclass)) {
-                                set.Add(superclassOfSuperclass);
-                            }
-                        }
+            // 对于每个元素, 被依赖的元素都在左边, 依赖闭包已经算好
+            int count = DependAttributeList.Count;
+            int stride = (count + 63) / 64;
+            ClosureBits = new ulong[stride * count];
+            for (int i = 0; i < count; i++) {
+                int row = i * stride;
+                foreach (var superclass in DependAttribute[DependAttributeList[i]].Set) {
+                    int j = IndexDict[superclass];
+                    ClosureBits[row + (j >> 6)] |= 1UL << (j & 63);
+                    int superRow = j * stride;
+                    for (int k = 0; k < stride; k++) {
+                        ClosureBits[row + k] |= ClosureBits[superRow + k];
                     }
                 }
             }
+        }
 
-            // 制造FinalResultSorted
-            foreach (var pair in FinalResult) {
-                Type type = pair.Key;
-                var list = new List<Type>(pair.Value);
-                list.Sort(this); // 用到了IComparer<Type>
-                FinalResultSorted.Add(type, list);
-            }
-
-            // 制造制造FinalResultInversed
-            foreach (var pair in FinalResult) {
-                FinalResultInversed.Add(pair.Key, new HashSet<Type>());
+        /// <summary>
+        /// 由DependAttributeList, IndexDict, ClosureBits生成其余的表
+        /// </summary>
+        private void BuildTables() {
+            int count = DependAttributeList.Count;
+            FinalResultSortedByIndex = new List<Type>[count];
+            FinalResultInversedSortedByIndex = new List<Type>[count];
+            for (int i = 0; i < count; i++) {
+                FinalResultSortedByIndex[i] = new List<Type>();
+                FinalResultInversedSortedByIndex[i] = new List<Type>();
             }
-            foreach (var pair in FinalResult) {
-                Type subclass = pair.Key;
-                foreach (var superclass in pair.Value) {
-                    FinalResultInversed[superclass].Add(subclass);
+            // 按下标顺序遍历, 结果即按依赖关系排序
+            for (int i = 0; i < count; i++) {
+                int row = i * ClosureStride;
+                for (int j = 0; j < count; j++) {
+                    if ((ClosureBits[row + (j >> 6)] & (1UL << (j & 63))) == 0) continue;
+                    FinalResultSortedByIndex[i].Add(DependAttributeList[j]);
+                    FinalResultInversedSortedByIndex[j].Add(DependAttributeList[i]);
                 }
             }
-
-            // 制造制造FinalResultInversedSorted
-            foreach (var pair in FinalResultInversed) {
-                Type type = pair.Key;
-                var list = new List<Type>(pair.Value);
-                list.Sort(this);
-                FinalResultInversedSorted.Add(type, list);
+            for (int i = 0; i < count; i++) {
+                Type type = DependAttributeList[i];
+                FinalResultSorted.Add(type, FinalResultSortedByIndex[i]);
+                FinalResult.Add(type, new HashSet<Type>(FinalResultSortedByIndex[i]));
+                FinalResultInversedSorted.Add(type, FinalResultInversedSortedByIndex[i]);
+                FinalResultInversed.Add(type, new HashSet<Type>(FinalResultInversedSortedByIndex[i]));
             }
 
             // // 用于测试是否成功
@@ -225,8 +303,86 @@ namespace Weathering
             //}
         }
 
-        private bool Depend(Type type1, Type type2) {
-            return DependAttribute[type1].Set.Contains(type2);
+        public static byte[] CompileTable() {
+            List<Type> list = new List<Type>();
+            Dictionary<Type, DependAttribute> attributes = Scan(list);
+            Reflect(attributes, list, out ulong[] bits);
+            using (var stream = new System.IO.MemoryStream())
+            using (var writer = new System.IO.BinaryWriter(stream)) {
+                writer.Write(CompiledTableMagic);
+                writer.Write(CompiledTableVersion);
+                writer.Write(DeclarationHash(attributes));
+                writer.Write(list.Count);
+                foreach (var type in list) {
+                    writer.Write(type.FullName);
+                }
+                foreach (var bit in bits) {
+                    writer.Write(bit);
+                }
+                writer.Flush();
+                return stream.ToArray();
+            }
+        }
+
+        /// <summary>
+        /// 表是否由当前的依赖声明编译。需要扫描全部类型, 只在编辑器和打包时使用
+        /// </summary>
+        private static bool IsCompiledFrom(byte[] bytes, Dictionary<Type, DependAttribute> attributes) {
+            using (var reader = new System.IO.BinaryReader(new System.IO.MemoryStream(bytes))) {
+                if (reader.ReadInt32() != CompiledTableMagic) return false;
+                if (reader.ReadInt32() != CompiledTableVersion) return false;
+                return reader.ReadUInt32() == DeclarationHash(attributes);
+            }
+        }
+
+        /// <summary>
+        /// 版本不一致或找不到类型时返回false, 不修改任何表。不检查依赖声明的哈希, 否则需要扫描全部类型
+        /// </summary>
+        private bool TryLoadCompiledTable(byte[] bytes) {
+            using (var reader = new System.IO.BinaryReader(new System.IO.MemoryStream(bytes))) {
+                if (reader.ReadInt32() != CompiledTableMagic) throw new Exception("概念依赖表格式错误");
+                if (reader.ReadInt32() != CompiledTableVersion) return false;
+                reader.ReadUInt32(); // 依赖声明的哈希
+                int count = reader.ReadInt32();
+                Type[] types = new Type[count];
+                for (int i = 0; i < count; i++) {
+                    string name = reader.ReadString();
+                    types[i] = TypeRegistry.Find(name);
+                    if (types[i] == null) return false;
+                }
+                for (int i = 0; i < count; i++) {
+                    DependAttributeList.Add(types[i]);
+                    IndexDict.Add(types[i], i);
+                }
+                ClosureStride = (count + 63) / 64;
+                ClosureBits = new ulong[ClosureStride * count];
+                for (int i = 0; i < ClosureBits.Length; i++) {
+                    ClosureBits[i] = reader.ReadUInt64();
+                }
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// 编译依赖表到Resources, 已有的表过期时提示。打包前ConceptTableBuilder自动调用
+        /// </summary>
+        public static void CompileTableToResources() {
+            // editor only script. 只在unity编辑器下使用
+            string path = $"Assets/Resources/{CompiledTablePath}.bytes";
+            if (System.IO.File.Exists(path) && !IsCompiledFrom(System.IO.File.ReadAllBytes(path), Scan(new List<Type>()))) {
+                Debug.LogWarning($"概念依赖表已过期, 重新编译 {path}");
+            }
+            System.IO.Directory.CreateDirectory(System.IO.Path.GetDirectoryName(path));
+            System.IO.File.WriteAllBytes(path, CompileTable());
+#if UNITY_EDITOR
+            UnityEditor.AssetDatabase.Refresh();
+#endif
+        }
+
+        [ContextMenu("编译概念依赖表")]
+        private void CompileTableFromMenu() {
+            CompileTableToResources();
+            Debug.LogWarning("OK");
         }
 
         public int Compare(Type x, Type y) {
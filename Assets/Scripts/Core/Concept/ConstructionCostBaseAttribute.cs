@@ -35,7 +35,10 @@ namespace Weathering
             }
             return (attr.CostType, attr.CostQuantity);
         }
-        public static CostInfo GetCost(Type type, IMap map, bool forConstruction) {
+        /// <summary>
+        /// countOffset: 假设同类建筑数量再多几个, 用于一次建造多个时计算后面的费用
+        /// </summary>
+        public static CostInfo GetCost(Type type, IMap map, bool forConstruction, long countOffset = 0) {
             CostInfo result = new CostInfo();
             ConstructionCostBaseAttribute attr = Tag.GetAttribute<ConstructionCostBaseAttribute>(type);
             if (attr == null) {
@@ -43,13 +46,13 @@ namespace Weathering
             }
             result.CostType = attr.CostType;
             result.BaseCostQuantity = attr.CostQuantity;
-            result.CostMultiplier = GetCostMultiplier(type, map, forConstruction, attr.CountForDoubleCost);
+            result.CostMultiplier = GetCostMultiplier(type, map, forConstruction, attr.CountForDoubleCost, countOffset);
             result.RealCostQuantity = attr.CostQuantity * result.CostMultiplier;
             result.CountForDoubleCost = attr.CountForDoubleCost;
             return result;
         }
-        public static long GetCostMultiplier(Type type, IMap map, bool forConstruction, long countForDoubleCost) {
-            long count = map.Refs.GetOrCreate(type).Value; // Map.Ref.Get<建筑>.Value, 为建筑数量。Map.Ref.Get<资源>.Value, 为资源产量
+        public static long GetCostMultiplier(Type type, IMap map, bool forConstruction, long countForDoubleCost, long countOffset = 0) {
+            long count = map.Refs.GetOrCreate(type).Value + countOffset; // Map.Ref.Get<建筑>.Value, 为建筑数量。Map.Ref.Get<资源>.Value, 为资源产量
             if (!forConstruction) {
                 // 计算拆除返还费用, 与建筑费用有1count的差距。如count为10时, 建筑费用增加, 拆除费用不变
                 count--;
@@ -54,16 +54,25 @@ namespace Weathering
 
         public string[] SupporttedLanguages;
 
-        [SerializeField]
-        private TextAsset[] Jsons;
-        private Dictionary<string, string> Dict;
-        private Dictionary<string, string> DictOfDescription;
+        // 本地化json, 文件名以语言开头。只在编辑器里读取, 不被预制体引用, 因此不会打包
+        public const string JsonFolder = "Assets/Text/Localization";
+
+        // 编译后的本地化表, 在Resources/Localization/语言.bytes, 打包前由ConceptTableBuilder重新编译。编辑器里直接读json, 修改后不用重新编译
+        public const string CompiledTablePath = "Localization/";
+        private LocalizationTable table;
+        // 第一次查找时才读取当前语言
+        private LocalizationTable Table {
+            get {
+                if (table == null) table = LoadActiveLanguage();
+                return table;
+            }
+        }
 
         public string Get<T>() {
             return Get(typeof(T));
         }
         public string Get(Type key) {
-            if (Dict.TryGetValue(key.FullName, out string result)) {
+            if (Table.TryGet(key, out string result)) {
                 // throw new Exception($"localization key not found: {key}");
                 // return string.Format(result, "");
                 return result;
@@ -75,7 +84,7 @@ namespace Weathering
         }
 
         public string TryGet(Type key) {
-            if (Dict.TryGetValue(key.FullName, out string result)) {
+            if (Table.TryGet(key, out string result)) {
                 // throw new Exception($"localization key not found: {key}");
                 // return string.Format(result, "");
                 return result;
@@ -89,10 +98,7 @@ namespace Weathering
 
         public const string DescriptionSuffix = "#Description";
         public string GetDescription(Type key) {
-            if (DictOfDescription.TryGetValue(key.FullName, out string result)) {
-                return result;
-            }
-            return null;
+            return Table.GetDescription(key);
         }
 
 
@@ -100,8 +106,8 @@ namespace Weathering
             return ValUnit(typeof(T));
         }
         public string ValUnit(Type key) {
-            if (Dict.TryGetValue(key.FullName, out string result)) {
-                return string.Format(result, "");
+            if (Table.TryFormat(key, "", out string result)) {
+                return result;
             }
             return key.FullName;
         }
@@ -113,15 +119,9 @@ namespace Weathering
         }
         public string Val(Type key, long val) {
             if (key == null) throw new Exception();
-            if (Dict.TryGetValue(key.FullName, out string result)) {
+            if (Table.TryFormat(key, val > 0 ? $" {val}" : (val < 0 ? $"-{-val}" : " 0"), out string result)) {
                 // throw new Exception($"localization key not found: {key}");
-                if (val > 0) {
-                    return string.Format(result, $" {val}");
-                } else if (val < 0) {
-                    return string.Format(result, $"-{-val}");
-                } else {
-                    return string.Format(result, " 0");
-                }
+                return result;
             }
             return key.FullName;
         }
@@ -129,15 +129,9 @@ namespace Weathering
             return ValPlus(typeof(T), val);
         }
         public string ValPlus(Type key, long val) {
-            if (Dict.TryGetValue(key.FullName, out string result)) {
+            if (Table.TryFormat(key, val > 0 ? $"+{val}" : (val < 0 ? $"-{-val}" : " 0"), out string result)) {
                 // throw new Exception($"localization key not found: {key}");
-                if (val > 0) {
-                    return string.Format(result, $"+{val}");
-                } else if (val < 0) {
-                    return string.Format(result, $"-{-val}");
-                } else {
-                    return string.Format(result, " 0");
-                }
+                return result;
             }
             return key.FullName;
         }
@@ -146,53 +140,59 @@ namespace Weathering
             return Inc(typeof(T), val);
         }
         public string Inc(Type key, long val) {
-            if (Dict.TryGetValue(key.FullName, out string result)) {
+            if (Table.TryFormat(key, val > 0 ? $" Δ{val}" : (val < 0 ? $"-Δ{-val}" : " 0"), out string result)) {
                 // throw new Exception($"localization key not found: {key}");
-                if (val > 0) {
-                    return string.Format(result, $" Δ{val}");
-                } else if (val < 0) {
-                    return string.Format(result, $"-Δ{-val}");
-                } else {
-                    return string.Format(result, " 0");
-                }
+                return result;
             }
             return key.FullName;
         }
 
         public void SyncActiveLanguage() {
             string activeLanguage = Globals.Ins.PlayerPreferences[ACTIVE_LANGUAGE];
-            bool found = false;
+            if (Array.IndexOf(SupporttedLanguages, activeLanguage) < 0) {
+                throw new Exception(activeLanguage);
+            }
+            table = null;
+        }
 
-            Dict = new Dictionary<string, string>();
-            DictOfDescription = new Dictionary<string, string>();
-            foreach (var jsonTextAsset in Jsons) {
-                if (jsonTextAsset.name.StartsWith(activeLanguage)) {
-                    Dictionary<string, string> subDict = Newtonsoft.Json.JsonConvert.DeserializeObject<Dictionary<string, string>>(jsonTextAsset.text);
-                    foreach (var pair in subDict) {
-                        if (Dict.ContainsKey(pair.Key)) {
-                            UIPreset.Throw($"出现了重复的key “{pair.Key}” in {jsonTextAsset.name}. 不知道另一个key在哪个文件");
-                        }
-                        else {
-                            int indexOfHashMark = pair.Key.IndexOf('#');
-                            if (indexOfHashMark < 0) {
-                                Dict.Add(pair.Key, pair.Value);
-                            } 
-                            else {
-                                string typeName = pair.Key.Substring(0, indexOfHashMark);
-                                //if (DictOfDescription.ContainsKey(typeName)) {
-                                //    Debug.LogError(typeName);
-                                //}
-                                DictOfDescription.Add(typeName, pair.Value);
-                            }
-                        }
-                    }
-                    found = true;
-                }
+        private LocalizationTable LoadActiveLanguage() {
+            string activeLanguage = Globals.Ins.PlayerPreferences[ACTIVE_LANGUAGE];
+#if UNITY_EDITOR
+            return LocalizationTable.Load(LocalizationTable.Compile(JsonsOf(activeLanguage)));
+#else
+            // 发布版本里没有json, 表在打包前编译
+            TextAsset compiled = Resources.Load<TextAsset>(CompiledTablePath + activeLanguage);
+            if (compiled == null) throw new Exception($"缺少本地化表 {activeLanguage}");
+            LocalizationTable result = LocalizationTable.Load(compiled.bytes);
+            Resources.UnloadAsset(compiled);
+            return result;
+#endif
+        }
+
+#if UNITY_EDITOR
+        private static IEnumerable<ValueTuple<string, string>> JsonsOf(string language) {
+            List<TextAsset> jsons = new List<TextAsset>();
+            foreach (var guid in UnityEditor.AssetDatabase.FindAssets("t:TextAsset", new string[] { JsonFolder })) {
+                TextAsset jsonTextAsset = UnityEditor.AssetDatabase.LoadAssetAtPath<TextAsset>(UnityEditor.AssetDatabase.GUIDToAssetPath(guid));
+                if (jsonTextAsset != null && jsonTextAsset.name.StartsWith(language)) jsons.Add(jsonTextAsset);
             }
-            if (!found) {
-                throw new Exception(activeLanguage);
+            // 按文件名排序, 编译结果与AssetDatabase的顺序无关
+            jsons.Sort((a, b) => string.CompareOrdinal(a.name, b.name));
+            foreach (var jsonTextAsset in jsons) {
+                yield return (jsonTextAsset.name, jsonTextAsset.text);
+            }
+        }
+
+        [ContextMenu("编译本地化表")]
+        public void CompileTables() {
+            string directory = "Assets/Resources/" + CompiledTablePath;
+            if (!System.IO.Directory.Exists(directory)) System.IO.Directory.CreateDirectory(directory);
+            foreach (var language in SupporttedLanguages) {
+                System.IO.File.WriteAllBytes(directory + language + ".bytes", LocalizationTable.Compile(JsonsOf(language)));
             }
+            UnityEditor.AssetDatabase.Refresh();
         }
+#endif
 
         public void SwitchNextLanguage() {
             if (SupporttedLanguages.Length == 1) {
@@ -214,13 +214,11 @@ namespace Weathering
             }
             if (!found) throw new Exception();
             index++;
-            if (index == Jsons.Length) {
+            if (index == SupporttedLanguages.Length) {
                 index = 0;
             }
 
-            // Dict = Newtonsoft.Json.JsonConvert.DeserializeObject<Dictionary<string, string>>(Jsons[index].text);
-
-            Globals.Ins.PlayerPreferences[ACTIVE_LANGUAGE] = Jsons[index].name;
+            Globals.Ins.PlayerPreferences[ACTIVE_LANGUAGE] = SupporttedLanguages[index];
             SyncActiveLanguage();
         }
 
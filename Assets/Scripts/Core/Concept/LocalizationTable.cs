@@ -0,0 +1,162 @@
+﻿
+using System;
+using System.Collections.Generic;
+using System.IO;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 一种语言编译后的本地化表
+    /// 1. 编译时合并该语言所有json, 检查重复key, 拆出描述(key#Description), 按key排序写成二进制
+    /// 2. 读取时key一次性换成Type, 之后按Type查找, 不再对字符串求哈希
+    /// 3. 只含一个{0}的文本预先拆成前后两段, Val等方法直接拼接, 不必每次string.Format
+    /// </summary>
+    public class LocalizationTable
+    {
+        public const int Magic = 0x574c4f43; // 文件头
+        public const int Version = 1;
+
+        private enum TemplateKind : byte
+        {
+            Plain, // 没有花括号, 格式化结果即原文
+            Single, // 只有一个{0}
+            Complex, // 其他情况, 仍用string.Format
+        }
+
+        private struct Entry
+        {
+            public string Text;
+            public string Description;
+            public TemplateKind Kind;
+            public string Prefix;
+            public string Suffix;
+        }
+
+        private readonly Dictionary<Type, int> ids = new Dictionary<Type, int>();
+        private Entry[] entries;
+
+        public int Count => entries.Length;
+
+        /// <summary>
+        /// 把同一语言的多个json编译为二进制
+        /// </summary>
+        public static byte[] Compile(IEnumerable<ValueTuple<string, string>> namedJsons) {
+            SortedDictionary<string, string> texts = new SortedDictionary<string, string>(StringComparer.Ordinal);
+            Dictionary<string, string> descriptions = new Dictionary<string, string>();
+            foreach (var namedJson in namedJsons) {
+                Dictionary<string, string> subDict = Newtonsoft.Json.JsonConvert.DeserializeObject<Dictionary<string, string>>(namedJson.Item2);
+                foreach (var pair in subDict) {
+                    int indexOfHashMark = pair.Key.IndexOf('#');
+                    if (indexOfHashMark < 0) {
+                        if (texts.ContainsKey(pair.Key)) throw new Exception($"出现了重复的key “{pair.Key}” in {namedJson.Item1}. 不知道另一个key在哪个文件");
+                        texts.Add(pair.Key, pair.Value);
+                    } else {
+                        string typeName = pair.Key.Substring(0, indexOfHashMark);
+                        if (descriptions.ContainsKey(typeName)) throw new Exception($"出现了重复的key “{pair.Key}” in {namedJson.Item1}. 不知道另一个key在哪个文件");
+                        descriptions.Add(typeName, pair.Value);
+                        if (!texts.ContainsKey(typeName)) texts.Add(typeName, null); // 只有描述的key, 文本为null
+                    }
+                }
+            }
+
+            using (MemoryStream stream = new MemoryStream())
+            using (BinaryWriter writer = new BinaryWriter(stream)) {
+                writer.Write(Magic);
+                writer.Write(Version);
+                writer.Write(texts.Count);
+                foreach (var pair in texts) {
+                    writer.Write(pair.Key);
+                    WriteNullable(writer, pair.Value);
+                    WriteNullable(writer, descriptions.TryGetValue(pair.Key, out string description) ? description : null);
+                }
+                writer.Flush();
+                return stream.ToArray();
+            }
+        }
+
+        public static LocalizationTable Load(byte[] bytes) {
+            LocalizationTable table = new LocalizationTable();
+            using (BinaryReader reader = new BinaryReader(new MemoryStream(bytes))) {
+                if (reader.ReadInt32() != Magic) throw new Exception("本地化表格式错误");
+                if (reader.ReadInt32() != Version) throw new Exception("本地化表版本不一致, 需要重新编译");
+                int count = reader.ReadInt32();
+                List<Entry> entries = new List<Entry>(count);
+                for (int i = 0; i < count; i++) {
+                    string key = reader.ReadString();
+                    string text = ReadNullable(reader);
+                    string description = ReadNullable(reader);
+                    Type type = TypeRegistry.Find(key);
+                    if (type == null) continue; // 只能按Type查找, 找不到类型的key用不到
+                    Entry entry = new Entry { Text = text, Description = description };
+                    if (text != null) ParseTemplate(ref entry);
+                    table.ids.Add(type, entries.Count);
+                    entries.Add(entry);
+                }
+                table.entries = entries.ToArray();
+            }
+            return table;
+        }
+
+        private static void ParseTemplate(ref Entry entry) {
+            string text = entry.Text;
+            int open = text.IndexOf('{');
+            if (open < 0 && text.IndexOf('}') < 0) {
+                entry.Kind = TemplateKind.Plain;
+                return;
+            }
+            const string placeholder = "{0}";
+            if (open >= 0 && string.CompareOrdinal(text, open, placeholder, 0, placeholder.Length) == 0) {
+                string prefix = text.Substring(0, open);
+                string suffix = text.Substring(open + placeholder.Length);
+                if (prefix.IndexOf('}') < 0 && suffix.IndexOfAny(braces) < 0) {
+                    entry.Kind = TemplateKind.Single;
+                    entry.Prefix = prefix;
+                    entry.Suffix = suffix;
+                    return;
+                }
+            }
+            entry.Kind = TemplateKind.Complex;
+        }
+        private static readonly char[] braces = { '{', '}' };
+
+        public bool TryGet(Type type, out string text) {
+            if (ids.TryGetValue(type, out int id) && entries[id].Text != null) {
+                text = entries[id].Text;
+                return true;
+            }
+            text = null;
+            return false;
+        }
+
+        public string GetDescription(Type type) => ids.TryGetValue(type, out int id) ? entries[id].Description : null;
+
+        /// <summary>
+        /// 与string.Format(text, arg)结果一致
+        /// </summary>
+        public bool TryFormat(Type type, string arg, out string result) {
+            if (!ids.TryGetValue(type, out int id) || entries[id].Text == null) {
+                result = null;
+                return false;
+            }
+            Entry entry = entries[id];
+            switch (entry.Kind) {
+                case TemplateKind.Plain:
+                    result = entry.Text;
+                    break;
+                case TemplateKind.Single:
+                    result = string.Concat(entry.Prefix, arg, entry.Suffix);
+                    break;
+                default:
+                    result = string.Format(entry.Text, arg);
+                    break;
+            }
+            return true;
+        }
+
+        private static void WriteNullable(BinaryWriter writer, string s) {
+            writer.Write(s != null);
+            if (s != null) writer.Write(s);
+        }
+        private static string ReadNullable(BinaryReader reader) => reader.ReadBoolean() ? reader.ReadString() : null;
+    }
+}
@@ -8,34 +8,69 @@ namespace Weathering
     public static class Tag
     {
         public static T GetAttribute<T>(Type type) where T : Attribute {
-            return Attribute.GetCustomAttribute(type, typeof(T)) as T;
+            return AttributeCache<T>.Get(type);
+        }
+        // 每种Attribute一个表, 每个类型只反射一次
+        private static class AttributeCache<T> where T : Attribute
+        {
+            private static readonly Dictionary<Type, T> cache = new Dictionary<Type, T>();
+            public static T Get(Type type) {
+                if (!cache.TryGetValue(type, out T result)) {
+                    result = Attribute.GetCustomAttribute(type, typeof(T)) as T;
+                    cache.Add(type, result);
+                }
+                return result;
+            }
+        }
+
+        public const int NoIndex = -1;
+
+        /// <summary>
+        /// 概念类型的稠密下标, 不是概念返回NoIndex。需要反复查询的地方可以缓存下标, 之后只做位运算
+        /// </summary>
+        public static int IndexOf(Type type) {
+            if (type != null && AttributesPreprocessor.Ins.IndexDict.TryGetValue(type, out int index)) {
+                return index;
+            }
+            return NoIndex;
+        }
+        public static Type TypeOf(int index) => AttributesPreprocessor.Ins.DependAttributeList[index];
+
+        public static bool HasTag(int typeIndex, int tagIndex) {
+            if (typeIndex < 0 || tagIndex < 0) return false;
+            if (typeIndex == tagIndex) return true;
+            AttributesPreprocessor ins = AttributesPreprocessor.Ins;
+            return (ins.ClosureBits[typeIndex * ins.ClosureStride + (tagIndex >> 6)] & (1UL << (tagIndex & 63))) != 0;
         }
 
         public static bool HasTag(Type type, Type tag) {
             if (type == tag) return true;
-            if (AttributesPreprocessor.Ins.FinalResult.TryGetValue(type, out HashSet<Type> result)) {
-                return result.Contains(tag);
-            }
-            return false;
+            int typeIndex = IndexOf(type);
+            if (typeIndex < 0) return false;
+            return HasTag(typeIndex, IndexOf(tag));
         }
 
         public static bool IsValidTag(Type type) {
-            return AttributesPreprocessor.Ins.FinalResult.ContainsKey(type);
+            return IndexOf(type) >= 0;
         }
 
         public static List<Type> AllTagOf(Type type) {
-            if (AttributesPreprocessor.Ins.FinalResult.ContainsKey(type)) {
-                return AttributesPreprocessor.Ins.FinalResultSorted[type];
+            int index = IndexOf(type);
+            if (index >= 0) {
+                return AttributesPreprocessor.Ins.FinalResultSortedByIndex[index];
             }
             throw new Exception(type.FullName);
         }
+        public static List<Type> AllTagOf(int index) => AttributesPreprocessor.Ins.FinalResultSortedByIndex[index];
 
         public static List<Type> AllSubTagOf(Type type) {
-            if (AttributesPreprocessor.Ins.FinalResult.ContainsKey(type)) {
-                return AttributesPreprocessor.Ins.FinalResultInversedSorted[type];
+            int index = IndexOf(type);
+            if (index >= 0) {
+                return AttributesPreprocessor.Ins.FinalResultInversedSortedByIndex[index];
             }
             throw new Exception(type.FullName);
         }
+        public static List<Type> AllSubTagOf(int index) => AttributesPreprocessor.Ins.FinalResultInversedSortedByIndex[index];
     }
 }
 
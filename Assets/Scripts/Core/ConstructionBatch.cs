@@ -0,0 +1,57 @@
+﻿
+using System;
+using System.Collections.Generic;
+using UnityEngine;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 一次建造多个地块, 如拖动建造一排道路
+    /// 1. 所有地块的建筑费用合计后检查一次, 一次扣除, 费用按建筑数量递增, 与逐个建造相同
+    /// 2. 相邻地块的贴图只在最后标记一次, 重复的不再标记
+    /// 3. 只推送一条通知
+    /// 提交时不能建造的位置被跳过, 资源不足时全部不建造
+    /// </summary>
+    public class ConstructionBatch
+    {
+        public readonly IMap Map;
+
+        private readonly List<ValueTuple<Type, Vector2Int>> placements = new List<ValueTuple<Type, Vector2Int>>();
+        private readonly Dictionary<Vector2Int, int> indexOf = new Dictionary<Vector2Int, int>();
+
+        public ConstructionBatch(IMap map) {
+            Map = map ?? throw new Exception();
+        }
+
+        public int Count => placements.Count;
+        public IReadOnlyList<ValueTuple<Type, Vector2Int>> Placements => placements;
+
+        /// <summary>
+        /// 同一位置添加多次时, 以最后一次为准
+        /// </summary>
+        public void Add(Type type, Vector2Int pos) {
+            if (type == null) throw new Exception();
+            if (indexOf.TryGetValue(pos, out int index)) {
+                placements[index] = (type, pos);
+            } else {
+                indexOf.Add(pos, placements.Count);
+                placements.Add((type, pos));
+            }
+        }
+        public void Add<T>(Vector2Int pos) where T : ITile => Add(typeof(T), pos);
+
+        public void Clear() {
+            placements.Clear();
+            indexOf.Clear();
+        }
+
+        /// <summary>
+        /// 返回建造的地块数量
+        /// </summary>
+        public int Commit() {
+            int result = Map.UpdateAt(this);
+            Clear();
+            return result;
+        }
+    }
+}
@@ -2,6 +2,8 @@
 using System;
 using System.Collections.Generic;
 using System.IO;
+using System.Threading;
+using System.Threading.Tasks;
 using UnityEngine;
 
 namespace Weathering
@@ -18,16 +20,23 @@ namespace Weathering
 
         void SaveMapHead(IMapDefinition map);
         void SaveMapBody(IMapDefinition map);
+        void SaveMapBodyIncremental(IMapDefinition map);
         void LoadMapHead(IMapDefinition map, string mapKey);
         void LoadMapBody(IMapDefinition map, string mapKey);
 
         void DeleteMap(IMapDefinition map);
 
+        // 存档分两步: BeginSave和EndSave之间在主线程生成快照, EndSave后在存档线程写文件
+        void BeginSave(long ticks);
+        void EndSave();
+        void FlushSaves();
+
         void SaveGlobals();
         void LoadGlobals();
         bool HasGlobals();
 
         bool HasMap(string mapKey);
+        void PrefetchMap(string mapKey); // 在后台读入地图存档文件, 之后的LoadMapHead/LoadMapBody直接使用
 
         void DeleteSaves();
     }
@@ -57,6 +66,7 @@ namespace Weathering
         // 存档根目录
         private string PersistentBase { get; set; }
         private const string SavesBase = "Saves/";
+        private const string TerrainCacheBase = "TerrainCache/"; // 地形噪声缓存, 不属于存档
         private string SaveFullPath { get; set; }
 
         private Newtonsoft.Json.JsonSerializerSettings setting = new Newtonsoft.Json.JsonSerializerSettings {
@@ -64,90 +74,402 @@ namespace Weathering
         };
 
         public static IDataPersistence Ins { get; private set; }
+
+        /// <summary>
+        /// 设置了这个环境变量时, 存档放在它指定的目录, 性能测试用, 不碰玩家存档
+        /// </summary>
+        public const string PersistentRootVariable = "WEATHERING_PERSISTENT_ROOT";
+
         private void Awake() {
             if (Ins != null) throw new Exception();
             Ins = this;
 
-            PersistentBase = Application.persistentDataPath + $"/v{GameConfig.VersionCode}/";
+            string persistentRoot = Environment.GetEnvironmentVariable(PersistentRootVariable);
+            if (string.IsNullOrEmpty(persistentRoot)) persistentRoot = Application.persistentDataPath;
+            PersistentBase = persistentRoot + $"/v{GameConfig.VersionCode}/";
             SaveFullPath = PersistentBase + SavesBase;
             if (!Directory.Exists(SaveFullPath)) {
                 Directory.CreateDirectory(SaveFullPath);
             }
+            TerrainFieldCache.DiskPath = PersistentBase + TerrainCacheBase;
         }
 
         public const string JSON_SUFFIX = ".json";
         public const string TEMP_FILENAME = "temp" + JSON_SUFFIX;
         public void WriteSave(string filename, string content) {
-            string tempPath = SaveFullPath + TEMP_FILENAME;
             string targetPath = SaveFullPath + filename + JSON_SUFFIX;
-            File.WriteAllText(tempPath, content);
+            FlushSaves(); // 与存档线程共用临时文件
+            WriteFileAtomic(targetPath, SaveFullPath + TEMP_FILENAME, System.Text.Encoding.UTF8.GetBytes(content));
+        }
+        private static void WriteFileAtomic(string targetPath, string tempPath, byte[] content) {
+            File.WriteAllBytes(tempPath, content);
+            ReplaceFile(targetPath, tempPath);
+        }
+        private static void ReplaceFile(string targetPath, string tempPath) {
             if (File.Exists(targetPath)) {
                 File.Delete(targetPath);
             }
             File.Move(tempPath, targetPath);
         }
+        /// <summary>
+        /// 直接序列化到文件流, 不生成完整的json字符串
+        /// </summary>
+        private void WriteJsonAtomic(string targetPath, string tempPath, object data) {
+            using (StreamWriter writer = new StreamWriter(tempPath, false, new System.Text.UTF8Encoding(false), fileBufferSize))
+            using (Newtonsoft.Json.JsonTextWriter jsonWriter = new Newtonsoft.Json.JsonTextWriter(writer) { Formatting = Newtonsoft.Json.Formatting.Indented }) {
+                Newtonsoft.Json.JsonSerializer.Create(setting).Serialize(jsonWriter, data);
+            }
+            ReplaceFile(targetPath, tempPath);
+        }
+        private const int fileBufferSize = 64 * 1024;
+
+        public const string BINARY_SUFFIX = ".bytes";
+        public const string TEMP_BINARY_FILENAME = "temp" + BINARY_SUFFIX;
+        public byte[] ReadSaveBytes(string filename) {
+            string path = SaveFullPath + filename + BINARY_SUFFIX;
+            if (TakePrefetched(path, out byte[] bytes)) return bytes;
+            WaitForPendingSave(path);
+            return File.ReadAllBytes(path);
+        }
+        public bool HasSaveBytes(string filename) {
+            string path = SaveFullPath + filename + BINARY_SUFFIX;
+            WaitForPendingSave(path);
+            return File.Exists(path);
+        }
 
-        public void DeleteSave(string filename) {
-            File.Delete(SaveFullPath + filename + JSON_SUFFIX);
+        public const string JOURNAL_SUFFIX = ".journal";
+        public byte[] ReadSaveJournal(string filename) {
+            string path = SaveFullPath + filename + JOURNAL_SUFFIX;
+            if (TakePrefetched(path, out byte[] bytes)) return bytes;
+            WaitForPendingSave(path);
+            return File.ReadAllBytes(path);
+        }
+        public bool HasSaveJournal(string filename) {
+            string path = SaveFullPath + filename + JOURNAL_SUFFIX;
+            WaitForPendingSave(path);
+            return File.Exists(path);
         }
+
         public void DeleteMap(IMapDefinition map) {
             int width = map.Width;
             int height = map.Height;
             for (int i = 0; i < width; i++) {
                 for (int j = 0; j < height; j++) {
-                    map.GetTileFast(i, j).OnDestructWithMap();
+                    if (map.IsTileMaterialized(i, j)) {
+                        map.GetTileFast(i, j).OnDestructWithMap();
+                    }
                 }
             }
 
+            // 删除前等待存档线程写完, 避免删除后又被写回
+            FlushSaves();
             string mapKey = map.MapKey;
-            if (HasSave(mapKey)) {
-                DeleteSave(mapKey);
-            }
-
-            string mapHeadKey = map.MapKey + HeadSuffix;
-            if (HasSave(mapHeadKey)) {
-                DeleteSave(mapHeadKey);
+            DropPrefetched(null);
+            mapBodyStates.Remove(mapKey);
+            TerrainFieldCache.Remove(mapKey);
+            DeleteIfExists(SaveFullPath + mapKey + JOURNAL_SUFFIX);
+            DeleteIfExists(SaveFullPath + mapKey + BINARY_SUFFIX);
+            DeleteIfExists(SaveFullPath + mapKey + JSON_SUFFIX);
+            DeleteIfExists(SaveFullPath + mapKey + HeadSuffix + JSON_SUFFIX);
+        }
+        private static void DeleteIfExists(string path) {
+            if (File.Exists(path)) {
+                File.Delete(path);
             }
         }
 
 
         public string ReadSave(string filename) {
-            return File.ReadAllText(SaveFullPath + filename + JSON_SUFFIX);
+            string path = SaveFullPath + filename + JSON_SUFFIX;
+            if (TakePrefetched(path, out byte[] bytes)) {
+                using (StreamReader reader = new StreamReader(new MemoryStream(bytes))) {
+                    return reader.ReadToEnd();
+                }
+            }
+            WaitForPendingSave(path);
+            return File.ReadAllText(path);
+        }
+
+        /// <summary>
+        /// 从文件流或预读的字节读取json, 不生成完整的json字符串
+        /// </summary>
+        private Newtonsoft.Json.JsonTextReader OpenSaveJson(string filename) {
+            string path = SaveFullPath + filename + JSON_SUFFIX;
+            Stream stream;
+            if (TakePrefetched(path, out byte[] bytes)) {
+                stream = new MemoryStream(bytes, false);
+            } else {
+                WaitForPendingSave(path);
+                stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, fileBufferSize);
+            }
+            return new Newtonsoft.Json.JsonTextReader(new StreamReader(stream, System.Text.Encoding.UTF8));
+        }
+        private T ReadSaveJson<T>(string filename) {
+            using (Newtonsoft.Json.JsonTextReader reader = OpenSaveJson(filename)) {
+                return Newtonsoft.Json.JsonSerializer.Create(setting).Deserialize<T>(reader);
+            }
         }
 
         public bool HasSave(string filename) {
-            return File.Exists(SaveFullPath + filename + JSON_SUFFIX);
+            string path = SaveFullPath + filename + JSON_SUFFIX;
+            WaitForPendingSave(path);
+            return File.Exists(path);
+        }
+
+
+        // ------------------------------------------------------------
+        // 存档线程
+
+        private const string save_complete = "__save_complete__";
+        private const string incomplete = "incomplete";
+
+        private readonly object saveLock = new object();
+        private SaveSnapshot collecting = null; // 主线程正在生成的快照
+        private SaveSnapshot pending = null; // 等待存档线程执行的快照, 新的快照合并进来而不是排队
+        private SaveSnapshot running = null; // 存档线程正在执行的快照
+        private bool saveThreadRunning = false;
+        private Exception saveException = null;
+
+        public void BeginSave(long ticks) {
+            if (collecting != null) throw new Exception("存档未结束");
+            ThrowSaveException();
+            collecting = new SaveSnapshot { Ticks = ticks };
+        }
+
+        public void EndSave() {
+            if (collecting == null) throw new Exception("存档未开始");
+            SaveSnapshot snapshot = collecting;
+            collecting = null;
+            // 预读的内容可能已经过时
+            DropPrefetched(snapshot.Paths);
+            lock (saveLock) {
+                if (pending == null) {
+                    pending = snapshot;
+                } else {
+                    pending.Merge(snapshot);
+                }
+                if (!saveThreadRunning) {
+                    saveThreadRunning = true;
+                    Task.Run(SaveThread);
+                }
+            }
+        }
+
+        /// <summary>
+        /// 等待所有快照写完
+        /// </summary>
+        public void FlushSaves() {
+            lock (saveLock) {
+                while (saveThreadRunning) {
+                    Monitor.Wait(saveLock);
+                }
+            }
+            ThrowSaveException();
+        }
+
+        private void OnApplicationQuit() {
+            FlushSaves();
+        }
+
+        private void ThrowSaveException() {
+            Exception e;
+            lock (saveLock) {
+                e = saveException;
+                saveException = null;
+            }
+            if (e != null) throw new Exception("存档失败", e);
+        }
+
+        /// <summary>
+        /// 读文件前, 如果此文件还在快照中没有写完, 则等待
+        /// </summary>
+        private void WaitForPendingSave(string path) {
+            lock (saveLock) {
+                while ((pending != null && pending.Paths.Contains(path)) || (running != null && running.Paths.Contains(path))) {
+                    Monitor.Wait(saveLock);
+                }
+            }
+        }
+
+        private void SaveThread() {
+            while (true) {
+                SaveSnapshot snapshot;
+                lock (saveLock) {
+                    snapshot = pending;
+                    pending = null;
+                    running = snapshot;
+                    if (snapshot == null) {
+                        saveThreadRunning = false;
+                        Monitor.PulseAll(saveLock);
+                        return;
+                    }
+                }
+                try {
+                    ExecuteSnapshot(snapshot);
+                } catch (Exception e) {
+                    lock (saveLock) {
+                        saveException = e;
+                    }
+                }
+                lock (saveLock) {
+                    running = null;
+                    Monitor.PulseAll(saveLock);
+                }
+            }
+        }
+
+        private void ExecuteSnapshot(SaveSnapshot snapshot) {
+            string completePath = SaveFullPath + save_complete + JSON_SUFFIX;
+            string tempPath = SaveFullPath + TEMP_FILENAME;
+
+            // 损坏校验
+            if (File.Exists(completePath) && File.ReadAllText(completePath).StartsWith(incomplete)) {
+                throw new Exception("存档损坏");
+            }
+            WriteFileAtomic(completePath, tempPath, System.Text.Encoding.UTF8.GetBytes($"{incomplete} {snapshot.Ticks}"));
+
+            foreach (var operation in snapshot.Operations) {
+                switch (operation.Type) {
+                    case SaveSnapshot.OperationType.WriteJson:
+                        WriteJsonAtomic(operation.Path, tempPath, operation.Data);
+                        break;
+                    case SaveSnapshot.OperationType.WriteMapBody: {
+                            MapBodyWrite write = (MapBodyWrite)operation.Data;
+                            byte[] bytes = MapBodyFormat.Serialize(write.Snapshot, write.Generation, write.Compress);
+                            WriteFileAtomic(operation.Path, SaveFullPath + TEMP_BINARY_FILENAME, bytes);
+                            lock (saveLock) {
+                                write.State.BodyLength = bytes.Length;
+                            }
+                        }
+                        break;
+                    case SaveSnapshot.OperationType.AppendMapJournal: {
+                            MapBodyWrite write = (MapBodyWrite)operation.Data;
+                            byte[] bytes = MapBodyFormat.SerializeJournalRecord(write.Snapshot, write.Generation);
+                            using (FileStream stream = new FileStream(operation.Path, FileMode.Append, FileAccess.Write)) {
+                                stream.Write(bytes, 0, bytes.Length);
+                                stream.Flush(true);
+                            }
+                            lock (saveLock) {
+                                write.State.JournalLength += bytes.Length;
+                            }
+                        }
+                        break;
+                    case SaveSnapshot.OperationType.Delete:
+                        DeleteIfExists(operation.Path);
+                        break;
+                    default:
+                        throw new Exception();
+                }
+            }
+
+            // 结束存档
+            WriteFileAtomic(completePath, tempPath, System.Text.Encoding.UTF8.GetBytes(snapshot.Ticks.ToString()));
+#if UNITY_EDITOR
+            Debug.LogWarning("Save OK");
+#endif
+        }
+
+        // ------------------------------------------------------------
+        // 预读
+
+        private readonly object prefetchLock = new object();
+        private readonly Dictionary<string, byte[]> prefetched = new Dictionary<string, byte[]>();
+        private readonly HashSet<string> prefetching = new HashSet<string>();
+        private long prefetchEpoch = 0; // 每次可能修改存档文件时加一, 旧的预读结果作废
+
+        public void PrefetchMap(string mapKey) {
+            string[] paths = {
+                SaveFullPath + mapKey + HeadSuffix + JSON_SUFFIX,
+                SaveFullPath + mapKey + BINARY_SUFFIX,
+                SaveFullPath + mapKey + JOURNAL_SUFFIX,
+            };
+            long epoch;
+            lock (prefetchLock) {
+                if (prefetching.Contains(mapKey) || prefetched.ContainsKey(paths[0])) return;
+                prefetching.Add(mapKey);
+                epoch = prefetchEpoch;
+            }
+            Task.Run(() => {
+                Dictionary<string, byte[]> result = new Dictionary<string, byte[]>();
+                try {
+                    foreach (var path in paths) {
+                        WaitForPendingSave(path);
+                        if (File.Exists(path)) result.Add(path, File.ReadAllBytes(path));
+                    }
+                } catch (IOException) {
+                    // 存档线程正在替换文件, 放弃预读
+                    result = null;
+                }
+                lock (prefetchLock) {
+                    prefetching.Remove(mapKey);
+                    if (result == null || epoch != prefetchEpoch) return;
+                    foreach (var pair in result) {
+                        prefetched[pair.Key] = pair.Value;
+                    }
+                }
+            });
+        }
+
+        private bool TakePrefetched(string path, out byte[] bytes) {
+            lock (prefetchLock) {
+                if (prefetched.TryGetValue(path, out bytes)) {
+                    prefetched.Remove(path);
+                    return true;
+                }
+                return false;
+            }
+        }
+
+        /// <summary>
+        /// paths为null时丢弃所有预读
+        /// </summary>
+        private void DropPrefetched(HashSet<string> paths) {
+            lock (prefetchLock) {
+                prefetchEpoch++;
+                if (paths == null) {
+                    prefetched.Clear();
+                } else {
+                    foreach (var path in paths) {
+                        prefetched.Remove(path);
+                    }
+                }
+            }
+        }
+
+        private SaveSnapshot Collecting {
+            get {
+                if (collecting == null) throw new Exception("存档未开始");
+                return collecting;
+            }
         }
+        private void CollectJson(string filename, object data) {
+            Collecting.Add(SaveSnapshot.OperationType.WriteJson, SaveFullPath + filename + JSON_SUFFIX, data);
+        }
+
+        // ------------------------------------------------------------
 
         private readonly string globalValuesFilename = "_Globals.Values";
         private readonly string globalRefsFilename = "_Globals.Refs";
         private readonly string globalPrefsFilename = "_Globals.Prefs";
         private readonly string globalInventoryFileName = "_Globals.Inventory";
         public void SaveGlobals() {
+            // 快照, json序列化在存档线程
             Dictionary<string, ValueData> values = Values.ToData(Globals.Ins.Values);
             Dictionary<string, RefData> refs = Refs.ToData(Globals.Ins.Refs);
-            Dictionary<string, string> prefs = Globals.Ins.PlayerPreferences;
+            Dictionary<string, string> prefs = new Dictionary<string, string>(Globals.Ins.PlayerPreferences);
             InventoryData inventory = Inventory.ToData(Globals.Ins.Inventory);
 
-            WriteSave(globalValuesFilename, Newtonsoft.Json.JsonConvert.SerializeObject(
-                values, Newtonsoft.Json.Formatting.Indented, setting));
-            WriteSave(globalRefsFilename, Newtonsoft.Json.JsonConvert.SerializeObject(
-                refs, Newtonsoft.Json.Formatting.Indented, setting));
-            WriteSave(globalPrefsFilename, Newtonsoft.Json.JsonConvert.SerializeObject(
-                prefs, Newtonsoft.Json.Formatting.Indented, setting));
-            WriteSave(globalInventoryFileName, Newtonsoft.Json.JsonConvert.SerializeObject(
-                inventory, Newtonsoft.Json.Formatting.Indented, setting));
+            CollectJson(globalValuesFilename, values);
+            CollectJson(globalRefsFilename, refs);
+            CollectJson(globalPrefsFilename, prefs);
+            CollectJson(globalInventoryFileName, inventory);
         }
 
         public void LoadGlobals() {
-            Dictionary<string, ValueData> values = Newtonsoft.Json.JsonConvert.DeserializeObject<Dictionary<string, ValueData>>(
-                ReadSave(globalValuesFilename), setting);
-            Dictionary<string, RefData> refs = Newtonsoft.Json.JsonConvert.DeserializeObject<Dictionary<string, RefData>>(
-                ReadSave(globalRefsFilename), setting);
-            Dictionary<string, string> prefs = Newtonsoft.Json.JsonConvert.DeserializeObject<Dictionary<string, string>>(
-                ReadSave(globalPrefsFilename), setting);
-            InventoryData inventory = Newtonsoft.Json.JsonConvert.DeserializeObject<InventoryData>(
-                ReadSave(globalInventoryFileName), setting);
+            Dictionary<string, ValueData> values = ReadSaveJson<Dictionary<string, ValueData>>(globalValuesFilename);
+            Dictionary<string, RefData> refs = ReadSaveJson<Dictionary<string, RefData>>(globalRefsFilename);
+            Dictionary<string, string> prefs = ReadSaveJson<Dictionary<string, string>>(globalPrefsFilename);
+            InventoryData inventory = ReadSaveJson<InventoryData>(globalInventoryFileName);
 
             IGlobalsDefinition globals = Globals.Ins as IGlobalsDefinition;
             if (globals == null) throw new Exception();
@@ -188,16 +510,46 @@ namespace Weathering
             public InventoryData inventory;
         }
 
-        private string SerializeVector2(Vector2Int vec) => $"{vec.x},{vec.y}";
-        //private Vector2Int DeserializeVector2(string s) {
-        //    string[] ss = s.Split(',');
-        //    int x = int.Parse(ss[0]);
-        //    int y = int.Parse(ss[1]);
-        //    return new Vector2Int(x, y);
-        //}
+        private bool TryDeserializeVector2(string s, out Vector2Int vec) {
+            vec = default;
+            int comma = s.IndexOf(',');
+            if (comma < 0) return false;
+            if (!int.TryParse(s.Substring(0, comma), out int x)) return false;
+            if (!int.TryParse(s.Substring(comma + 1), out int y)) return false;
+            vec = new Vector2Int(x, y);
+            return true;
+        }
 
         public const string HeadSuffix = ".head";
 
+        // 每个已读取或已完整保存的地图存档的代数和大小, 日志记录只对同一代数的完整存档有效
+        // 大小记在内存里, 因为文件可能还在存档线程里没有写完。编码在存档线程, 大小由存档线程在saveLock内更新, 会滞后于快照
+        private class MapBodyState
+        {
+            public long Generation;
+            public long BodyLength;
+            public long JournalLength;
+        }
+        // WriteMapBody和AppendMapJournal操作的数据
+        private class MapBodyWrite
+        {
+            public MapBodySnapshot Snapshot;
+            public long Generation;
+            public bool Compress;
+            public MapBodyState State;
+        }
+        private readonly Dictionary<string, MapBodyState> mapBodyStates = new Dictionary<string, MapBodyState>();
+        private long lastGeneration = 0;
+        private long NextGeneration() {
+            long generation = DateTime.UtcNow.Ticks;
+            if (generation <= lastGeneration) generation = lastGeneration + 1;
+            lastGeneration = generation;
+            return generation;
+        }
+
+        // 日志大小超过完整存档的这个比例时, 合并为完整存档
+        private const long journalCompactionRatioPercent = 50;
+
         public void SaveMapHead(IMapDefinition map) {
             // obj => data
             MapData mapHeadData = new MapData {
@@ -208,46 +560,74 @@ namespace Weathering
                 inventory_of_supply = Inventory.ToData(map.InventoryOfSupply),
             };
 
-            // data => json
-            string mapHeadJson = Newtonsoft.Json.JsonConvert.SerializeObject(
-                mapHeadData, Newtonsoft.Json.Formatting.Indented, setting
-            );
-            // json => file
-            WriteSave(map.MapKey + HeadSuffix, mapHeadJson);
+            // data => json => file, 在存档线程
+            CollectJson(map.MapKey + HeadSuffix, mapHeadData);
+            map.ClearHeadSaveDirty();
         }
         public void SaveMapBody(IMapDefinition map) {
-            // obj => data
-            int width = map.Width;
-            int height = map.Height;
-            Dictionary<string, TileData> mapBodyData = new Dictionary<string, TileData>();
-            for (int i = 0; i < width; i++) {
-                for (int j = 0; j < height; j++) {
-                    ITileDefinition tile = map.Get(i, j) as ITileDefinition;
-                    if (tile == null) throw new Exception();
-
-                    if (tile is IDontSave saveOrNot) {
-                        if (saveOrNot.DontSave) {
-                            continue;
-                        }
+            using (PerformanceCounters.Measure(PerformanceSection.SaveMapBody)) {
+                string mapKey = map.MapKey;
+                long generation = NextGeneration();
+                // 新存档写完前, 用旧存档的大小估计
+                long bodyLength = 0;
+                if (mapBodyStates.TryGetValue(mapKey, out MapBodyState old)) {
+                    lock (saveLock) {
+                        bodyLength = old.BodyLength;
                     }
-
-                    TileData tileData = new TileData {
-                        values = Values.ToData(tile.Values),
-                        references = Refs.ToData(tile.Refs),
-                        type = tile.GetType().FullName,
-                        inventory = Inventory.ToData(tile.Inventory),
-                    };
-
-                    mapBodyData.Add(SerializeVector2(new Vector2Int(i, j)), tileData);
                 }
+                MapBodyState state = new MapBodyState { Generation = generation, BodyLength = bodyLength, JournalLength = 0 };
+                // obj => snapshot
+                MapBodySnapshot mapBodySnapshot = MapBodySnapshot.Capture(map, false);
+                // snapshot => bytes => file, 在存档线程
+                SaveSnapshot snapshot = Collecting;
+                snapshot.Add(SaveSnapshot.OperationType.WriteMapBody, SaveFullPath + mapKey + BINARY_SUFFIX, new MapBodyWrite {
+                    Snapshot = mapBodySnapshot,
+                    Generation = generation,
+                    Compress = GameConfig.CompressSaves,
+                    State = state,
+                });
+                // 新的完整存档写入后, 旧日志已包含在内
+                snapshot.Add(SaveSnapshot.OperationType.Delete, SaveFullPath + mapKey + JOURNAL_SUFFIX);
+                // 旧版json存档已经迁移到二进制存档
+                snapshot.Add(SaveSnapshot.OperationType.Delete, SaveFullPath + mapKey + JSON_SUFFIX);
+
+                mapBodyStates[mapKey] = state;
+                map.ClearBodySaveDirty();
+            }
+        }
+        /// <summary>
+        /// 只把脏区块追加到日志。没有可追加的完整存档, 脏区块过多, 或日志过大时, 改为完整存档
+        /// </summary>
+        public void SaveMapBodyIncremental(IMapDefinition map) {
+            string mapKey = map.MapKey;
+            if (!mapBodyStates.TryGetValue(mapKey, out MapBodyState state)) {
+                SaveMapBody(map);
+                return;
+            }
+            if (!map.BodySaveDirty) return;
+            if (map.SaveDirtyChunkCount * 2 > MapBodyFormat.ChunkCount(map)) {
+                SaveMapBody(map);
+                return;
+            }
+
+            // 只按已经写完的大小判断
+            bool compact;
+            lock (saveLock) {
+                compact = state.JournalLength * 100 > state.BodyLength * journalCompactionRatioPercent;
+            }
+            if (compact) {
+                SaveMapBody(map);
+                return;
             }
-            // data => json
-            string mapBodyJson = Newtonsoft.Json.JsonConvert.SerializeObject(
-                mapBodyData
-                 , Newtonsoft.Json.Formatting.Indented, setting
-                );
-            // json => file
-            WriteSave(map.MapKey, mapBodyJson);
+            using (PerformanceCounters.Measure(PerformanceSection.SaveMapBody)) {
+                // obj => snapshot, snapshot => bytes => file 在存档线程
+                Collecting.Add(SaveSnapshot.OperationType.AppendMapJournal, SaveFullPath + mapKey + JOURNAL_SUFFIX, new MapBodyWrite {
+                    Snapshot = MapBodySnapshot.Capture(map, true),
+                    Generation = state.Generation,
+                    State = state,
+                });
+            }
+            map.ClearBodySaveDirty();
         }
         public bool HasMap(string mapKey) {
             return HasSave(mapKey + HeadSuffix);
@@ -259,14 +639,9 @@ namespace Weathering
             if (mapKey == null) throw new Exception();
 
             // 1. 读取对应位置json存档
-            // file => json
-            string mapHeadJson = ReadSave(mapKey + HeadSuffix);
-
             // 2. 将json反序列化为数据 Dictionary<string, ValueData>, string为数值类型
-            // json => data
-            MapData mapData = Newtonsoft.Json.JsonConvert.DeserializeObject<MapData>(
-                mapHeadJson, setting
-            );
+            // file => json => data
+            MapData mapData = ReadSaveJson<MapData>(mapKey + HeadSuffix);
 
             // 3. 从数据中同步到地图对象中
             // data => obj
@@ -291,72 +666,118 @@ namespace Weathering
         }
 
         public void LoadMapBody(IMapDefinition map, string mapKey) {
-            if (map == null) throw new Exception();
-            if (mapKey == null) throw new Exception();
+            using (PerformanceCounters.Measure(PerformanceSection.LoadMapBody)) {
+                if (map == null) throw new Exception();
+                if (mapKey == null) throw new Exception();
+
+                List<ITileDefinition> tiles;
+                mapBodyStates.Remove(mapKey);
+                if (HasSaveBytes(mapKey)) {
+                    // file => bytes => obj, 并重放日志
+                    byte[] mapBodyBytes = ReadSaveBytes(mapKey);
+                    byte[] journalBytes = HasSaveJournal(mapKey) ? ReadSaveJournal(mapKey) : null;
+                    tiles = new List<ITileDefinition>(map.Width * map.Height);
+                    long generation = MapBodyFormat.Deserialize(map, mapBodyBytes, journalBytes, tiles);
+                    if (generation != MapBodyFormat.NoGeneration) {
+                        mapBodyStates[mapKey] = new MapBodyState {
+                            Generation = generation,
+                            BodyLength = mapBodyBytes.Length,
+                            JournalLength = journalBytes == null ? 0 : journalBytes.Length,
+                        };
+                    }
+                } else {
+                    // 旧版json存档, 下次存档时迁移为二进制
+                    tiles = LoadMapBodyLegacy(map, mapKey);
+                }
 
+                if (!map.SparseDefaultTiles && tiles.Count != map.Width * map.Height) throw new Exception("存档地图大小与定义不一致");
+                // 读档时的SetTile不算修改
+                map.ClearBodySaveDirty();
+                foreach (var tile in tiles) {
+                    tile.NeedUpdateSpriteKeys = true;
+                    tile.OnEnable();
+                }
+            }
+        }
+
+        private List<ITileDefinition> LoadMapBodyLegacy(IMapDefinition map, string mapKey) {
+            int width = map.Width;
+            int height = map.Height;
             // 6. 读取对应位置地块json存档
-            // file => json
-            string mapBodyJson = ReadSave(mapKey);
-            // 7. 将json反序列化为数据 Dictionary<string, TileData>, string为位置, TileData包含类型和值
-            // json => data
-            Dictionary<string, TileData> mapBodyData = Newtonsoft.Json.JsonConvert.DeserializeObject<
-                Dictionary<string, TileData>>(mapBodyJson, setting
-                );
-            // 8. 对于每一个地块, 通过SetTile塞到地图里
-            // map => obj
-            List<ITileDefinition> tiles = new List<ITileDefinition>(mapBodyData.Count);
-
-            Type defaultTileType = map.DefaultTileType;
-            for (int i = 0; i < map.Width; i++) {
-                for (int j = 0; j < map.Height; j++) {
-                    Vector2Int pos = new Vector2Int(i, j);
-                    string key = SerializeVector2(pos);
-                    if (mapBodyData.TryGetValue(key, out TileData tileData)) {
-                        Type tileType = Type.GetType(tileData.type);
+            // 7. 逐个读取 "位置": TileData, 每读到一个就创建地块, 不生成完整的 Dictionary<string, TileData>
+            // file => json => obj
+            ITileDefinition[] loaded = new ITileDefinition[width * height];
+            using (Newtonsoft.Json.JsonTextReader reader = OpenSaveJson(mapKey)) {
+                Newtonsoft.Json.JsonSerializer serializer = Newtonsoft.Json.JsonSerializer.Create(setting);
+                if (!reader.Read() || reader.TokenType != Newtonsoft.Json.JsonToken.StartObject) throw new Exception("地图存档格式错误");
+                while (reader.Read() && reader.TokenType == Newtonsoft.Json.JsonToken.PropertyName) {
+                    string key = (string)reader.Value;
+                    if (!reader.Read()) throw new Exception("地图存档格式错误");
+                    // 地图范围外的地块和以前一样忽略
+                    if (!TryDeserializeVector2(key, out Vector2Int pos) || pos.x < 0 || pos.x >= width || pos.y < 0 || pos.y >= height) {
+                        reader.Skip();
+                        continue;
+                    }
+                    TileData tileData = serializer.Deserialize<TileData>(reader);
 
-                        ITileDefinition tile = Activator.CreateInstance(tileType) as ITileDefinition;
-                        if (tile == null) throw new Exception();
-                        tile.Pos = pos;
-                        tile.Map = map;
-                        tile.TileHashCode = HashUtility.Hash(pos.x, pos.y, map.Width, map.Height, (int)map.HashCode); // HashUtility.Hash((uint)(pos.x + pos.y * map.Width));
+                    Type tileType = TypeRegistry.Find(tileData.type);
+                    if (tileType == null) throw new Exception($"存档类型不存在 {tileData.type}");
+
+                    ITileDefinition tile = TypeRegistry.CreateTile(tileType);
+                    tile.Pos = pos;
+                    tile.Map = map;
+                    tile.TileHashCode = HashUtility.Hash(pos.x, pos.y, width, height, (int)map.HashCode); // HashUtility.Hash((uint)(pos.x + pos.y * map.Width));
 
-                        IValues tileValues = Values.FromData(tileData.values);
-                        // if (tileValues == null) throw new Exception();
-                        tile.SetValues(tileValues);
+                    IValues tileValues = Values.FromData(tileData.values);
+                    // if (tileValues == null) throw new Exception();
+                    tile.SetValues(tileValues);
 
-                        IRefs tileRefs = Refs.FromData(tileData.references);
-                        // if (tileRefs == null) throw new Exception();
-                        tile.SetRefs(tileRefs);
-                        IInventory inventory = Inventory.FromData(tileData.inventory);
-                        // if (inventory == null) throw new Exception();
-                        tile.SetInventory(inventory);
+                    IRefs tileRefs = Refs.FromData(tileData.references);
+                    // if (tileRefs == null) throw new Exception();
+                    tile.SetRefs(tileRefs);
+                    IInventory inventory = Inventory.FromData(tileData.inventory);
+                    // if (inventory == null) throw new Exception();
+                    tile.SetInventory(inventory);
 
+                    loaded[pos.x * height + pos.y] = tile;
+                }
+                if (reader.TokenType != Newtonsoft.Json.JsonToken.EndObject) throw new Exception("地图存档格式错误");
+            }
+
+            // 8. 对于每一个地块, 通过SetTile塞到地图里, 顺序与以前一致
+            // obj => map
+            List<ITileDefinition> tiles = new List<ITileDefinition>(width * height);
+            Func<ITileDefinition> defaultTileFactory = TypeRegistry.TileFactory(map.DefaultTileType);
+            for (int i = 0; i < width; i++) {
+                for (int j = 0; j < height; j++) {
+                    Vector2Int pos = new Vector2Int(i, j);
+                    ITileDefinition tile = loaded[i * height + j];
+                    if (tile != null) {
                         map.SetTile(pos, tile);
                         tiles.Add(tile);
+                    } else if (map.SparseDefaultTiles) {
+                        map.SetTile(pos, null);
                     } else {
-                        ITileDefinition tile = Activator.CreateInstance(defaultTileType) as ITileDefinition;
-                        if (tile == null) throw new Exception();
-                        if (tile == null) throw new Exception();
+                        tile = defaultTileFactory();
                         tile.Pos = pos;
                         tile.Map = map;
-                        tile.TileHashCode = HashUtility.Hash(pos.x, pos.y, map.Width, map.Height, (int)map.HashCode); // HashUtility.Hash((uint)(pos.x + pos.y * map.Width));
+                        tile.TileHashCode = HashUtility.Hash(pos.x, pos.y, width, height, (int)map.HashCode); // HashUtility.Hash((uint)(pos.x + pos.y * map.Width));
 
                         map.SetTile(pos, tile);
                         tiles.Add(tile);
                     }
                 }
             }
-
-            if (tiles.Count != map.Width * map.Height) throw new Exception("存档地图大小与定义不一致");
-            foreach (var tile in tiles) {
-                tile.NeedUpdateSpriteKeys = true;
-                tile.OnEnable();
-            }
+            return tiles;
         }
 
 
 
         public void DeleteSaves() {
+            FlushSaves();
+            DropPrefetched(null);
+            mapBodyStates.Clear();
+            TerrainFieldCache.ClearMemory();
             DeleteFolder(SaveFullPath);
         }
         public void DeleteFolder(string directory) {
@@ -0,0 +1,28 @@
+﻿
+namespace Weathering
+{
+    /// <summary>
+    /// 增量存档的脏标记。Value, Ref, Inventory被修改时沿Owner一路通知到地块, 地块再标记地图中所在区块
+    /// </summary>
+    public interface ISaveDirty
+    {
+        void MarkSaveDirty();
+    }
+
+    /// <summary>
+    /// Values, Refs, Inventory实现, 被SetValues等赋给地块或地图时记录Owner
+    /// </summary>
+    public interface ISaveDirtyOwned
+    {
+        ISaveDirty SaveDirtyOwner { get; set; }
+    }
+
+    public static class SaveDirty
+    {
+        public static void Attach(object container, ISaveDirty owner) {
+            if (container is ISaveDirtyOwned owned) {
+                owned.SaveDirtyOwner = owner;
+            }
+        }
+    }
+}
@@ -0,0 +1,420 @@
+﻿
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Compression;
+using UnityEngine;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 地图地块的二进制存档格式
+    ///
+    /// 文件头: magic, 版本, 代数(v2), 宽高, 区块边长, 压缩方式(v3)
+    /// 类型表: 所有类型FullName只存一次
+    /// 区块目录: 每个区块定长记录 (偏移, 长度, 存档地块数), 长度为压缩后的长度
+    /// 区块数据: 区块内每格一个ushort类型下标(0为不存档, 读取时使用DefaultTileType), 随后为存档地块的Values, Refs, Inventory
+    /// 压缩时每个区块单独Deflate, 读取时一次只解压一个区块, 不需要整张地图的解压缓冲
+    ///
+    /// 增量存档日志: 追加写入的记录, 每条记录只包含脏区块, 区块编码与完整存档相同
+    /// 记录: magic, 长度, [代数, 区块边长, 类型表, 区块数, (区块下标, 长度, 区块数据)...], 结束标记
+    /// 只有代数与完整存档一致的记录才会被重放, 完整存档重写后旧日志自动失效
+    /// 日志记录很小, 不压缩
+    ///
+    /// 编码和压缩只读MapBodySnapshot, 存档时主线程只复制快照, 编码和压缩在存档线程
+    /// </summary>
+    public static class MapBodyFormat
+    {
+        public const uint Magic = 0x31424D57; // "WMB1"
+        public const int FormatVersion = 3;
+        public const int ChunkSize = 16;
+
+        public const uint JournalMagic = 0x314A4D57; // "WMJ1"
+
+        public const int CompressionNone = 0;
+        public const int CompressionDeflate = 1;
+
+        private const int headerSize = 4 * 5;
+        private const int chunkDirectoryEntrySize = 4 * 3;
+
+        public static int ChunkCountX(int width) => (width + ChunkSize - 1) / ChunkSize;
+        public static int ChunkCountY(int height) => (height + ChunkSize - 1) / ChunkSize;
+
+        public static int ChunkCount(IMap map) => ChunkCountX(map.Width) * ChunkCountY(map.Height);
+
+        public static byte[] Serialize(IMapDefinition map, long generation, bool compress) {
+            return Serialize(MapBodySnapshot.Capture(map, false), generation, compress);
+        }
+
+        /// <summary>
+        /// compress为true时区块数据用Deflate压缩。可以在存档线程调用
+        /// 压缩只在存档线程里花时间, 换来更小的存档和更快的读档, 但存档线程写完一次存档要更久
+        /// 区块逐个写入复用的缓冲再压缩进payload, 最后与文件头拼成一个数组, 内存中只有压缩后的存档和一个区块
+        /// </summary>
+        public static byte[] Serialize(MapBodySnapshot snapshot, long generation, bool compress) {
+            if (snapshot.DirtyOnly) throw new Exception("完整存档需要完整的快照");
+            int width = snapshot.Width;
+            int height = snapshot.Height;
+            int chunkCountX = ChunkCountX(width);
+            int chunkCountY = ChunkCountY(height);
+            int chunkCount = chunkCountX * chunkCountY;
+
+            SaveTypeTable table = new SaveTypeTable();
+            int[] offsets = new int[chunkCount];
+            int[] lengths = new int[chunkCount];
+            int[] tileCounts = new int[chunkCount];
+
+            // 先写区块数据, 同时收集类型表
+            MemoryStream payload = new MemoryStream();
+            MemoryStream chunk = new MemoryStream();
+            SnapshotCursor cursor = default;
+            using (BinaryWriter chunkWriter = new BinaryWriter(chunk, System.Text.Encoding.UTF8, true)) {
+                for (int cy = 0; cy < chunkCountY; cy++) {
+                    for (int cx = 0; cx < chunkCountX; cx++) {
+                        int k = cx + cy * chunkCountX;
+                        chunk.SetLength(0);
+                        tileCounts[k] = WriteChunk(snapshot, cx, cy, ref cursor, chunkWriter, table);
+                        chunkWriter.Flush();
+
+                        offsets[k] = (int)payload.Position;
+                        if (compress) {
+                            using (DeflateStream deflate = new DeflateStream(payload, CompressionLevel.Fastest, true)) {
+                                deflate.Write(chunk.GetBuffer(), 0, (int)chunk.Length);
+                            }
+                        } else {
+                            payload.Write(chunk.GetBuffer(), 0, (int)chunk.Length);
+                        }
+                        lengths[k] = (int)payload.Position - offsets[k];
+                    }
+                }
+            }
+
+            MemoryStream head = new MemoryStream(headerSize + 12 + chunkCount * chunkDirectoryEntrySize + 64 * table.Count);
+            using (BinaryWriter writer = new BinaryWriter(head, System.Text.Encoding.UTF8, true)) {
+                writer.Write(Magic);
+                writer.Write(FormatVersion);
+                writer.Write(generation);
+                writer.Write(width);
+                writer.Write(height);
+                writer.Write(ChunkSize);
+                writer.Write(compress ? CompressionDeflate : CompressionNone);
+
+                table.Write(writer);
+
+                for (int k = 0; k < chunkCount; k++) {
+                    writer.Write(offsets[k]);
+                    writer.Write(lengths[k]);
+                    writer.Write(tileCounts[k]);
+                }
+            }
+
+            byte[] result = new byte[head.Length + payload.Length];
+            Buffer.BlockCopy(head.GetBuffer(), 0, result, 0, (int)head.Length);
+            Buffer.BlockCopy(payload.GetBuffer(), 0, result, (int)head.Length, (int)payload.Length);
+            return result;
+        }
+
+        public static bool IsMapBody(byte[] bytes) {
+            return bytes != null && bytes.Length >= headerSize && BitConverter.ToUInt32(bytes, 0) == Magic;
+        }
+
+        public static byte[] SerializeJournalRecord(IMapDefinition map, long generation) {
+            return SerializeJournalRecord(MapBodySnapshot.Capture(map, true), generation);
+        }
+
+        /// <summary>
+        /// 快照中区块的日志记录, 追加到日志文件末尾。可以在存档线程调用
+        /// </summary>
+        public static byte[] SerializeJournalRecord(MapBodySnapshot snapshot, long generation) {
+            int chunkCountX = ChunkCountX(snapshot.Width);
+            List<int> indices = snapshot.Chunks;
+
+            SaveTypeTable table = new SaveTypeTable();
+            MemoryStream payload = new MemoryStream();
+            MemoryStream chunk = new MemoryStream();
+            SnapshotCursor cursor = default;
+            using (BinaryWriter payloadWriter = new BinaryWriter(payload, System.Text.Encoding.UTF8, true))
+            using (BinaryWriter chunkWriter = new BinaryWriter(chunk, System.Text.Encoding.UTF8, true)) {
+                foreach (int k in indices) {
+                    chunk.SetLength(0);
+                    WriteChunk(snapshot, k % chunkCountX, k / chunkCountX, ref cursor, chunkWriter, table);
+                    chunkWriter.Flush();
+                    payloadWriter.Write(k);
+                    payloadWriter.Write((int)chunk.Length);
+                    payloadWriter.Write(chunk.GetBuffer(), 0, (int)chunk.Length);
+                }
+            }
+
+            MemoryStream body = new MemoryStream((int)payload.Length + 64 * table.Count + 32);
+            using (BinaryWriter bodyWriter = new BinaryWriter(body, System.Text.Encoding.UTF8, true)) {
+                bodyWriter.Write(generation);
+                bodyWriter.Write(ChunkSize);
+                table.Write(bodyWriter);
+                bodyWriter.Write(indices.Count);
+                bodyWriter.Flush();
+                payload.Position = 0;
+                payload.CopyTo(body);
+            }
+
+            MemoryStream result = new MemoryStream((int)body.Length + 12);
+            using (BinaryWriter writer = new BinaryWriter(result, System.Text.Encoding.UTF8, true)) {
+                writer.Write(JournalMagic);
+                writer.Write((int)body.Length);
+                writer.Write(body.GetBuffer(), 0, (int)body.Length);
+                writer.Write(JournalMagic ^ (uint)body.Length);
+            }
+            return result.ToArray();
+        }
+
+        public const long NoGeneration = -1;
+
+        // 区块数据来源, 完整存档或某条日志记录
+        private struct ChunkSource
+        {
+            public BinaryReader Reader;
+            public long Position;
+            public int Length;
+            public bool Compressed; // 只有完整存档的区块可能压缩
+            public SaveTypeTable Table;
+        }
+
+        /// <summary>
+        /// 读取所有地块并SetTile到地图, 读到的地块按顺序加入tiles, 由调用者OnEnable
+        /// journal可为null。返回完整存档的代数, 如果此存档不能继续追加日志, 返回NoGeneration, 下次存档需要完整重写
+        /// </summary>
+        public static long Deserialize(IMapDefinition map, byte[] bytes, byte[] journal, List<ITileDefinition> tiles) {
+            using (BinaryReader reader = new BinaryReader(new MemoryStream(bytes, false)))
+            using (BinaryReader journalReader = journal == null ? null : new BinaryReader(new MemoryStream(journal, false))) {
+                if (reader.ReadUInt32() != Magic) throw new Exception("地图存档格式错误");
+                int version = reader.ReadInt32();
+                if (version > FormatVersion) throw new Exception($"地图存档版本过新 {version}");
+                long generation = version >= 2 ? reader.ReadInt64() : NoGeneration;
+                int width = reader.ReadInt32();
+                int height = reader.ReadInt32();
+                int chunkSize = reader.ReadInt32();
+                int compression = version >= 3 ? reader.ReadInt32() : CompressionNone;
+                if (width != map.Width || height != map.Height) throw new Exception("存档地图大小与定义不一致");
+                if (chunkSize <= 0) throw new Exception("地图存档区块大小错误");
+                if (compression != CompressionNone && compression != CompressionDeflate) throw new Exception($"地图存档压缩方式未知 {compression}");
+
+                SaveTypeTable table = SaveTypeTable.Read(reader);
+
+                int chunkCountX = (width + chunkSize - 1) / chunkSize;
+                int chunkCountY = (height + chunkSize - 1) / chunkSize;
+                int chunkCount = chunkCountX * chunkCountY;
+                int[] offsets = new int[chunkCount];
+                int[] lengths = new int[chunkCount];
+                for (int k = 0; k < chunkCount; k++) {
+                    offsets[k] = reader.ReadInt32();
+                    lengths[k] = reader.ReadInt32();
+                    reader.ReadInt32(); // tile count
+                }
+                long payloadStart = reader.BaseStream.Position;
+
+                ChunkSource[] sources = new ChunkSource[chunkCount];
+                for (int k = 0; k < chunkCount; k++) {
+                    sources[k] = new ChunkSource {
+                        Reader = reader,
+                        Position = payloadStart + offsets[k],
+                        Length = lengths[k],
+                        Compressed = compression == CompressionDeflate,
+                        Table = table,
+                    };
+                }
+
+                // 日志中同一区块后写的记录覆盖先写的
+                if (generation != NoGeneration && journalReader != null) {
+                    if (!ReadJournal(journalReader, generation, chunkSize, sources)) {
+                        generation = NoGeneration; // 日志末尾损坏, 下次完整重写
+                    }
+                }
+                if (chunkSize != ChunkSize) generation = NoGeneration;
+
+                ushort[] typeBuffer = new ushort[chunkSize * chunkSize];
+                uint[] hashBuffer = new uint[chunkSize];
+                MemoryStream chunk = null; // 解压缓冲, 所有区块复用
+                BinaryReader chunkReader = null;
+                try {
+                    for (int cy = 0; cy < chunkCountY; cy++) {
+                        for (int cx = 0; cx < chunkCountX; cx++) {
+                            ChunkSource source = sources[cx + cy * chunkCountX];
+                            BinaryReader sourceReader = source.Reader;
+                            if (source.Compressed) {
+                                if (chunk == null) {
+                                    chunk = new MemoryStream();
+                                    chunkReader = new BinaryReader(chunk);
+                                }
+                                Inflate(bytes, source.Position, source.Length, chunk);
+                                sourceReader = chunkReader;
+                            } else {
+                                sourceReader.BaseStream.Position = source.Position;
+                            }
+                            ReadChunk(map, cx, cy, chunkSize, sourceReader, source.Table, typeBuffer, hashBuffer, tiles);
+                        }
+                    }
+                } finally {
+                    chunkReader?.Dispose();
+                }
+                return generation;
+            }
+        }
+
+        private static void Inflate(byte[] bytes, long position, int length, MemoryStream target) {
+            if (position < 0 || length < 0 || position + length > bytes.Length) throw new Exception("地图存档区块越界");
+            target.SetLength(0);
+            using (DeflateStream deflate = new DeflateStream(new MemoryStream(bytes, (int)position, length, false), CompressionMode.Decompress)) {
+                deflate.CopyTo(target);
+            }
+            target.Position = 0;
+        }
+
+        /// <summary>
+        /// 返回false表示日志末尾有不完整的记录
+        /// </summary>
+        private static bool ReadJournal(BinaryReader reader, long generation, int chunkSize, ChunkSource[] sources) {
+            Stream stream = reader.BaseStream;
+            while (stream.Position < stream.Length) {
+                if (stream.Length - stream.Position < 8) return false;
+                if (reader.ReadUInt32() != JournalMagic) return false;
+                int length = reader.ReadInt32();
+                long bodyStart = stream.Position;
+                if (length < 0 || stream.Length - bodyStart < (long)length + 4) return false;
+                stream.Position = bodyStart + length;
+                if (reader.ReadUInt32() != (JournalMagic ^ (uint)length)) return false;
+                long next = stream.Position;
+
+                stream.Position = bodyStart;
+                long recordGeneration = reader.ReadInt64();
+                int recordChunkSize = reader.ReadInt32();
+                if (recordGeneration == generation && recordChunkSize == chunkSize) {
+                    SaveTypeTable table = SaveTypeTable.Read(reader);
+                    int count = reader.ReadInt32();
+                    for (int n = 0; n < count; n++) {
+                        int k = reader.ReadInt32();
+                        int chunkLength = reader.ReadInt32();
+                        if (k < 0 || k >= sources.Length) throw new Exception("存档日志区块下标越界");
+                        sources[k] = new ChunkSource { Reader = reader, Position = stream.Position, Length = chunkLength, Table = table };
+                        stream.Position += chunkLength;
+                    }
+                }
+                stream.Position = next;
+            }
+            return true;
+        }
+
+        // 按顺序读快照的位置, 每写一个区块前进
+        private struct SnapshotCursor
+        {
+            public int Cell;
+            public int Tile;
+            public int Value;
+            public int Ref;
+            public int Inventory;
+            public int Item;
+        }
+
+        private static int WriteChunk(MapBodySnapshot snapshot, int cx, int cy, ref SnapshotCursor cursor, BinaryWriter writer, SaveTypeTable table) {
+            int x0 = cx * ChunkSize;
+            int y0 = cy * ChunkSize;
+            int cellCount = (Math.Min(x0 + ChunkSize, snapshot.Width) - x0) * (Math.Min(y0 + ChunkSize, snapshot.Height) - y0);
+            List<Type> cellTypes = snapshot.CellTypes;
+
+            // 密集类型数组
+            int count = 0;
+            for (int n = cursor.Cell; n < cursor.Cell + cellCount; n++) {
+                Type type = cellTypes[n];
+                if (type == null) {
+                    writer.Write((ushort)0);
+                    continue;
+                }
+                int index = table.IndexOf(type) + 1;
+                if (index > ushort.MaxValue) throw new Exception("地块类型过多");
+                writer.Write((ushort)index);
+                count++;
+            }
+            cursor.Cell += cellCount;
+
+            // 地块数据, 与类型数组顺序一致。格式与Values.FromBinary, Refs.FromBinary, Inventory.FromBinary对应
+            List<int> counts = snapshot.ComponentCounts;
+            for (int t = 0; t < count; t++) {
+                int valueCount = counts[3 * cursor.Tile];
+                writer.Write(valueCount);
+                for (int n = 0; n < valueCount; n++) {
+                    writer.Write(table.IndexOf(snapshot.ValueTypes[cursor.Value]));
+                    Value.ToBinary(snapshot.ValueStates[cursor.Value], writer);
+                    cursor.Value++;
+                }
+
+                int refCount = counts[3 * cursor.Tile + 1];
+                writer.Write(refCount);
+                for (int n = 0; n < refCount; n++) {
+                    writer.Write(table.IndexOf(snapshot.RefTypes[cursor.Ref]));
+                    snapshot.RefStates[cursor.Ref].ToBinary(writer, table);
+                    cursor.Ref++;
+                }
+
+                int itemCount = counts[3 * cursor.Tile + 2];
+                writer.Write(itemCount);
+                if (itemCount >= 0) {
+                    writer.Write(snapshot.InventoryHeaders[3 * cursor.Inventory]);
+                    writer.Write(snapshot.InventoryHeaders[3 * cursor.Inventory + 1]);
+                    writer.Write((int)snapshot.InventoryHeaders[3 * cursor.Inventory + 2]);
+                    cursor.Inventory++;
+                    for (int n = 0; n < itemCount; n++) {
+                        writer.Write(table.IndexOf(snapshot.ItemTypes[cursor.Item]));
+                        writer.Write(snapshot.ItemValues[cursor.Item]);
+                        cursor.Item++;
+                    }
+                }
+                cursor.Tile++;
+            }
+            return count;
+        }
+
+        private static void ReadChunk(IMapDefinition map, int cx, int cy, int chunkSize, BinaryReader reader, SaveTypeTable table, ushort[] typeBuffer, uint[] hashBuffer, List<ITileDefinition> tiles) {
+            int width = map.Width;
+            int height = map.Height;
+            int x0 = cx * chunkSize;
+            int y0 = cy * chunkSize;
+            int x1 = Math.Min(x0 + chunkSize, width);
+            int y1 = Math.Min(y0 + chunkSize, height);
+
+            int n = 0;
+            for (int i = x0; i < x1; i++) {
+                for (int j = y0; j < y1; j++) {
+                    typeBuffer[n++] = reader.ReadUInt16();
+                }
+            }
+
+            bool sparse = map.SparseDefaultTiles;
+            ComponentStore store = map.ComponentStore;
+            Func<ITileDefinition> defaultTileFactory = TypeRegistry.TileFactory(map.DefaultTileType);
+            n = 0;
+            for (int i = x0; i < x1; i++) {
+                HashUtility.HashColumn(i, y0, width, height, (int)map.HashCode, hashBuffer, 0, y1 - y0);
+                for (int j = y0; j < y1; j++) {
+                    ushort index = typeBuffer[n++];
+                    if (index == 0 && sparse) {
+                        map.SetTile(new Vector2Int(i, j), null);
+                        continue;
+                    }
+                    ITileDefinition tile = index == 0 ? defaultTileFactory() : table.TileFactoryOf(index - 1)();
+                    Vector2Int pos = new Vector2Int(i, j);
+                    tile.Pos = pos;
+                    tile.Map = map;
+                    tile.TileHashCode = hashBuffer[j - y0];
+
+                    if (index != 0) {
+                        // 使用ComponentStore的地图直接读进数组
+                        tile.SetValues(store != null ? store.ReadValues(reader, table) : Values.FromBinary(reader, table));
+                        tile.SetRefs(store != null ? store.ReadRefs(reader, table) : Refs.FromBinary(reader, table));
+                        tile.SetInventory(Inventory.FromBinary(reader, table));
+                    }
+
+                    map.SetTile(pos, tile);
+                    tiles.Add(tile);
+                }
+            }
+        }
+    }
+}
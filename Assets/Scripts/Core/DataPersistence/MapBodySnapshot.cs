@@ -0,0 +1,82 @@
+﻿
+using System;
+using System.Collections.Generic;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 地图地块状态的副本, 在主线程复制, 在存档线程由MapBodyFormat编码和压缩
+    /// 1. 只复制地块类型和组件的结构体状态, 不查类型表, 不写二进制, 复制后地块可以继续修改
+    /// 2. 区块按存档顺序(先cy后cx), 区块内按格子顺序(先i后j)存放, 与MapBodyFormat.WriteChunk一致
+    /// 3. 组件的个数为-1表示null
+    /// </summary>
+    public class MapBodySnapshot
+    {
+        public int Width { get; private set; }
+        public int Height { get; private set; }
+        /// <summary>
+        /// 只复制了脏区块, 只能用于日志记录
+        /// </summary>
+        public bool DirtyOnly { get; private set; }
+
+        public readonly List<int> Chunks = new List<int>(); // 复制的区块下标
+
+        public readonly List<Type> CellTypes = new List<Type>(); // 每格一个, 不存档为null
+        public readonly List<int> ComponentCounts = new List<int>(); // 每个存档地块三个: Values, Refs, Inventory物品种类
+
+        public readonly List<Type> ValueTypes = new List<Type>();
+        public readonly List<ValueState> ValueStates = new List<ValueState>();
+        public readonly List<Type> RefTypes = new List<Type>();
+        public readonly List<RefState> RefStates = new List<RefState>();
+        public readonly List<long> InventoryHeaders = new List<long>(); // 每个背包三个: 数量, 数量容量, 种类容量
+        public readonly List<Type> ItemTypes = new List<Type>();
+        public readonly List<long> ItemValues = new List<long>();
+
+        /// <summary>
+        /// dirtyOnly为true时只复制IsChunkSaveDirty的区块
+        /// </summary>
+        public static MapBodySnapshot Capture(IMapDefinition map, bool dirtyOnly) {
+            MapBodySnapshot snapshot = new MapBodySnapshot {
+                Width = map.Width,
+                Height = map.Height,
+                DirtyOnly = dirtyOnly,
+            };
+            int chunkCountX = MapBodyFormat.ChunkCountX(map.Width);
+            int chunkCountY = MapBodyFormat.ChunkCountY(map.Height);
+            for (int cy = 0; cy < chunkCountY; cy++) {
+                for (int cx = 0; cx < chunkCountX; cx++) {
+                    if (dirtyOnly && !map.IsChunkSaveDirty(cx, cy)) continue;
+                    snapshot.Chunks.Add(cx + cy * chunkCountX);
+                    snapshot.CaptureChunk(map, cx, cy);
+                }
+            }
+            return snapshot;
+        }
+
+        private void CaptureChunk(IMapDefinition map, int cx, int cy) {
+            int x0 = cx * MapBodyFormat.ChunkSize;
+            int y0 = cy * MapBodyFormat.ChunkSize;
+            int x1 = Math.Min(x0 + MapBodyFormat.ChunkSize, map.Width);
+            int y1 = Math.Min(y0 + MapBodyFormat.ChunkSize, map.Height);
+            for (int i = x0; i < x1; i++) {
+                for (int j = y0; j < y1; j++) {
+                    // 稀疏存储中没有创建的默认地块, 不存档
+                    if (!map.IsTileMaterialized(i, j)) {
+                        CellTypes.Add(null);
+                        continue;
+                    }
+                    ITileDefinition tile = map.GetTileFast(i, j);
+                    if (tile == null) throw new Exception();
+                    if (tile is IDontSave saveOrNot && saveOrNot.DontSave) {
+                        CellTypes.Add(null);
+                        continue;
+                    }
+                    CellTypes.Add(tile.GetType());
+                    ComponentCounts.Add(Values.CopyStates(tile.Values, ValueTypes, ValueStates));
+                    ComponentCounts.Add(Refs.CopyStates(tile.Refs, RefTypes, RefStates));
+                    ComponentCounts.Add(Inventory.CopyItems(tile.Inventory, InventoryHeaders, ItemTypes, ItemValues));
+                }
+            }
+        }
+    }
+}
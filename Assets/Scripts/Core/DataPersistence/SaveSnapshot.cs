@@ -0,0 +1,55 @@
+﻿
+using System.Collections.Generic;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 一次存档的快照, 在主线程生成, 在存档线程按顺序执行
+    /// 只包含已经复制好的数据对象和地图快照, 执行时不会访问游戏对象
+    /// </summary>
+    public class SaveSnapshot
+    {
+        public enum OperationType
+        {
+            WriteJson, // 序列化Data为json, 原子替换文件
+            WriteMapBody, // 编码并压缩Data中的地图快照, 原子替换文件
+            AppendMapJournal, // 编码Data中的脏区块快照, 追加到文件末尾
+            Delete, // 如果存在则删除
+        }
+
+        public struct Operation
+        {
+            public OperationType Type;
+            public string Path;
+            public object Data;
+        }
+
+        public long Ticks { get; set; }
+
+        public List<Operation> Operations { get; } = new List<Operation>();
+
+        // 快照涉及的所有文件, 读档时如果文件还没写完需要等待
+        public HashSet<string> Paths { get; } = new HashSet<string>();
+
+        public void Add(OperationType type, string path, object data = null) {
+            Operations.Add(new Operation { Type = type, Path = path, Data = data });
+            Paths.Add(path);
+        }
+
+        /// <summary>
+        /// 合并后来的快照。会整体替换或删除文件的操作, 使之前对同一文件的操作失效
+        /// 追加操作必须保留
+        /// </summary>
+        public void Merge(SaveSnapshot later) {
+            foreach (var operation in later.Operations) {
+                if (operation.Type != OperationType.AppendMapJournal) {
+                    string path = operation.Path;
+                    Operations.RemoveAll(o => o.Path == path);
+                }
+                Operations.Add(operation);
+                Paths.Add(operation.Path);
+            }
+            Ticks = later.Ticks;
+        }
+    }
+}
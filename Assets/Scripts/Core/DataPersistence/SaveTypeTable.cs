@@ -0,0 +1,75 @@
+﻿
+using System;
+using System.Collections.Generic;
+using System.IO;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 二进制存档的类型字符串表。每个类型的FullName只写一次, 其他地方用下标引用
+    /// </summary>
+    public class SaveTypeTable
+    {
+        private readonly List<Type> types = new List<Type>();
+        private readonly Dictionary<Type, int> indices = new Dictionary<Type, int>();
+        private readonly List<Func<ITileDefinition>> tileFactories = new List<Func<ITileDefinition>>();
+
+        public int Count => types.Count;
+
+        /// <summary>
+        /// null 对应 -1
+        /// </summary>
+        public int IndexOf(Type type) {
+            if (type == null) return -1;
+            if (indices.TryGetValue(type, out int index)) {
+                return index;
+            }
+            index = types.Count;
+            types.Add(type);
+            indices.Add(type, index);
+            return index;
+        }
+
+        public Type TypeOf(int index) {
+            if (index < 0) return null;
+            if (index >= types.Count) throw new Exception($"存档类型下标越界 {index}");
+            return types[index];
+        }
+
+        /// <summary>
+        /// 读档时按下标创建地块, 构造委托只查一次
+        /// </summary>
+        public Func<ITileDefinition> TileFactoryOf(int index) {
+            while (tileFactories.Count <= index) {
+                tileFactories.Add(null);
+            }
+            Func<ITileDefinition> factory = tileFactories[index];
+            if (factory == null) {
+                factory = TypeRegistry.TileFactory(TypeOf(index));
+                tileFactories[index] = factory;
+            }
+            return factory;
+        }
+
+        public void Write(BinaryWriter writer) {
+            writer.Write(types.Count);
+            foreach (var type in types) {
+                writer.Write(type.FullName);
+            }
+        }
+
+        public static SaveTypeTable Read(BinaryReader reader) {
+            SaveTypeTable result = new SaveTypeTable();
+            int count = reader.ReadInt32();
+            if (count < 0) throw new Exception("存档类型表损坏");
+            for (int i = 0; i < count; i++) {
+                string name = reader.ReadString();
+                Type type = TypeRegistry.Find(name);
+                if (type == null) throw new Exception($"存档类型不存在 {name}");
+                result.types.Add(type);
+                result.indices.Add(type, i);
+            }
+            return result;
+        }
+    }
+}
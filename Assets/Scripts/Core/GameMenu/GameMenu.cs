@@ -31,6 +31,11 @@ namespace Weathering
     [Concept]
     public class GameMenuResetGameConfirmation { }
 
+    [Concept]
+    public class GameMenuAutoLinkMap { }
+    [Concept]
+    public class GameMenuAutoLinkMapResult { }
+
     [Concept]
     public class GameMenuLabel { }
 
@@ -52,6 +57,10 @@ namespace Weathering
     public class EnableLight { }
     [Concept]
     public class EnableWeather { }
+    [Concept]
+    public class EnablePerformanceOverlay { }
+    [Concept]
+    public class UseChunkedMapRenderer { }
 
 
     [Concept]
@@ -97,6 +106,7 @@ namespace Weathering
 #endif
             offset = IsInStandalone ? 36 : 0;
             InitializeNotification();
+            gameObject.AddComponent<PerformanceOverlay>();
 
             //fullScreenWidth = Screen.width;
             //fullScreenHeight = Screen.height;
@@ -244,6 +254,8 @@ namespace Weathering
 
             globals.Bool<EnableLight>(true);
             globals.Bool<EnableWeather>(true);
+            globals.Bool<EnablePerformanceOverlay>(false);
+            globals.Bool<UseChunkedMapRenderer>(false);
         }
 
         public void SynchronizeSettings() {
@@ -257,6 +269,8 @@ namespace Weathering
             //SyncDoubleSize();
             SyncUserInterfaceBackgroundTransparency();
             SyncUtilityButtonPosition();
+            SyncPerformanceOverlay();
+            SyncChunkedMapRenderer();
         }
 
         public const float VolumeFactor = 1000f;
@@ -280,6 +294,12 @@ namespace Weathering
             WeatherEnabled = Globals.Ins.Bool<EnableWeather>();
             (MapView.Ins as MapView).EnableWeather = WeatherEnabled;
         }
+        private void SyncPerformanceOverlay() {
+            PerformanceOverlay.Ins.enabled = Globals.Ins.Bool<EnablePerformanceOverlay>();
+        }
+        private void SyncChunkedMapRenderer() {
+            MapView.Ins.UseChunkedRenderer = Globals.Ins.Bool<UseChunkedMapRenderer>();
+        }
         public void SyncToneMapping() {
             long val = Globals.Ins.Values.GetOrCreate<ToneMapping>().Max;
             switch (val) {
@@ -490,6 +510,12 @@ namespace Weathering
 
                 UIItem.CreateButton(Localization.Ins.Get<GameMenuSaveGame>(), OnTapSaveGameButton),
 
+                map is IMapDefinition mapDefinition ? UIItem.CreateButton(Localization.Ins.Get<GameMenuAutoLinkMap>(), () => {
+                    int count = LinkUtility.AutoLinkMap(mapDefinition);
+                    PushNotification(string.Format(Localization.Ins.Get<GameMenuAutoLinkMapResult>(), count));
+                    OnTapSettings();
+                }) : null,
+
                 UIItem.CreateButton(Localization.Ins.Get<GameMenuExitGame>(), UIDecorator.ConfirmBefore(() => Entry.ExitGame(), OnTapSettings)),
 
                 UIItem.CreateButton(string.Format(Localization.Ins.Get<GameMenuLanguageLabel>(), Localization.Ins.Get<GameLanguage>()), () => {
@@ -715,6 +741,31 @@ namespace Weathering
                     }
                 },
 
+                new UIItem {
+                    Type = IUIItemType.Button,
+                    Content = Globals.Ins.Bool<EnablePerformanceOverlay>() ? $"性能面板：启用" : $"性能面板：禁用",
+                    OnTap = () => {
+                        Globals.Ins.Bool<EnablePerformanceOverlay>(!Globals.Ins.Bool<EnablePerformanceOverlay>());
+                        SyncPerformanceOverlay();
+                        OpenGameSettingMenu();
+                    }
+                },
+
+                Globals.Ins.Bool<EnablePerformanceOverlay>() ? UIItem.CreateButton("导出性能记录", () => {
+                    string path = PerformanceOverlay.Ins.ExportCsv();
+                    UI.Ins.ShowItems("导出性能记录", UIItem.CreateReturnButton(OpenGameSettingMenu), UIItem.CreateMultilineText($"最近{PerformanceCounters.FrameCount}帧已导出到\n{path}"));
+                }) : null,
+
+                new UIItem {
+                    Type = IUIItemType.Button,
+                    Content = Globals.Ins.Bool<UseChunkedMapRenderer>() ? $"地图渲染：区块网格" : $"地图渲染：Tilemap",
+                    OnTap = () => {
+                        Globals.Ins.Bool<UseChunkedMapRenderer>(!Globals.Ins.Bool<UseChunkedMapRenderer>());
+                        SyncChunkedMapRenderer();
+                        OpenGameSettingMenu();
+                    }
+                },
+
                 UIItem.CreateSeparator(),
 
 
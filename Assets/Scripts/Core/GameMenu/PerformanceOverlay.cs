@@ -0,0 +1,85 @@
+﻿
+using System.Text;
+using UnityEngine;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 性能面板, 在GameMenu设置里开关
+    /// 启用时每帧LateUpdate结束一帧的统计, 画面左上角显示最近的平均耗时和计数。禁用时不统计也不绘制
+    /// 文本每隔refreshInterval秒才重新生成, 面板自身的分配尽量不影响统计
+    /// </summary>
+    public class PerformanceOverlay : MonoBehaviour
+    {
+        public static PerformanceOverlay Ins { get; private set; }
+
+        private const float refreshInterval = 0.25f;
+        private const int averageFrames = 60;
+
+        private long frame = 0;
+        private float lastRefreshTime = 0;
+        private readonly StringBuilder sb = new StringBuilder(512);
+        private readonly GUIContent content = new GUIContent();
+        private GUIStyle style;
+
+        private void Awake() {
+            if (Ins != null) throw new System.Exception();
+            Ins = this;
+            enabled = false;
+        }
+
+        private void OnEnable() {
+            PerformanceCounters.SetRecording(true);
+            lastRefreshTime = 0;
+        }
+        private void OnDisable() {
+            PerformanceCounters.SetRecording(false);
+        }
+
+        private void LateUpdate() {
+            PerformanceCounters.EndFrame(frame++, Time.realtimeSinceStartup, Time.unscaledDeltaTime);
+            float time = Time.unscaledTime;
+            if (time - lastRefreshTime >= refreshInterval) {
+                lastRefreshTime = time;
+                RefreshText();
+            }
+        }
+
+        private void RefreshText() {
+            sb.Clear();
+            float deltaMs = PerformanceCounters.AverageDeltaMs(averageFrames);
+            sb.Append("帧 ").Append(deltaMs.ToString("F2")).Append(" ms");
+            if (deltaMs > 0) sb.Append("  ").Append((1000f / deltaMs).ToString("F0")).Append(" fps");
+            sb.Append('\n');
+            for (int k = 0; k < PerformanceCounters.SectionCount; k++) {
+                PerformanceSection section = (PerformanceSection)k;
+                sb.Append(section.ToString()).Append(' ').Append(PerformanceCounters.AverageSectionMs(section, averageFrames).ToString("F3")).Append(" ms\n");
+            }
+            for (int k = 0; k < PerformanceCounters.CounterCount; k++) {
+                PerformanceCounter counter = (PerformanceCounter)k;
+                sb.Append(counter.ToString()).Append(' ').Append(PerformanceCounters.CounterValue(counter)).Append('\n');
+            }
+            sb.Append("GC.Alloc ").Append((PerformanceCounters.GCAllocBytes() / 1024f).ToString("F1")).Append(" KB");
+            sb.Append("  GC ").Append(PerformanceCounters.GCCollections());
+            content.text = sb.ToString();
+        }
+
+        private void OnGUI() {
+            if (style == null) {
+                style = new GUIStyle(GUI.skin.box) {
+                    alignment = TextAnchor.UpperLeft,
+                    fontSize = 14,
+                };
+            }
+            Vector2 size = style.CalcSize(content);
+            GUI.Box(new Rect(8, 8, size.x, size.y), content, style);
+        }
+
+        /// <summary>
+        /// 导出最近的逐帧记录, 返回文件路径
+        /// </summary>
+        public string ExportCsv() {
+            return PerformanceCounters.ExportCsv(Application.persistentDataPath + "/performance/");
+        }
+    }
+}
@@ -14,6 +14,21 @@ namespace Weathering
     {
         public static string Decorated(string name) => $"{name}_Working";
 
+        // 下标是原贴图id
+        private static readonly System.Collections.Generic.List<int> decoratedIds = new System.Collections.Generic.List<int>();
+        public static int Decorated(int spriteId) {
+            if (spriteId == Res.NoSprite) return Res.NoSprite;
+            while (decoratedIds.Count <= spriteId) {
+                decoratedIds.Add(Res.NoSprite);
+            }
+            int result = decoratedIds[spriteId];
+            if (result == Res.NoSprite) {
+                result = Res.SpriteId(Decorated(Res.SpriteName(spriteId)));
+                decoratedIds[spriteId] = result;
+            }
+            return result;
+        }
+
         public static GlobalLight Ins { get; private set; }
 
         [SerializeField]
@@ -92,15 +92,21 @@ namespace Weathering
         void SetQuantity(long value);
     }
 
-    public class Inventory : IInventoryDefinition
+    public class Inventory : IInventoryDefinition, ISaveDirtyOwned
     {
         public bool Maxed { get => Quantity == QuantityCapacity; }
         public bool Empty { get => Quantity == 0; }
         public int TypeCount { get => Dict.Count; }
-        public int TypeCapacity { get; set; }
 
-        public long Quantity { get; private set; }
-        public long QuantityCapacity { get; set; }
+        // 物品增减都会改变Quantity, 在setter里标记存档
+        public ISaveDirty SaveDirtyOwner { get; set; } = null;
+        private int typeCapacity;
+        private long quantity;
+        private long quantityCapacity;
+        public int TypeCapacity { get => typeCapacity; set { typeCapacity = value; SaveDirtyOwner?.MarkSaveDirty(); } }
+
+        public long Quantity { get => quantity; private set { quantity = value; SaveDirtyOwner?.MarkSaveDirty(); } }
+        public long QuantityCapacity { get => quantityCapacity; set { quantityCapacity = value; SaveDirtyOwner?.MarkSaveDirty(); } }
 
         public void SetQuantity(long value) => Quantity = value;
 
@@ -108,6 +114,48 @@ namespace Weathering
 
         public Dictionary<Type, InventoryItemData> Dict { get; private set; } = null;
 
+        /// <summary>
+        /// 标签 => 背包里带这个标签的物品种类, 第一次按标签查询时建立
+        /// 之后只在物品种类出现或消失时更新, 按标签查询和移除只遍历匹配的种类
+        /// </summary>
+        private class TagBucket
+        {
+            public int TagIndex;
+            public readonly List<Type> Types = new List<Type>();
+        }
+        private Dictionary<Type, TagBucket> tagBuckets = null;
+
+        private List<Type> TypesWithTag(Type tag) {
+            if (tagBuckets == null) {
+                tagBuckets = new Dictionary<Type, TagBucket>();
+            }
+            if (!tagBuckets.TryGetValue(tag, out TagBucket bucket)) {
+                bucket = new TagBucket { TagIndex = Tag.IndexOf(tag) };
+                foreach (var pair in Dict) {
+                    if (pair.Key == tag || Tag.HasTag(Tag.IndexOf(pair.Key), bucket.TagIndex)) {
+                        bucket.Types.Add(pair.Key);
+                    }
+                }
+                tagBuckets.Add(tag, bucket);
+            }
+            return bucket.Types;
+        }
+        private void OnTypeAdded(Type type) {
+            if (tagBuckets == null) return;
+            int typeIndex = Tag.IndexOf(type);
+            foreach (var pair in tagBuckets) {
+                if (pair.Key == type || Tag.HasTag(typeIndex, pair.Value.TagIndex)) {
+                    pair.Value.Types.Add(type);
+                }
+            }
+        }
+        private void OnTypeRemoved(Type type) {
+            if (tagBuckets == null) return;
+            foreach (var pair in tagBuckets) {
+                pair.Value.Types.Remove(type);
+            }
+        }
+
 
         public long CanRemove(Type type) {
             if (Dict.TryGetValue(type, out InventoryItemData value)) {
@@ -130,6 +178,7 @@ namespace Weathering
                 Dict[type] = Dict[type].AddVal(val);
             } else {
                 Dict.Add(type, new InventoryItemData { value = val });
+                OnTypeAdded(type);
             }
             Quantity += val;
             return true;
@@ -169,6 +218,7 @@ namespace Weathering
                 } else {
                     if (val == Dict[type].value) {
                         Dict.Remove(type);
+                        OnTypeRemoved(type);
                     } else {
                         Dict[type] = Dict[type].AddVal(-val);
                     }
@@ -254,22 +304,18 @@ namespace Weathering
         public bool RemoveWithTag(Type type, long val, Dictionary<Type, InventoryItemData> canRemove = null, Dictionary<Type, InventoryItemData> removed = null) {
             if (canRemove == null) {
                 if (val == 0) return true;
+                List<Type> types = TypesWithTag(type);
                 while (val != 0) {
-                    bool found = false;
-                    foreach (var pair in Dict) {
-                        if (Tag.HasTag(pair.Key, type)) {
-                            long max = Math.Min(val, pair.Value.value);
-                            bool result = Remove(pair.Key, max);
-                            if (!result) throw new Exception(pair.Key.Name);
-                            if (removed != null) {
-                                removed.Add(pair.Key, new InventoryItemData { value = max });
-                            }
-                            val -= max;
-                            found = true;
-                            break;
-                        }
+                    // 取完的种类会从types里移除, 所以总是取第一个
+                    if (types.Count == 0) throw new Exception($"remove with tag. item not found : {type}");
+                    Type itemType = types[0];
+                    long max = Math.Min(val, Dict[itemType].value);
+                    bool result = Remove(itemType, max);
+                    if (!result) throw new Exception(itemType.Name);
+                    if (removed != null) {
+                        removed.Add(itemType, new InventoryItemData { value = max });
                     }
-                    if (!found) throw new Exception($"remove with tag. item not found : {type}");
+                    val -= max;
                 }
                 if (val != 0) throw new Exception();
                 return true;
@@ -310,21 +356,24 @@ namespace Weathering
         }
         public long CanRemoveWithTag(Type type, Dictionary<Type, InventoryItemData> canRemoveAccumulated = null, long val = long.MaxValue) {
             long result = 0;
-            foreach (var pair in Dict) {
-                if (Tag.HasTag(pair.Key, type)) {
-                    long min = Math.Min(val, pair.Value.value);
-                    if (min == 0) continue;
-                    val -= min;
-                    result += min;
-                    if (canRemoveAccumulated != null) {
-                        if (canRemoveAccumulated.ContainsKey(pair.Key)) {
-                            canRemoveAccumulated[pair.Key] = new InventoryItemData { value = canRemoveAccumulated[pair.Key].value + min };
-                        } else {
-                            canRemoveAccumulated.Add(
-                                pair.Key,
-                                new InventoryItemData { value = min }
-                            );
-                        }
+            foreach (var itemType in TypesWithTag(type)) {
+                long available = Dict[itemType].value;
+                // 已被之前的预计算占用的部分不能重复计入
+                if (canRemoveAccumulated != null && canRemoveAccumulated.TryGetValue(itemType, out InventoryItemData reserved)) {
+                    available -= reserved.value;
+                }
+                long min = Math.Min(val, available);
+                if (min <= 0) continue;
+                val -= min;
+                result += min;
+                if (canRemoveAccumulated != null) {
+                    if (canRemoveAccumulated.ContainsKey(itemType)) {
+                        canRemoveAccumulated[itemType] = new InventoryItemData { value = canRemoveAccumulated[itemType].value + min };
+                    } else {
+                        canRemoveAccumulated.Add(
+                            itemType,
+                            new InventoryItemData { value = min }
+                        );
                     }
                 }
             }
@@ -427,6 +476,11 @@ namespace Weathering
 
         public void Clear() {
             Dict.Clear();
+            if (tagBuckets != null) {
+                foreach (var pair in tagBuckets) {
+                    pair.Value.Types.Clear();
+                }
+            }
             Quantity = 0;
         }
 
@@ -461,7 +515,7 @@ namespace Weathering
             long vertify = 0;
             foreach (var pair in data.inventory_dict) {
                 vertify += pair.Value.value;
-                result.Dict.Add(Type.GetType(pair.Key), pair.Value);
+                result.Dict.Add(TypeRegistry.Find(pair.Key), pair.Value);
             }
             if (vertify != data.inventory_quantity) throw new Exception("存档背包物品数量错误");
             result.SetQuantity(data.inventory_quantity);
@@ -472,6 +526,47 @@ namespace Weathering
             return result;
         }
 
+        /// <summary>
+        /// 存档快照, 依次复制数量, 数量容量, 种类容量到header, 再复制所有物品, 返回物品种类数。null 返回 -1
+        /// </summary>
+        public static int CopyItems(IInventory inventory, List<long> header, List<Type> types, List<long> values) {
+            if (inventory == null) return -1;
+            IInventoryDefinition definition = inventory as IInventoryDefinition;
+            if (definition == null) throw new Exception();
+            if (definition.Dict == null) throw new Exception();
+
+            header.Add(definition.Quantity);
+            header.Add(definition.QuantityCapacity);
+            header.Add(definition.TypeCapacity);
+            foreach (var pair in definition.Dict) {
+                types.Add(pair.Key);
+                values.Add(pair.Value.value);
+            }
+            return definition.Dict.Count;
+        }
+
+        public static IInventory FromBinary(System.IO.BinaryReader reader, SaveTypeTable table) {
+            int count = reader.ReadInt32();
+            if (count < 0) return null;
+
+            IInventoryDefinition result = GetOne();
+            long quantity = reader.ReadInt64();
+            result.QuantityCapacity = reader.ReadInt64();
+            result.TypeCapacity = reader.ReadInt32();
+
+            long vertify = 0;
+            for (int i = 0; i < count; i++) {
+                Type type = table.TypeOf(reader.ReadInt32());
+                long value = reader.ReadInt64();
+                vertify += value;
+                result.Dict.Add(type, new InventoryItemData { value = value });
+            }
+            if (vertify != quantity) throw new Exception("存档背包物品数量错误");
+            result.SetQuantity(quantity);
+
+            return result;
+        }
+
         public static Inventory GetOne() {
             return new Inventory {
                 Dict = new Dictionary<Type, InventoryItemData>(),
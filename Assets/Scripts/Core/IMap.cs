@@ -42,6 +42,11 @@ namespace Weathering
         string GetSpriteKeyGrass(Vector2Int pos);
         string GetSpriteKeyTree(Vector2Int pos);
         string GetSpriteKeyHill(Vector2Int pos);
+        int GetSpriteIdBedrock(Vector2Int pos);
+        int GetSpriteIdWater(Vector2Int pos);
+        int GetSpriteIdGrass(Vector2Int pos);
+        int GetSpriteIdTree(Vector2Int pos);
+        int GetSpriteIdHill(Vector2Int pos);
 
 
         bool CanUpdateAt<T>(Vector2Int pos);
@@ -56,6 +61,10 @@ namespace Weathering
 
         T UpdateAt<T>(ITile oldTile) where T : class, ITile;
         ITile UpdateAt(Type type, ITile oldTile);
+        /// <summary>
+        /// 一次建造多个地块, 见ConstructionBatch
+        /// </summary>
+        int UpdateAt(ConstructionBatch batch);
     }
 
     public interface IMapDefinition : IMap, ISavableDefinition
@@ -74,12 +83,28 @@ namespace Weathering
 
         ITileDefinition GetTileFast(int i, int j);
 
+        // 稀疏存储, 没有修改过的默认地块在第一次Get时才创建
+        bool SparseDefaultTiles { get; }
+        ComponentStore ComponentStore { get; } // 不使用时为null
+        LinkGraph LinkGraph { get; }
+        bool IsTileMaterialized(int i, int j);
+        void ConstructSparseDefaultTiles();
+
         // void AfterGeneration();
 
         void OnTapTile(ITile tile);
 
         bool CanDelete { get; }
         void Delete();
+
+        // 增量存档, 区块按MapBodyFormat.ChunkSize划分
+        bool HeadSaveDirty { get; }
+        bool BodySaveDirty { get; }
+        int SaveDirtyChunkCount { get; }
+        bool IsChunkSaveDirty(int chunkX, int chunkY);
+        void MarkSaveDirty(Vector2Int pos);
+        void ClearHeadSaveDirty();
+        void ClearBodySaveDirty();
     }
 }
 
@@ -29,17 +29,77 @@ namespace Weathering
         public long y;
     }
 
+    /// <summary>
+    /// ComponentStore里连续存放的Ref
+    /// </summary>
+    public struct RefState
+    {
+        public Type type;
+        public long baseValue;
+        public long value;
+        public Type left;
+        public Type right;
+        public long x;
+        public long y;
+
+        public static RefState Of(IRef r) {
+            return new RefState {
+                type = r.Type,
+                baseValue = r.BaseValue,
+                value = r.Value,
+                left = r.Left,
+                right = r.Right,
+                x = r.X,
+                y = r.Y,
+            };
+        }
+
+        // 不保存BaseType, 与Ref.ToData一致
+        public void ToBinary(System.IO.BinaryWriter writer, SaveTypeTable table) {
+            writer.Write(table.IndexOf(type));
+            writer.Write(baseValue);
+            writer.Write(value);
+            writer.Write(table.IndexOf(left));
+            writer.Write(table.IndexOf(right));
+            writer.Write(x);
+            writer.Write(y);
+        }
+        public static RefState FromBinary(System.IO.BinaryReader reader, SaveTypeTable table) {
+            return new RefState {
+                type = table.TypeOf(reader.ReadInt32()),
+                baseValue = reader.ReadInt64(),
+                value = reader.ReadInt64(),
+                left = table.TypeOf(reader.ReadInt32()),
+                right = table.TypeOf(reader.ReadInt32()),
+                x = reader.ReadInt64(),
+                y = reader.ReadInt64(),
+            };
+        }
+    }
+
     public class Ref : IRef
     {
         public Type BaseType { get; set; } = null;
-        public Type Type { get; set; } = null;
-        public long BaseValue { get; set; } = 0;
-        public long Value { get; set; } = 0;
 
-        public Type Left { get; set; } = null;
-        public Type Right { get; set; } = null;
-        public long X { get; set; } = 0;
-        public long Y { get; set; } = 0;
+        private Type type = null;
+        private long baseValue = 0;
+        private long value = 0;
+        private Type left = null;
+        private Type right = null;
+        private long x = 0;
+        private long y = 0;
+
+        // 所属Refs, 修改时标记存档
+        internal ISaveDirty owner = null;
+
+        public Type Type { get => type; set { type = value; owner?.MarkSaveDirty(); } }
+        public long BaseValue { get => baseValue; set { baseValue = value; owner?.MarkSaveDirty(); } }
+        public long Value { get => this.value; set { this.value = value; owner?.MarkSaveDirty(); } }
+
+        public Type Left { get => left; set { left = value; owner?.MarkSaveDirty(); } }
+        public Type Right { get => right; set { right = value; owner?.MarkSaveDirty(); } }
+        public long X { get => x; set { x = value; owner?.MarkSaveDirty(); } }
+        public long Y { get => y; set { y = value; owner?.MarkSaveDirty(); } }
 
         public static RefData ToData(IRef r) {
             return new RefData {
@@ -56,17 +116,28 @@ namespace Weathering
         }
         public static IRef FromData(RefData rData) {
             return Create(
-                rData.base_type == null ? null : Type.GetType(rData.base_type),
-                rData.type == null ? null : Type.GetType(rData.type),
+                rData.base_type == null ? null : TypeRegistry.Find(rData.base_type),
+                rData.type == null ? null : TypeRegistry.Find(rData.type),
                 rData.base_val,
                 rData.val,
-                rData.left == null ? null : Type.GetType(rData.left), 
-                rData.right == null ? null : Type.GetType(rData.right),
+                rData.left == null ? null : TypeRegistry.Find(rData.left), 
+                rData.right == null ? null : TypeRegistry.Find(rData.right),
                 rData.x, 
                 rData.y
                 );
         }
 
+        public static IRef FromBinary(System.IO.BinaryReader reader, SaveTypeTable table) {
+            Type type = table.TypeOf(reader.ReadInt32());
+            long baseValue = reader.ReadInt64();
+            long value = reader.ReadInt64();
+            Type left = table.TypeOf(reader.ReadInt32());
+            Type right = table.TypeOf(reader.ReadInt32());
+            long x = reader.ReadInt64();
+            long y = reader.ReadInt64();
+            return Create(null, type, baseValue, value, left, right, x, y);
+        }
+
         public static Ref Create(
             Type base_type,
             Type type,
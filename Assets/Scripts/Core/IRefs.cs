@@ -23,11 +23,23 @@ namespace Weathering
         Dictionary<Type, IRef> Dict { get; }
     }
 
-    public class Refs : IRefs
+    public class Refs : IRefs, ISaveDirty, ISaveDirtyOwned
     {
         private Refs() { }
         public Dictionary<Type, IRef> Dict { get; set; } = null;
 
+        private ISaveDirty saveDirtyOwner = null;
+        public ISaveDirty SaveDirtyOwner {
+            get => saveDirtyOwner;
+            set {
+                saveDirtyOwner = value;
+                foreach (var pair in Dict) {
+                    if (pair.Value is Ref r) r.owner = this;
+                }
+            }
+        }
+        public void MarkSaveDirty() => saveDirtyOwner?.MarkSaveDirty();
+
         public static Dictionary<string, RefData> ToData(IRefs refs) {
             if (refs == null) return null;
             Dictionary<string, RefData> data = new Dictionary<string, RefData>();
@@ -41,13 +53,37 @@ namespace Weathering
             if (data == null) return null;
             IRefs result = GetOne();
             foreach (var pair in data) {
-                Type type = Type.GetType(pair.Key);
+                Type type = TypeRegistry.Find(pair.Key);
                 IRef value = Ref.FromData(pair.Value);
                 result.Dict.Add(type, value);
             }
             return result;
         }
 
+        /// <summary>
+        /// 存档快照, 复制所有引用的状态, 返回个数。null 返回 -1
+        /// </summary>
+        public static int CopyStates(IRefs refs, List<Type> types, List<RefState> states) {
+            if (refs == null) return -1;
+            if (refs is StoredRefs stored) return stored.CopyStates(types, states);
+            foreach (var pair in refs.Dict) {
+                types.Add(pair.Key);
+                states.Add(RefState.Of(pair.Value));
+            }
+            return refs.Dict.Count;
+        }
+        public static IRefs FromBinary(System.IO.BinaryReader reader, SaveTypeTable table) {
+            int count = reader.ReadInt32();
+            if (count < 0) return null;
+            IRefs result = GetOne();
+            for (int i = 0; i < count; i++) {
+                Type type = table.TypeOf(reader.ReadInt32());
+                IRef value = Ref.FromBinary(reader, table);
+                result.Dict.Add(type, value);
+            }
+            return result;
+        }
+
         public static IRefs GetOne() {
             return new Refs {
                 Dict = new Dictionary<Type, IRef>()
@@ -78,9 +114,11 @@ namespace Weathering
             if (Dict.TryGetValue(type, out IRef value)) {
                 throw new Exception("已有：" + type.FullName);
             } else {
-                value = Ref.Create(null, null, 0, 0, null, null, 0, 0);
-                Dict.Add(type, value);
-                return value;
+                Ref r = Ref.Create(null, null, 0, 0, null, null, 0, 0);
+                r.owner = this;
+                Dict.Add(type, r);
+                MarkSaveDirty();
+                return r;
             }
         }
 
@@ -91,9 +129,11 @@ namespace Weathering
             if (Dict.TryGetValue(type, out IRef value)) {
                 return value;
             } else {
-                value = Ref.Create(null, null, 0, 0, null, null, 0, 0);
-                Dict.Add(type, value);
-                return value;
+                Ref r = Ref.Create(null, null, 0, 0, null, null, 0, 0);
+                r.owner = this;
+                Dict.Add(type, r);
+                MarkSaveDirty();
+                return r;
             }
         }
 
@@ -116,6 +156,7 @@ namespace Weathering
         public void Remove(Type type) {
             if (Dict.ContainsKey(type)) {
                 Dict.Remove(type);
+                MarkSaveDirty();
                 return;
             }
             throw new Exception(type.FullName);
@@ -56,6 +56,21 @@ namespace Weathering
         string SpriteKeyOverlay { get; }
         Tile TileSpriteKeyOverlayBuffer { get; set; }
 
+        // 渲染用的整数贴图id, 见Res.SpriteId。默认由上面的字符串转换
+        int SpriteIdBedrock { get; }
+        int SpriteIdWater { get; }
+        int SpriteIdGrass { get; }
+        int SpriteIdTree { get; }
+        int SpriteIdHill { get; }
+        int SpriteIdRoad { get; }
+        int SpriteIdLeft { get; }
+        int SpriteIdRight { get; }
+        int SpriteIdUp { get; }
+        int SpriteIdDown { get; }
+        int SpriteId { get; }
+        int SpriteIdHighLight { get; }
+        int SpriteIdOverlay { get; }
+
         IMap Map { get; set; }
         UnityEngine.Vector2Int Pos { get; set; }
         uint TileHashCode { get; set; }
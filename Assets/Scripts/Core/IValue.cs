@@ -35,42 +35,21 @@ namespace Weathering
         public long max = 0;
     }
 
-    public class Value : IValue
+    /// <summary>
+    /// Value的全部状态和计算逻辑。Value和ComponentStore里的StoredValue共用
+    /// 结构体方法直接修改字段或数组元素, 不产生分配
+    /// </summary>
+    public struct ValueState
     {
-        private Value() { }
-
-        public static ValueData ToData(IValue value) {
-            Value v = value as Value;
-            if (v == null) throw new Exception();
-            return new ValueData {
-                time = v.time,
-                inc = v.inc,
-                dec = v.dec,
-                del = v.del,
-                val = v.val,
-                max = v.max,
-            };
-        }
-        public static IValue FromData(ValueData data) {
-            return Create(data.val, data.max, data.inc, data.dec, data.del, data.time);
-        }
-
-        public const long MiniSecond = 10000;
-        public const long Second = 1000 * MiniSecond;
-        public const long Minute = 60 * Second;
-        public const long Hour = 60 * Minute;
-        public const long Day = 24 * Hour;
-
-        private long time = 0;
-        private long val = 0;
-        private long inc = 0; // val difference
-        private long dec = 0; // val difference
-        private long del = Value.Second; // time diffence
-        private long max = 0; // val limit
+        public long time;
+        public long val;
+        public long inc; // val difference
+        public long dec; // val difference
+        public long del; // time diffence
+        public long max; // val limit
 
-
-        public static Value Create(long val, long max, long inc, long dec, long del, long time) {
-            return new Value {
+        public static ValueState Create(long val, long max, long inc, long dec, long del, long time) {
+            return new ValueState {
                 time = time,
                 val = val,
                 inc = inc,
@@ -89,50 +68,32 @@ namespace Weathering
             time += times * del;
         }
 
-        public long Time { get => time; set => time = value; }
-
-        public long Max {
-            get => max;
-            set {
-                Synchronize();
-                if (Maxed) {
-                    time = TimeUtility.GetTicks();
-                }
-                max = value;
-            }
-        }
-        public long Del {
-            get => del;
-            set {
-                Synchronize();
+        public void SetMax(long value) {
+            Synchronize();
+            if (Maxed) {
                 time = TimeUtility.GetTicks();
-                del = value;
             }
+            max = value;
         }
-
-        public long Inc {
-            get => inc;
-            set {
-                Synchronize();
-                inc = value;
-                if (inc == 0) {
-                    time = TimeUtility.GetTicks();
-                }
-            }
+        public void SetDel(long value) {
+            Synchronize();
+            time = TimeUtility.GetTicks();
+            del = value;
         }
-
-        public long Dec {
-            get => dec;
-            set {
-                Synchronize();
-                dec = value;
+        public void SetInc(long value) {
+            Synchronize();
+            inc = value;
+            if (inc == 0) {
+                time = TimeUtility.GetTicks();
             }
         }
-
-        public long Sur {
-            get => inc - dec;
+        public void SetDec(long value) {
+            Synchronize();
+            dec = value;
         }
 
+        public long Sur => inc - dec;
+
         public long Val {
             get {
                 long now = TimeUtility.GetTicks();
@@ -140,13 +101,13 @@ namespace Weathering
                 long newVal = val + times * Sur;
                 return newVal > max ? max : newVal;
             }
-            set {
-                Synchronize();
-                if (Maxed) {
-                    time = TimeUtility.GetTicks();
-                }
-                val = value;
+        }
+        public void SetVal(long value) {
+            Synchronize();
+            if (Maxed) {
+                time = TimeUtility.GetTicks();
             }
+            val = value;
         }
 
         public long ProgressedTicks {
@@ -186,7 +147,152 @@ namespace Weathering
             }
         }
 
-        public bool Maxed => Val >= Max;
+        public bool Maxed => Val >= max;
+
+        /// <summary>
+        /// Maxed变为true的时刻, 已经满了则为time, 不会满则为long.MaxValue
+        /// </summary>
+        public long MaxedTicks {
+            get {
+                if (val >= max) return time;
+                long sur = inc - dec;
+                if (del <= 0 || sur <= 0) return long.MaxValue;
+                long times = (max - val - 1) / sur + 1;
+                if (times > (long.MaxValue - time) / del) return long.MaxValue;
+                return time + times * del;
+            }
+        }
+    }
+
+    public class Value : IValue, IWatchableValue
+    {
+        private Value() { }
+
+        /// <summary>
+        /// Value或StoredValue的状态
+        /// </summary>
+        public static ValueState StateOf(IValue value) {
+            if (value is Value v) return v.state;
+            if (value is StoredValue stored) return stored.State;
+            throw new Exception();
+        }
+
+        public static ValueData ToData(IValue value) {
+            ValueState v = StateOf(value);
+            return new ValueData {
+                time = v.time,
+                inc = v.inc,
+                dec = v.dec,
+                del = v.del,
+                val = v.val,
+                max = v.max,
+            };
+        }
+        public static IValue FromData(ValueData data) {
+            return Create(data.val, data.max, data.inc, data.dec, data.del, data.time);
+        }
+
+        public static void ToBinary(ValueState v, System.IO.BinaryWriter writer) {
+            writer.Write(v.time);
+            writer.Write(v.inc);
+            writer.Write(v.dec);
+            writer.Write(v.del);
+            writer.Write(v.val);
+            writer.Write(v.max);
+        }
+        public static IValue FromBinary(System.IO.BinaryReader reader) {
+            return new Value { state = StateFromBinary(reader) };
+        }
+        public static ValueState StateFromBinary(System.IO.BinaryReader reader) {
+            long time = reader.ReadInt64();
+            long inc = reader.ReadInt64();
+            long dec = reader.ReadInt64();
+            long del = reader.ReadInt64();
+            long val = reader.ReadInt64();
+            long max = reader.ReadInt64();
+            return ValueState.Create(val, max, inc, dec, del, time);
+        }
+
+        public const long MiniSecond = 10000;
+        public const long Second = 1000 * MiniSecond;
+        public const long Minute = 60 * Second;
+        public const long Hour = 60 * Minute;
+        public const long Day = 24 * Hour;
+
+        internal ValueState state = ValueState.Create(0, 0, 0, 0, Second, 0);
+
+        // 所属Values, 修改时标记存档
+        internal ISaveDirty owner = null;
+        bool IWatchableValue.Watched { get => watched; set => watched = value; }
+        private bool watched = false;
+        private void Changed() {
+            owner?.MarkSaveDirty();
+            if (watched) ValueScheduler.Reschedule(this);
+        }
+
+
+        public static Value Create(long val, long max, long inc, long dec, long del, long time) {
+            return new Value {
+                state = ValueState.Create(val, max, inc, dec, del, time)
+            };
+        }
+
+        public long Time {
+            get => state.time;
+            set {
+                state.time = value;
+                Changed();
+            }
+        }
+
+        public long Max {
+            get => state.max;
+            set {
+                state.SetMax(value);
+                Changed();
+            }
+        }
+        public long Del {
+            get => state.del;
+            set {
+                state.SetDel(value);
+                Changed();
+            }
+        }
+
+        public long Inc {
+            get => state.inc;
+            set {
+                state.SetInc(value);
+                Changed();
+            }
+        }
+
+        public long Dec {
+            get => state.dec;
+            set {
+                state.SetDec(value);
+                Changed();
+            }
+        }
+
+        public long Sur {
+            get => state.Sur;
+        }
+
+        public long Val {
+            get => state.Val;
+            set {
+                state.SetVal(value);
+                Changed();
+            }
+        }
+
+        public long ProgressedTicks => state.ProgressedTicks;
+
+        public string RemainingTimeString => state.RemainingTimeString;
+
+        public bool Maxed => state.Maxed;
         // public bool IsMaxed() => Maxed;
     }
 }
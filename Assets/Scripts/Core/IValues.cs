@@ -21,12 +21,24 @@ namespace Weathering
         Dictionary<Type, IValue> Dict { get; }
     }
 
-    public class Values : IValues
+    public class Values : IValues, ISaveDirty, ISaveDirtyOwned
     {
         private Values() { }
 
         public Dictionary<Type, IValue> Dict { get; private set; } = null;
 
+        private ISaveDirty saveDirtyOwner = null;
+        public ISaveDirty SaveDirtyOwner {
+            get => saveDirtyOwner;
+            set {
+                saveDirtyOwner = value;
+                foreach (var pair in Dict) {
+                    if (pair.Value is Value v) v.owner = this;
+                }
+            }
+        }
+        public void MarkSaveDirty() => saveDirtyOwner?.MarkSaveDirty();
+
         public static Dictionary<string, ValueData> ToData(IValues values) {
             if (values == null) return null;
             Dictionary<string, ValueData> dict = new Dictionary<string, ValueData>();
@@ -39,13 +51,37 @@ namespace Weathering
             if (data == null) return null;
             IValues result = GetOne();
             foreach (var pair in data) {
-                Type type = Type.GetType(pair.Key);
+                Type type = TypeRegistry.Find(pair.Key);
                 IValue value = Value.FromData(pair.Value);
                 result.Dict.Add(type, value);
             }
             return result;
         }
 
+        /// <summary>
+        /// 存档快照, 复制所有值的状态, 返回个数。null 返回 -1
+        /// </summary>
+        public static int CopyStates(IValues values, List<Type> types, List<ValueState> states) {
+            if (values == null) return -1;
+            if (values is StoredValues stored) return stored.CopyStates(types, states);
+            foreach (var pair in values.Dict) {
+                types.Add(pair.Key);
+                states.Add(Value.StateOf(pair.Value));
+            }
+            return values.Dict.Count;
+        }
+        public static IValues FromBinary(System.IO.BinaryReader reader, SaveTypeTable table) {
+            int count = reader.ReadInt32();
+            if (count < 0) return null;
+            IValues result = GetOne();
+            for (int i = 0; i < count; i++) {
+                Type type = table.TypeOf(reader.ReadInt32());
+                IValue value = Value.FromBinary(reader);
+                result.Dict.Add(type, value);
+            }
+            return result;
+        }
+
 
         public static IValues GetOne() {
             return new Values {
@@ -68,9 +104,11 @@ namespace Weathering
             if (Dict.TryGetValue(type, out IValue value)) {
                 throw new Exception();
             } else {
-                value = Value.Create(0, 0, 0, 0, 0, TimeUtility.GetTicks());
-                Dict.Add(type, value);
-                return value;
+                Value v = Value.Create(0, 0, 0, 0, 0, TimeUtility.GetTicks());
+                v.owner = this;
+                Dict.Add(type, v);
+                MarkSaveDirty();
+                return v;
             }
         }
         public IValue Create<T>() {
@@ -81,9 +119,11 @@ namespace Weathering
             if (Dict.TryGetValue(type, out IValue value)) {
                 return value;
             } else {
-                value = Value.Create(0, 0, 0, 0, 0, TimeUtility.GetTicks());
-                Dict.Add(type, value);
-                return value;
+                Value v = Value.Create(0, 0, 0, 0, 0, TimeUtility.GetTicks());
+                v.owner = this;
+                Dict.Add(type, v);
+                MarkSaveDirty();
+                return v;
             }
         }
         public IValue GetOrCreate<T>() {
@@ -104,6 +144,7 @@ namespace Weathering
         public bool Remove(Type type) {
             if (Dict.ContainsKey(type)) {
                 Dict.Remove(type);
+                MarkSaveDirty();
                 return true;
             }
             return false;
@@ -0,0 +1,390 @@
+﻿
+using System;
+using System.Collections.Generic;
+using UnityEngine;
+using UnityEngine.Rendering;
+using UnityEngine.Tilemaps;
+
+namespace Weathering
+{
+    /// <summary>
+    /// Tilemap之外的另一种地图渲染方式, 在GameMenu设置里切换
+    /// 1. 视野按ChunkSize划分区块, 每个区块每个图层组一个网格。相邻, 材质相同, 根节点相同的图层合为一组, 组内按图层顺序分子网格, 保持遮挡顺序
+    /// 2. 子网格再按贴图细分。贴图用MaterialPropertyBlock设置, 材质保持共享, UpdateWeather对材质的修改照常生效
+    ///    地块贴图打进同一个图集后(菜单Weathering/打包地块图集), 每个子网格通常只有一张贴图
+    /// 3. 只重建脏区块: 新进入视野, 地块被标记NeedUpdateSpriteKeys, 帧动画扫描行上有要换帧的地块
+    /// 4. 物流箭头各层放在单独的根节点下, 由MapView整体平移, 与原来移动tilemapLeft等相同
+    /// </summary>
+    public class ChunkedMapRenderer
+    {
+        public const int ChunkSize = 16;
+
+        /// <summary>
+        /// 填充(i, j)格各图层的Tile, 按图层顺序, 没有则为null
+        /// </summary>
+        public delegate void CellResolver(int i, int j, Tile[] tiles);
+
+        private readonly int layerCount;
+        private readonly int[] sortingOrders;
+        private readonly Transform[] layerRoots;
+        private readonly CellResolver resolver;
+        private readonly Tile[] cellTiles;
+
+        private Material[] layerMaterials;
+        private int groupCount = 0;
+        private readonly int[] groupOfLayer;
+        private readonly List<int> groupFirstLayer = new List<int>();
+
+        private static readonly int mainTexId = Shader.PropertyToID("_MainTex");
+        private readonly MaterialPropertyBlock propertyBlock = new MaterialPropertyBlock();
+
+        /// <summary>
+        /// layerRoots为每个图层的父节点, 同一节点下相邻的图层才可能合并
+        /// </summary>
+        public ChunkedMapRenderer(int[] sortingOrders, Transform[] layerRoots, CellResolver resolver) {
+            if (sortingOrders.Length != layerRoots.Length) throw new Exception();
+            layerCount = sortingOrders.Length;
+            this.sortingOrders = sortingOrders;
+            this.layerRoots = layerRoots;
+            this.resolver = resolver;
+            cellTiles = new Tile[layerCount];
+            groupOfLayer = new int[layerCount];
+        }
+
+        private bool active = false;
+        public bool Active {
+            get => active;
+            set {
+                if (active == value) return;
+                active = value;
+                if (!active) ReleaseAll();
+            }
+        }
+
+        /// <summary>
+        /// 设置每个图层的材质, 重新分组, 所有区块重建
+        /// </summary>
+        public void SetMaterials(Material[] materials) {
+            if (materials.Length != layerCount) throw new Exception();
+            if (layerMaterials != null && SameMaterials(materials)) return;
+            layerMaterials = (Material[])materials.Clone();
+
+            DestroyAll();
+            groupFirstLayer.Clear();
+            for (int k = 0; k < layerCount; k++) {
+                bool merge = k > 0 && layerMaterials[k] == layerMaterials[k - 1] && layerRoots[k] == layerRoots[k - 1];
+                if (!merge) groupFirstLayer.Add(k);
+                groupOfLayer[k] = groupFirstLayer.Count - 1;
+            }
+            groupCount = groupFirstLayer.Count;
+            builders = new GroupBuilder[groupCount];
+            for (int g = 0; g < groupCount; g++) {
+                builders[g] = new GroupBuilder();
+            }
+        }
+        private bool SameMaterials(Material[] materials) {
+            for (int k = 0; k < layerCount; k++) {
+                if (materials[k] != layerMaterials[k]) return false;
+            }
+            return true;
+        }
+
+        public int GroupCount => groupCount;
+
+
+        // ------------------------------------------------------------
+        // 区块
+
+        private class Chunk
+        {
+            public Vector2Int Coord;
+            public bool Dirty;
+            public GameObject[] Objects; // 每组一个, 在该组的根节点下
+            public Mesh[] Meshes;
+            public MeshRenderer[] Renderers;
+        }
+
+        private readonly Dictionary<Vector2Int, Chunk> chunks = new Dictionary<Vector2Int, Chunk>();
+        private readonly Stack<Chunk> pool = new Stack<Chunk>();
+        private readonly List<Vector2Int> releasing = new List<Vector2Int>();
+
+        private static int FloorDiv(int a, int b) => a >= 0 ? a / b : (a - b + 1) / b;
+
+        // 视野覆盖的区块范围, 以格子为单位, 比视野大
+        public int CoveredStartX { get; private set; }
+        public int CoveredEndX { get; private set; }
+        public int CoveredStartY { get; private set; }
+        public int CoveredEndY { get; private set; }
+
+        /// <summary>
+        /// 每帧调用, 回收离开视野的区块, 新进入视野的区块标记为脏
+        /// </summary>
+        public void SetView(int startX, int endX, int startY, int endY) {
+            if (layerMaterials == null) throw new Exception("未设置材质");
+            int cx0 = FloorDiv(startX, ChunkSize);
+            int cx1 = FloorDiv(endX, ChunkSize);
+            int cy0 = FloorDiv(startY, ChunkSize);
+            int cy1 = FloorDiv(endY, ChunkSize);
+            CoveredStartX = cx0 * ChunkSize;
+            CoveredEndX = cx1 * ChunkSize + ChunkSize - 1;
+            CoveredStartY = cy0 * ChunkSize;
+            CoveredEndY = cy1 * ChunkSize + ChunkSize - 1;
+
+            releasing.Clear();
+            foreach (var pair in chunks) {
+                Vector2Int c = pair.Key;
+                if (c.x < cx0 || c.x > cx1 || c.y < cy0 || c.y > cy1) releasing.Add(c);
+            }
+            foreach (var c in releasing) {
+                Release(chunks[c]);
+                chunks.Remove(c);
+            }
+
+            for (int cy = cy0; cy <= cy1; cy++) {
+                for (int cx = cx0; cx <= cx1; cx++) {
+                    Vector2Int c = new Vector2Int(cx, cy);
+                    if (!chunks.ContainsKey(c)) chunks.Add(c, Acquire(c));
+                }
+            }
+        }
+
+        /// <summary>
+        /// 格子(i, j)所在区块下次RebuildDirty时重建。不在视野里的区块忽略
+        /// </summary>
+        public void MarkDirty(int i, int j) {
+            if (chunks.TryGetValue(new Vector2Int(FloorDiv(i, ChunkSize), FloorDiv(j, ChunkSize)), out Chunk chunk)) {
+                chunk.Dirty = true;
+            }
+        }
+
+        public void MarkAllDirty() {
+            foreach (var chunk in chunks.Values) {
+                chunk.Dirty = true;
+            }
+        }
+
+        private Chunk Acquire(Vector2Int coord) {
+            Chunk chunk = pool.Count > 0 ? pool.Pop() : CreateChunk();
+            chunk.Coord = coord;
+            chunk.Dirty = true;
+            Vector3 origin = new Vector3(coord.x * ChunkSize, coord.y * ChunkSize, 0);
+            for (int g = 0; g < groupCount; g++) {
+                chunk.Objects[g].transform.localPosition = origin;
+            }
+            return chunk;
+        }
+
+        private Chunk CreateChunk() {
+            Chunk chunk = new Chunk {
+                Objects = new GameObject[groupCount],
+                Meshes = new Mesh[groupCount],
+                Renderers = new MeshRenderer[groupCount],
+            };
+            for (int g = 0; g < groupCount; g++) {
+                int firstLayer = groupFirstLayer[g];
+                GameObject obj = new GameObject($"Chunk{firstLayer}");
+                obj.transform.SetParent(layerRoots[firstLayer], false);
+                Mesh mesh = new Mesh();
+                mesh.MarkDynamic();
+                obj.AddComponent<MeshFilter>().sharedMesh = mesh;
+                MeshRenderer renderer = obj.AddComponent<MeshRenderer>();
+                renderer.shadowCastingMode = ShadowCastingMode.Off;
+                renderer.receiveShadows = false;
+                renderer.lightProbeUsage = LightProbeUsage.Off;
+                renderer.reflectionProbeUsage = ReflectionProbeUsage.Off;
+                renderer.sortingOrder = sortingOrders[firstLayer];
+                renderer.enabled = false;
+                chunk.Objects[g] = obj;
+                chunk.Meshes[g] = mesh;
+                chunk.Renderers[g] = renderer;
+            }
+            return chunk;
+        }
+
+        private void Release(Chunk chunk) {
+            for (int g = 0; g < groupCount; g++) {
+                chunk.Renderers[g].enabled = false;
+            }
+            pool.Push(chunk);
+        }
+        private void ReleaseAll() {
+            foreach (var chunk in chunks.Values) {
+                Release(chunk);
+            }
+            chunks.Clear();
+        }
+
+        private void DestroyAll() {
+            ReleaseAll();
+            while (pool.Count > 0) {
+                Chunk chunk = pool.Pop();
+                for (int g = 0; g < chunk.Objects.Length; g++) {
+                    UnityEngine.Object.Destroy(chunk.Meshes[g]);
+                    UnityEngine.Object.Destroy(chunk.Objects[g]);
+                }
+            }
+        }
+
+
+        // ------------------------------------------------------------
+        // 网格
+
+        /// <summary>
+        /// 贴图的网格数据, sprite.vertices等每次访问都会分配新数组, 所以缓存
+        /// </summary>
+        private class SpriteGeometry
+        {
+            public Vector2[] Vertices;
+            public Vector2[] UV;
+            public ushort[] Triangles;
+        }
+        private readonly Dictionary<Sprite, SpriteGeometry> geometries = new Dictionary<Sprite, SpriteGeometry>();
+        private SpriteGeometry GeometryOf(Sprite sprite) {
+            if (!geometries.TryGetValue(sprite, out SpriteGeometry geometry)) {
+                geometry = new SpriteGeometry {
+                    Vertices = sprite.vertices,
+                    UV = sprite.uv,
+                    Triangles = sprite.triangles,
+                };
+                geometries.Add(sprite, geometry);
+            }
+            return geometry;
+        }
+
+        private class Submesh
+        {
+            public int Layer;
+            public Texture Texture;
+            public readonly List<int> Indices = new List<int>();
+        }
+
+        /// <summary>
+        /// 一个组在重建时的顶点和子网格, 所有区块复用
+        /// </summary>
+        private class GroupBuilder
+        {
+            public readonly List<Vector3> Vertices = new List<Vector3>();
+            public readonly List<Vector2> UV = new List<Vector2>();
+            public readonly List<Color32> Colors = new List<Color32>();
+            public readonly List<Submesh> Submeshes = new List<Submesh>(); // 按图层顺序
+            private readonly Stack<Submesh> free = new Stack<Submesh>();
+            public readonly List<Material[]> MaterialArrays = new List<Material[]>(); // 下标为子网格数
+
+            public void Clear() {
+                Vertices.Clear();
+                UV.Clear();
+                Colors.Clear();
+                foreach (var submesh in Submeshes) {
+                    submesh.Indices.Clear();
+                    free.Push(submesh);
+                }
+                Submeshes.Clear();
+            }
+
+            public Submesh SubmeshOf(int layer, Texture texture) {
+                int insertAt = Submeshes.Count;
+                for (int n = 0; n < Submeshes.Count; n++) {
+                    Submesh submesh = Submeshes[n];
+                    if (submesh.Layer == layer && submesh.Texture == texture) return submesh;
+                    if (submesh.Layer > layer) {
+                        insertAt = n;
+                        break;
+                    }
+                }
+                Submesh result = free.Count > 0 ? free.Pop() : new Submesh();
+                result.Layer = layer;
+                result.Texture = texture;
+                Submeshes.Insert(insertAt, result);
+                return result;
+            }
+        }
+        private GroupBuilder[] builders;
+
+        public void RebuildDirty() {
+            foreach (var chunk in chunks.Values) {
+                if (!chunk.Dirty) continue;
+                Rebuild(chunk);
+                chunk.Dirty = false;
+            }
+        }
+
+        private void Rebuild(Chunk chunk) {
+            for (int g = 0; g < groupCount; g++) {
+                builders[g].Clear();
+            }
+
+            int x0 = chunk.Coord.x * ChunkSize;
+            int y0 = chunk.Coord.y * ChunkSize;
+            for (int j = 0; j < ChunkSize; j++) {
+                for (int i = 0; i < ChunkSize; i++) {
+                    resolver(x0 + i, y0 + j, cellTiles);
+                    // Tilemap的锚点在格子中心
+                    Vector3 center = new Vector3(i + 0.5f, j + 0.5f, 0);
+                    for (int k = 0; k < layerCount; k++) {
+                        Tile tile = cellTiles[k];
+                        if (tile == null) continue;
+                        Sprite sprite = tile.sprite;
+                        if (sprite == null) continue;
+                        AddSprite(builders[groupOfLayer[k]], k, sprite, tile.color, center);
+                    }
+                }
+            }
+
+            PerformanceCounters.Count(PerformanceCounter.ChunkRebuild);
+            for (int g = 0; g < groupCount; g++) {
+                Apply(builders[g], chunk.Meshes[g], chunk.Renderers[g], layerMaterials[groupFirstLayer[g]]);
+            }
+        }
+
+        private void AddSprite(GroupBuilder builder, int layer, Sprite sprite, Color color, Vector3 center) {
+            SpriteGeometry geometry = GeometryOf(sprite);
+            Submesh submesh = builder.SubmeshOf(layer, sprite.texture);
+            int baseVertex = builder.Vertices.Count;
+            Color32 color32 = color;
+            Vector2[] vertices = geometry.Vertices;
+            Vector2[] uv = geometry.UV;
+            for (int n = 0; n < vertices.Length; n++) {
+                builder.Vertices.Add(center + (Vector3)vertices[n]);
+                builder.UV.Add(uv[n]);
+                builder.Colors.Add(color32);
+            }
+            ushort[] triangles = geometry.Triangles;
+            for (int n = 0; n < triangles.Length; n++) {
+                submesh.Indices.Add(baseVertex + triangles[n]);
+            }
+        }
+
+        private void Apply(GroupBuilder builder, Mesh mesh, MeshRenderer renderer, Material material) {
+            mesh.Clear();
+            int submeshCount = builder.Submeshes.Count;
+            if (submeshCount == 0) {
+                renderer.enabled = false;
+                return;
+            }
+            mesh.indexFormat = builder.Vertices.Count > ushort.MaxValue ? IndexFormat.UInt32 : IndexFormat.UInt16;
+            mesh.SetVertices(builder.Vertices);
+            mesh.SetUVs(0, builder.UV);
+            mesh.SetColors(builder.Colors);
+            mesh.subMeshCount = submeshCount;
+            for (int n = 0; n < submeshCount; n++) {
+                mesh.SetTriangles(builder.Submeshes[n].Indices, n);
+            }
+
+            while (builder.MaterialArrays.Count <= submeshCount) {
+                Material[] materials = new Material[builder.MaterialArrays.Count];
+                for (int n = 0; n < materials.Length; n++) {
+                    materials[n] = material;
+                }
+                builder.MaterialArrays.Add(materials);
+            }
+            renderer.sharedMaterials = builder.MaterialArrays[submeshCount]; // 材质改变时SetMaterials会重建builders
+            for (int n = 0; n < submeshCount; n++) {
+                propertyBlock.Clear();
+                Texture texture = builder.Submeshes[n].Texture;
+                if (texture != null) propertyBlock.SetTexture(mainTexId, texture);
+                renderer.SetPropertyBlock(propertyBlock, n);
+            }
+            renderer.enabled = true;
+        }
+    }
+}
@@ -48,6 +48,11 @@ namespace Weathering
 
         bool Snowy { get; }
         float SnowDensity { get; }
+
+        /// <summary>
+        /// 本帧的环境快照, 上面随时间变化的值都从这里取
+        /// </summary>
+        PlanetEnvironment Environment { get; }
     }
 
 
@@ -91,6 +96,12 @@ namespace Weathering
         float TappingSensitivityFactor { get; set; }
         long AnimationIndex { get; }
 
+        void InvalidateTile(ITile tile);
+
+        /// <summary>
+        /// 用ChunkedMapRenderer代替Tilemap渲染地图, 见GameMenu设置
+        /// </summary>
+        bool UseChunkedRenderer { get; set; }
     }
 
     // IgnoreTool的ITile会忽略选中的工具影响
@@ -139,12 +150,50 @@ namespace Weathering
             renderer_tilemapOverlay = tilemapOverlay.GetComponent<TilemapRenderer>();
 
             renderer_character = characterTransform.GetComponent<SpriteRenderer>();
+
+            layers = new Tilemap[layerCount] {
+                tilemapBedrock, tilemapWater, tilemapGrass, tilemapTree, tilemapHill, tilemapRoad,
+                tilemapLeft, tilemapRight, tilemapUp, tilemapDown,
+                tilemap, tilemapHighLight, tilemapOverlay,
+            };
+            layerRenderers = new TilemapRenderer[layerCount];
+            int[] sortingOrders = new int[layerCount];
+            for (int k = 0; k < layerCount; k++) {
+                layerRenderers[k] = layers[k].GetComponent<TilemapRenderer>();
+                sortingOrders[k] = layerRenderers[k].sortingOrder;
+            }
+
+            // 区块网格与tilemap放在同一个Grid下, 物流箭头四层各一个根节点, 由UpdateMapAnimation平移
+            Transform grid = tilemapBedrock.transform.parent;
+            Transform chunkRoot = CreateChunkRoot("ChunkedMap", grid);
+            Transform[] layerRoots = new Transform[layerCount];
+            for (int k = 0; k < layerCount; k++) {
+                layerRoots[k] = chunkRoot;
+            }
+            chunkArrowRoots = new Transform[] {
+                CreateChunkRoot("ChunkedMapLeft", grid),
+                CreateChunkRoot("ChunkedMapRight", grid),
+                CreateChunkRoot("ChunkedMapUp", grid),
+                CreateChunkRoot("ChunkedMapDown", grid),
+            };
+            for (int n = 0; n < chunkArrowRoots.Length; n++) {
+                layerRoots[firstArrowLayer + n] = chunkArrowRoots[n];
+            }
+            chunkedRenderer = new ChunkedMapRenderer(sortingOrders, layerRoots, ResolveChunkCell);
+            SyncChunkMaterials();
         }
 
         /// <summary>
         /// 单例, 全局唯一, 代表正在显示中的地图
         /// </summary>
-        public IMap TheOnlyActiveMap { get; set; }
+        private IMap theOnlyActiveMap;
+        public IMap TheOnlyActiveMap {
+            get => theOnlyActiveMap;
+            set {
+                theOnlyActiveMap = value;
+                needFullRedraw = true; // 切换地图后整个视野重画
+            }
+        }
 
         // public Camera MainCamera { get => mainCamera; }
 
@@ -306,10 +355,16 @@ namespace Weathering
             mapControlCharacterLastFrame = mapControlCharacter;
 
             // 渲染地图
-            UpdateMap();
-            UpdateWeather();
+            using (PerformanceCounters.Measure(PerformanceSection.UpdateMap)) {
+                UpdateMap();
+            }
+            using (PerformanceCounters.Measure(PerformanceSection.UpdateWeather)) {
+                UpdateWeather();
+            }
             // 地图动画, 会用着色器代替..?没必要
-            UpdateMapAnimation();
+            using (PerformanceCounters.Measure(PerformanceSection.UpdateMapAnimation)) {
+                UpdateMapAnimation();
+            }
 
         }
 
@@ -628,158 +683,339 @@ namespace Weathering
             }
 
 
-            IRes res = Res.Ins;
-            for (int i = x - CameraWidthHalf; i <= x + CameraWidthHalf; i++) {
+            // 脏区驱动: 只访问新进入视野的格子, 被标记NeedUpdateSpriteKeys的地块, 和动画扫描行
+            int startX = x - CameraWidthHalf;
+            int endX = x + CameraWidthHalf;
+            int animationRowY = animationScanerIndexOffsetY + startY;
+
+            if (chunkedRenderer.Active) {
+                UpdateChunkedMap(startX, endX, startY, endY, animationRowY);
+            } else if (needFullRedraw) {
+                needFullRedraw = false;
+                invalidatedTiles.Clear();
+                // 整个视野按行优先顺序收集, 每层一次SetTilesBlock
                 for (int j = startY; j <= endY; j++) {
-                    ITileDefinition iTile = TheOnlyActiveMap.Get(i, j) as ITileDefinition;
-
-                    // Tile缓存优化, 使用了NeedUpdateSpriteKey TileSpriteKeyBuffer
-                    Tile tileBedrock = null;
-                    Tile tileWater = null;
-                    Tile tileGrass = null;
-                    Tile tileTree = null;
-                    Tile tileHill = null;
-                    Tile tileRoad = null;
-                    Tile tile = null;
-                    Tile tileHighLight = null;
-                    Tile tileOverlay = null;
-
-                    bool needUpdateFrameAnimationForThisTile = (animationScanerIndexOffsetY + startY == j) &&
-                        iTile is IHasFrameAnimationOnSpriteKey hasFrameAnimationOnSpriteKey &&
+                    for (int i = startX; i <= endX; i++) {
+                        CollectCell(i, j, true, j == animationRowY);
+                    }
+                }
+                FlushBatch(new BoundsInt(startX, startY, 0, endX - startX + 1, endY - startY + 1, 1));
+            } else {
+                // 新进入视野的格子, 即本帧视野减去上一帧视野
+                VisitRect(startX, endX, startY, Math.Min(endY, lastStartY - 1), animationRowY);
+                VisitRect(startX, endX, Math.Max(startY, lastEndY + 1), endY, animationRowY);
+                int middleStartY = Math.Max(startY, lastStartY);
+                int middleEndY = Math.Min(endY, lastEndY);
+                VisitRect(startX, Math.Min(endX, lastStartX - 1), middleStartY, middleEndY, animationRowY);
+                VisitRect(Math.Max(startX, lastEndX + 1), endX, middleStartY, middleEndY, animationRowY);
+
+                // 被标记的地块, 可能因为地图循环在视野里出现多次
+                List<ITile> invalidated = invalidatedTiles;
+                invalidatedTiles = invalidatedTilesSwap;
+                invalidatedTilesSwap = invalidated;
+                foreach (var invalidatedTile in invalidated) {
+                    if (!invalidatedTile.NeedUpdateSpriteKeys) continue;
+                    Vector2Int tilePos = invalidatedTile.GetPos();
+                    for (int i = startX + Mod(tilePos.x - startX, width); i <= endX; i += width) {
+                        for (int j = startY + Mod(tilePos.y - startY, height); j <= endY; j += height) {
+                            CollectCell(i, j, false, j == animationRowY);
+                        }
+                    }
+                }
+                invalidated.Clear();
+
+                // 动画扫描行
+                if (animationRowY >= startY && animationRowY <= endY) {
+                    for (int i = startX; i <= endX; i++) {
+                        CollectCell(i, animationRowY, false, true);
+                    }
+                }
+                FlushBatch();
+            }
+
+            lastStartX = startX;
+            lastEndX = endX;
+            lastStartY = startY;
+            lastEndY = endY;
+        }
+
+        private void UpdateChunkedMap(int startX, int endX, int startY, int endY, int animationRowY) {
+            if (needFullRedraw) {
+                needFullRedraw = false;
+                invalidatedTiles.Clear();
+                chunkedRenderer.MarkAllDirty();
+            }
+            chunkedRenderer.SetView(startX, endX, startY, endY);
+            // 区块比视野大, 标记范围用区块覆盖的范围
+            int coveredStartX = chunkedRenderer.CoveredStartX;
+            int coveredEndX = chunkedRenderer.CoveredEndX;
+            int coveredStartY = chunkedRenderer.CoveredStartY;
+            int coveredEndY = chunkedRenderer.CoveredEndY;
+
+            List<ITile> invalidated = invalidatedTiles;
+            invalidatedTiles = invalidatedTilesSwap;
+            invalidatedTilesSwap = invalidated;
+            foreach (var invalidatedTile in invalidated) {
+                if (!invalidatedTile.NeedUpdateSpriteKeys) continue;
+                Vector2Int tilePos = invalidatedTile.GetPos();
+                for (int i = coveredStartX + Mod(tilePos.x - coveredStartX, width); i <= coveredEndX; i += width) {
+                    for (int j = coveredStartY + Mod(tilePos.y - coveredStartY, height); j <= coveredEndY; j += height) {
+                        chunkedRenderer.MarkDirty(i, j);
+                    }
+                }
+            }
+            invalidated.Clear();
+
+            // 动画扫描行上要换帧的地块, 所在区块重建
+            chunkAnimationRowY = animationRowY;
+            if (animationRowY >= startY && animationRowY <= endY) {
+                for (int i = coveredStartX; i <= coveredEndX; i++) {
+                    if (TheOnlyActiveMap.Get(i, animationRowY) is IHasFrameAnimationOnSpriteKey hasFrameAnimationOnSpriteKey &&
                         hasFrameAnimationOnSpriteKey.HasFrameAnimation > 0 &&
-                        AnimationIndex % hasFrameAnimationOnSpriteKey.HasFrameAnimation == 0;
-                    bool needUpdateSpriteKey = iTile.NeedUpdateSpriteKeys || needUpdateFrameAnimationForThisTile;
+                        AnimationIndex % hasFrameAnimationOnSpriteKey.HasFrameAnimation == 0) {
+                        chunkedRenderer.MarkDirty(i, animationRowY);
+                    }
+                }
+            }
+            chunkedRenderer.RebuildDirty();
+        }
 
-                    if (needUpdateSpriteKey) {
+        private static int Mod(int a, int b) {
+            int result = a % b;
+            return result < 0 ? result + b : result;
+        }
 
-                        string spriteKeyBackground = iTile.SpriteKeyBedrock;
-                        if (spriteKeyBackground != null && !res.TryGetTile(spriteKeyBackground, out tileBedrock)) {
-                            ThrowSpriteNotFoundException(spriteKeyBackground, iTile, nameof(spriteKeyBackground));
-                        }
-                        iTile.TileSpriteKeyBedrockBuffer = tileBedrock;
+        private void VisitRect(int startX, int endX, int startY, int endY, int animationRowY) {
+            for (int j = startY; j <= endY; j++) {
+                for (int i = startX; i <= endX; i++) {
+                    CollectCell(i, j, false, j == animationRowY);
+                }
+            }
+        }
 
-                        string spriteKeyWater = iTile.SpriteKeyWater;
-                        if (spriteKeyWater != null && !res.TryGetTile(spriteKeyWater, out tileWater)) {
-                            ThrowSpriteNotFoundException(spriteKeyWater, iTile, nameof(spriteKeyWater));
-                        }
-                        iTile.TileSpriteKeyWaterBuffer = tileWater;
+        /// <summary>
+        /// 地块标记NeedUpdateSpriteKeys时调用, 下一帧重新渲染
+        /// </summary>
+        public void InvalidateTile(ITile tile) {
+            if (needFullRedraw) return;
+            if (tile.GetMap() != theOnlyActiveMap) return;
+            invalidatedTiles.Add(tile);
+        }
 
-                        string spriteKeyBase = iTile.SpriteKeyGrass;
-                        if (spriteKeyBase != null && !res.TryGetTile(spriteKeyBase, out tileGrass)) {
-                            ThrowSpriteNotFoundException(spriteKeyBase, iTile, nameof(spriteKeyBase));
-                        }
-                        iTile.TileSpriteKeyGrassBuffer = tileGrass;
+        private bool needFullRedraw = true;
+        private List<ITile> invalidatedTiles = new List<ITile>();
+        private List<ITile> invalidatedTilesSwap = new List<ITile>();
+        private int lastStartX;
+        private int lastEndX;
+        private int lastStartY;
+        private int lastEndY;
+
+        // 批量SetTiles, 按层顺序: bedrock, water, grass, tree, hill, road, left, right, up, down, main, highlight, overlay
+        private const int layerCount = 13;
+        private Tilemap[] layers = null;
+        private TilemapRenderer[] layerRenderers = null;
+        private readonly Tile[] cellTiles = new Tile[layerCount];
+        private readonly List<Vector3Int> batchPositions = new List<Vector3Int>();
+        private readonly List<TileBase>[] batchTiles = CreateBatchTiles();
+        private static List<TileBase>[] CreateBatchTiles() {
+            List<TileBase>[] result = new List<TileBase>[layerCount];
+            for (int k = 0; k < layerCount; k++) {
+                result[k] = new List<TileBase>();
+            }
+            return result;
+        }
 
-                        string spriteKeyBaseBorderline = iTile.SpriteKeyTree;
-                        if (spriteKeyBaseBorderline != null && !res.TryGetTile(spriteKeyBaseBorderline, out tileTree)) {
-                            ThrowSpriteNotFoundException(spriteKeyBaseBorderline, iTile, nameof(spriteKeyBaseBorderline));
-                        }
-                        iTile.TileSpriteKeyTreeBuffer = tileTree;
+        private void FlushBatch() {
+            if (batchPositions.Count == 0) return;
+            Vector3Int[] positions = batchPositions.ToArray();
+            PerformanceCounters.Count(PerformanceCounter.TilemapSetTile, positions.Length * layerCount);
+            for (int k = 0; k < layerCount; k++) {
+                layers[k].SetTiles(positions, batchTiles[k].ToArray());
+                batchTiles[k].Clear();
+            }
+            batchPositions.Clear();
+        }
+        private void FlushBatch(BoundsInt block) {
+            if (batchPositions.Count != block.size.x * block.size.y) throw new Exception();
+            PerformanceCounters.Count(PerformanceCounter.TilemapSetTile, batchPositions.Count * layerCount);
+            for (int k = 0; k < layerCount; k++) {
+                layers[k].SetTilesBlock(block, batchTiles[k].ToArray());
+                batchTiles[k].Clear();
+            }
+            batchPositions.Clear();
+        }
 
-                        string spriteKeyHill = iTile.SpriteKeyHill;
-                        if (spriteKeyHill != null && !res.TryGetTile(spriteKeyHill, out tileHill)) {
-                            ThrowSpriteNotFoundException(spriteKeyHill, iTile, nameof(spriteKeyHill));
-                        }
-                        iTile.TileSpriteKeyHillBuffer = tileHill;
+        private void CollectCell(int i, int j, bool force, bool animationRow) {
+            ITileDefinition iTile = TheOnlyActiveMap.Get(i, j) as ITileDefinition;
+            bool needUpdateSpriteKey = ResolveCellTiles(iTile, animationRow, cellTiles);
 
-                        string spriteKeyRoad = iTile.SpriteKeyRoad;
-                        if (spriteKeyRoad != null && !res.TryGetTile(spriteKeyRoad, out tileRoad)) {
-                            ThrowSpriteNotFoundException(spriteKeyRoad, iTile, nameof(spriteKeyRoad));
-                        }
-                        iTile.TileSpriteKeyRoadBuffer = tileRoad;
+            if (force || needUpdateSpriteKey || iTile.NeedUpdateSpriteKeysPositionX != i || iTile.NeedUpdateSpriteKeysPositionY != j) {
+                batchPositions.Add(new Vector3Int(i, j, 0));
+                for (int k = 0; k < layerCount; k++) {
+                    batchTiles[k].Add(cellTiles[k]);
+                }
 
-                        string spriteKey = iTile.SpriteKey;
-                        if (spriteKey != null && !res.TryGetTile(spriteKey, out tile)) {
-                            ThrowSpriteNotFoundException(spriteKey, iTile, nameof(spriteKey));
-                        }
-                        iTile.TileSpriteKeyBuffer = tile;
+                //tilemap.SetTileFlags(pos3d, TileFlags.None);
+                //tilemap.SetColor(pos3d, (i + j) % 2 == 0 ? Color.red : Color.blue);
 
-                        string spriteKeyHighLight = iTile.SpriteKeyHighLight;
-                        if (spriteKeyHighLight != null && !res.TryGetTile(spriteKeyHighLight, out tileHighLight)) {
-                            ThrowSpriteNotFoundException(spriteKeyHighLight, iTile, nameof(spriteKeyHighLight));
-                        }
-                        iTile.TileSpriteKeyHighLightBuffer = tileHighLight;
+                iTile.NeedUpdateSpriteKeys = false;
+                iTile.NeedUpdateSpriteKeysPositionX = i;
+                iTile.NeedUpdateSpriteKeysPositionY = j;
+            }
+        }
 
-                        string spriteKeyOverlay = iTile.SpriteKeyOverlay;
-                        if (spriteKeyOverlay != null && !res.TryGetTile(spriteKeyOverlay, out tileOverlay)) {
-                            ThrowSpriteNotFoundException(spriteKeyOverlay, iTile, nameof(spriteKeyOverlay));
-                        }
-                        iTile.TileSpriteKeyOverlayBuffer = tileOverlay;
-                    } else {
-                        tileBedrock = iTile.TileSpriteKeyBedrockBuffer;
-                        tileWater = iTile.TileSpriteKeyWaterBuffer;
-                        tileGrass = iTile.TileSpriteKeyGrassBuffer;
-                        tileTree = iTile.TileSpriteKeyTreeBuffer;
-                        tileHill = iTile.TileSpriteKeyHillBuffer;
-                        tileRoad = iTile.TileSpriteKeyRoadBuffer;
-                        tile = iTile.TileSpriteKeyBuffer;
-                        tileHighLight = iTile.TileSpriteKeyHighLightBuffer;
-                        tileOverlay = iTile.TileSpriteKeyOverlayBuffer;
-                    }
+        /// <summary>
+        /// 按图层顺序取出地块各层的Tile, 需要时按贴图id刷新地块上的缓存。返回是否刷新了
+        /// </summary>
+        private bool ResolveCellTiles(ITileDefinition iTile, bool animationRow, Tile[] tiles) {
+            IRes res = Res.Ins;
 
-                    Tile tileLeft = null;
-                    Tile tileRight = null;
-                    Tile tileUp = null;
-                    Tile tileDown = null;
-                    if (needUpdateSpriteKey) {
-                        string spriteLeft = iTile.SpriteLeft;
-                        if (spriteLeft != null && !res.TryGetTile(spriteLeft, out tileLeft)) {
-                            ThrowSpriteNotFoundException(spriteLeft, iTile, nameof(spriteLeft));
-                        }
-                        iTile.TileSpriteKeyLeftBuffer = tileLeft;
+            // Tile缓存优化, 使用了NeedUpdateSpriteKey TileSpriteKeyBuffer
+            // 贴图用整数id查询, 见Res.SpriteId
+            Tile tileBedrock = null;
+            Tile tileWater = null;
+            Tile tileGrass = null;
+            Tile tileTree = null;
+            Tile tileHill = null;
+            Tile tileRoad = null;
+            Tile tile = null;
+            Tile tileHighLight = null;
+            Tile tileOverlay = null;
+
+            bool needUpdateFrameAnimationForThisTile = animationRow &&
+                iTile is IHasFrameAnimationOnSpriteKey hasFrameAnimationOnSpriteKey &&
+                hasFrameAnimationOnSpriteKey.HasFrameAnimation > 0 &&
+                AnimationIndex % hasFrameAnimationOnSpriteKey.HasFrameAnimation == 0;
+            bool needUpdateSpriteKey = iTile.NeedUpdateSpriteKeys || needUpdateFrameAnimationForThisTile;
+
+            if (needUpdateSpriteKey) {
+                PerformanceCounters.Count(PerformanceCounter.SpriteKeyRefresh);
+
+                int spriteKeyBackground = iTile.SpriteIdBedrock;
+                if (spriteKeyBackground != Res.NoSprite && !res.TryGetTile(spriteKeyBackground, out tileBedrock)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteKeyBackground), iTile, nameof(spriteKeyBackground));
+                }
+                iTile.TileSpriteKeyBedrockBuffer = tileBedrock;
 
-                        string spriteRight = iTile.SpriteRight;
-                        if (spriteRight != null && !res.TryGetTile(spriteRight, out tileRight)) {
-                            ThrowSpriteNotFoundException(spriteRight, iTile, nameof(spriteRight));
-                        }
-                        iTile.TileSpriteKeyRightBuffer = tileRight;
+                int spriteKeyWater = iTile.SpriteIdWater;
+                if (spriteKeyWater != Res.NoSprite && !res.TryGetTile(spriteKeyWater, out tileWater)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteKeyWater), iTile, nameof(spriteKeyWater));
+                }
+                iTile.TileSpriteKeyWaterBuffer = tileWater;
 
-                        string spriteUp = iTile.SpriteUp;
-                        if (spriteUp != null && !res.TryGetTile(spriteUp, out tileUp)) {
-                            ThrowSpriteNotFoundException(spriteUp, iTile, nameof(spriteUp));
-                        }
-                        iTile.TileSpriteKeyUpBuffer = tileUp;
+                int spriteKeyBase = iTile.SpriteIdGrass;
+                if (spriteKeyBase != Res.NoSprite && !res.TryGetTile(spriteKeyBase, out tileGrass)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteKeyBase), iTile, nameof(spriteKeyBase));
+                }
+                iTile.TileSpriteKeyGrassBuffer = tileGrass;
 
-                        string spriteDown = iTile.SpriteDown;
-                        if (spriteDown != null && !res.TryGetTile(spriteDown, out tileDown)) {
-                            ThrowSpriteNotFoundException(spriteDown, iTile, nameof(spriteDown));
-                        }
-                        iTile.TileSpriteKeyDownBuffer = tileDown;
+                int spriteKeyBaseBorderline = iTile.SpriteIdTree;
+                if (spriteKeyBaseBorderline != Res.NoSprite && !res.TryGetTile(spriteKeyBaseBorderline, out tileTree)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteKeyBaseBorderline), iTile, nameof(spriteKeyBaseBorderline));
+                }
+                iTile.TileSpriteKeyTreeBuffer = tileTree;
 
-                    } else {
-                        tileLeft = iTile.TileSpriteKeyLeftBuffer;
-                        tileRight = iTile.TileSpriteKeyRightBuffer;
-                        tileUp = iTile.TileSpriteKeyUpBuffer;
-                        tileDown = iTile.TileSpriteKeyDownBuffer;
-                    }
+                int spriteKeyHill = iTile.SpriteIdHill;
+                if (spriteKeyHill != Res.NoSprite && !res.TryGetTile(spriteKeyHill, out tileHill)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteKeyHill), iTile, nameof(spriteKeyHill));
+                }
+                iTile.TileSpriteKeyHillBuffer = tileHill;
 
-                    if (needUpdateSpriteKey || iTile.NeedUpdateSpriteKeysPositionX != i || iTile.NeedUpdateSpriteKeysPositionY != j) {
-                        Vector3Int pos3d = new Vector3Int(i, j, 0);
-                        tilemapBedrock.SetTile(pos3d, tileBedrock);
-                        tilemapWater.SetTile(pos3d, tileWater);
-                        tilemapGrass.SetTile(pos3d, tileGrass);
-                        tilemapTree.SetTile(pos3d, tileTree);
-                        tilemapHill.SetTile(pos3d, tileHill);
-                        tilemapRoad.SetTile(pos3d, tileRoad);
-
-                        tilemapLeft.SetTile(pos3d, tileLeft);
-                        tilemapRight.SetTile(pos3d, tileRight);
-                        tilemapUp.SetTile(pos3d, tileUp);
-                        tilemapDown.SetTile(pos3d, tileDown);
-
-                        tilemap.SetTile(pos3d, tile);
-                        tilemapHighLight.SetTile(pos3d, tileHighLight);
-                        tilemapOverlay.SetTile(pos3d, tileOverlay);
-
-                        //tilemap.SetTileFlags(pos3d, TileFlags.None);
-                        //tilemap.SetColor(pos3d, (i + j) % 2 == 0 ? Color.red : Color.blue);
-
-                        iTile.NeedUpdateSpriteKeys = false;
-                        iTile.NeedUpdateSpriteKeysPositionX = i;
-                        iTile.NeedUpdateSpriteKeysPositionY = j;
-                    }
+                int spriteKeyRoad = iTile.SpriteIdRoad;
+                if (spriteKeyRoad != Res.NoSprite && !res.TryGetTile(spriteKeyRoad, out tileRoad)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteKeyRoad), iTile, nameof(spriteKeyRoad));
+                }
+                iTile.TileSpriteKeyRoadBuffer = tileRoad;
+
+                int spriteKey = iTile.SpriteId;
+                if (spriteKey != Res.NoSprite && !res.TryGetTile(spriteKey, out tile)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteKey), iTile, nameof(spriteKey));
                 }
+                iTile.TileSpriteKeyBuffer = tile;
+
+                int spriteKeyHighLight = iTile.SpriteIdHighLight;
+                if (spriteKeyHighLight != Res.NoSprite && !res.TryGetTile(spriteKeyHighLight, out tileHighLight)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteKeyHighLight), iTile, nameof(spriteKeyHighLight));
+                }
+                iTile.TileSpriteKeyHighLightBuffer = tileHighLight;
+
+                int spriteKeyOverlay = iTile.SpriteIdOverlay;
+                if (spriteKeyOverlay != Res.NoSprite && !res.TryGetTile(spriteKeyOverlay, out tileOverlay)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteKeyOverlay), iTile, nameof(spriteKeyOverlay));
+                }
+                iTile.TileSpriteKeyOverlayBuffer = tileOverlay;
+            } else {
+                tileBedrock = iTile.TileSpriteKeyBedrockBuffer;
+                tileWater = iTile.TileSpriteKeyWaterBuffer;
+                tileGrass = iTile.TileSpriteKeyGrassBuffer;
+                tileTree = iTile.TileSpriteKeyTreeBuffer;
+                tileHill = iTile.TileSpriteKeyHillBuffer;
+                tileRoad = iTile.TileSpriteKeyRoadBuffer;
+                tile = iTile.TileSpriteKeyBuffer;
+                tileHighLight = iTile.TileSpriteKeyHighLightBuffer;
+                tileOverlay = iTile.TileSpriteKeyOverlayBuffer;
             }
+
+            Tile tileLeft = null;
+            Tile tileRight = null;
+            Tile tileUp = null;
+            Tile tileDown = null;
+            if (needUpdateSpriteKey) {
+                int spriteLeft = iTile.SpriteIdLeft;
+                if (spriteLeft != Res.NoSprite && !res.TryGetTile(spriteLeft, out tileLeft)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteLeft), iTile, nameof(spriteLeft));
+                }
+                iTile.TileSpriteKeyLeftBuffer = tileLeft;
+
+                int spriteRight = iTile.SpriteIdRight;
+                if (spriteRight != Res.NoSprite && !res.TryGetTile(spriteRight, out tileRight)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteRight), iTile, nameof(spriteRight));
+                }
+                iTile.TileSpriteKeyRightBuffer = tileRight;
+
+                int spriteUp = iTile.SpriteIdUp;
+                if (spriteUp != Res.NoSprite && !res.TryGetTile(spriteUp, out tileUp)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteUp), iTile, nameof(spriteUp));
+                }
+                iTile.TileSpriteKeyUpBuffer = tileUp;
+
+                int spriteDown = iTile.SpriteIdDown;
+                if (spriteDown != Res.NoSprite && !res.TryGetTile(spriteDown, out tileDown)) {
+                    ThrowSpriteNotFoundException(Res.SpriteName(spriteDown), iTile, nameof(spriteDown));
+                }
+                iTile.TileSpriteKeyDownBuffer = tileDown;
+
+            } else {
+                tileLeft = iTile.TileSpriteKeyLeftBuffer;
+                tileRight = iTile.TileSpriteKeyRightBuffer;
+                tileUp = iTile.TileSpriteKeyUpBuffer;
+                tileDown = iTile.TileSpriteKeyDownBuffer;
+            }
+
+            tiles[0] = tileBedrock;
+            tiles[1] = tileWater;
+            tiles[2] = tileGrass;
+            tiles[3] = tileTree;
+            tiles[4] = tileHill;
+            tiles[5] = tileRoad;
+
+            tiles[6] = tileLeft;
+            tiles[7] = tileRight;
+            tiles[8] = tileUp;
+            tiles[9] = tileDown;
+
+            tiles[10] = tile;
+            tiles[11] = tileHighLight;
+            tiles[12] = tileOverlay;
+            return needUpdateSpriteKey;
+        }
+
+        private void ResolveChunkCell(int i, int j, Tile[] tiles) {
+            ITileDefinition iTile = TheOnlyActiveMap.Get(i, j) as ITileDefinition;
+            ResolveCellTiles(iTile, j == chunkAnimationRowY, tiles);
+            iTile.NeedUpdateSpriteKeys = false;
+            // tilemap里这格的内容没有跟着更新, 切换回tilemap后进入视野时要重新SetTile
+            iTile.NeedUpdateSpriteKeysPositionX = int.MinValue;
         }
 
         private void UpdateMapAnimation() {
@@ -801,6 +1037,43 @@ namespace Weathering
             tilemapRight.transform.position = Vector3.right * fraction + Vector3.left;
             tilemapUp.transform.position = Vector3.up * fraction + Vector3.down;
             tilemapDown.transform.position = Vector3.down * fraction + Vector3.up;
+            if (chunkedRenderer.Active) {
+                for (int n = 0; n < chunkArrowRoots.Length; n++) {
+                    chunkArrowRoots[n].position = layers[firstArrowLayer + n].transform.position;
+                }
+            }
+        }
+
+        // 区块网格渲染, 见ChunkedMapRenderer
+        private const int firstArrowLayer = 6; // left, right, up, down
+        private ChunkedMapRenderer chunkedRenderer;
+        private Transform[] chunkArrowRoots;
+        private int chunkAnimationRowY;
+
+        private Transform CreateChunkRoot(string name, Transform parent) {
+            Transform root = new GameObject(name).transform;
+            root.SetParent(parent, false);
+            return root;
+        }
+
+        private void SyncChunkMaterials() {
+            Material[] materials = new Material[layerCount];
+            for (int k = 0; k < layerCount; k++) {
+                materials[k] = layerRenderers[k].sharedMaterial;
+            }
+            chunkedRenderer.SetMaterials(materials); // 材质变化时区块全部重建
+        }
+
+        public bool UseChunkedRenderer {
+            get => chunkedRenderer.Active;
+            set {
+                if (chunkedRenderer.Active == value) return;
+                chunkedRenderer.Active = value;
+                for (int k = 0; k < layerCount; k++) {
+                    layerRenderers[k].enabled = !value;
+                }
+                needFullRedraw = true;
+            }
         }
 
 
@@ -879,6 +1152,7 @@ namespace Weathering
 
             IWeatherDefinition weather = TheOnlyActiveMap as IWeatherDefinition;
             GlobalLight.Ins.UseDayNightCycle = weather != null;
+            PlanetEnvironment environment = weather != null ? weather.Environment : default(PlanetEnvironment);
 
 
 
@@ -888,8 +1162,8 @@ namespace Weathering
             const float heightFactor = 9;
             // 风力
             if (weather != null) {
-                windStrength = weather.WindStrength;
-                windNoise = weather.WindNoise;
+                windStrength = environment.WindStrength;
+                windNoise = environment.WindNoise;
 
                 MaterialOfWater.SetFloat("_Amplitude", Mathf.Lerp(0, 0.5f, Mathf.Clamp01(Mathf.Abs(windNoise))));
 
@@ -907,7 +1181,7 @@ namespace Weathering
                 if (cameraIntegral.sqrMagnitude > integralReset * integralReset) cameraIntegral = Vector2.zero;
 
                 if (weather.Foggy) {
-                    float density = Mathf.Clamp01(weather.FogDensity);
+                    float density = Mathf.Clamp01(environment.FogDensity);
                     if (density > 0) {
                         Fog.SetActive(true);
 
@@ -929,7 +1203,7 @@ namespace Weathering
                 }
 
                 if (weather.Rainy) {
-                    float density = Mathf.Clamp01(weather.RainDensity);
+                    float density = Mathf.Clamp01(environment.RainDensity);
                     if (density > 0) {
                         Rain.SetActive(true);
                         MaterialOfRain.SetFloat("_UVChangeX", cameraIntegral.x / widthFactor);
@@ -949,7 +1223,7 @@ namespace Weathering
                 }
 
                 if (weather.Snowy) {
-                    float density = Mathf.Clamp01(weather.SnowDensity);
+                    float density = Mathf.Clamp01(environment.SnowDensity);
                     if (density > 0) {
                         Snow.SetActive(true);
                         MaterialOfSnow.SetFloat("_UVChangeX", cameraIntegral.x / widthFactor);
@@ -975,7 +1249,7 @@ namespace Weathering
 
             // 白平衡
             if (weather != null) {
-                GlobalVolume.Ins.WhiteBalance.temperature.value = Mathf.Clamp(weather.Temporature, -1, 1) * 60;
+                GlobalVolume.Ins.WhiteBalance.temperature.value = Mathf.Clamp(environment.Temporature, -1, 1) * 60;
                 // GlobalVolume.Ins.WhiteBalance.tint.value = Mathf.Clamp01(weather.Tint) * 100;
             } else {
                 GlobalVolume.Ins.WhiteBalance.temperature.value = 0;
@@ -983,12 +1257,9 @@ namespace Weathering
 
             // 光照
             if (weather != null) {
-                IWeatherDefinition cycle = TheOnlyActiveMap as IWeatherDefinition;
-                float progress_of_day = (float)cycle.ProgressOfDay;
-                float t = progress_of_day * (2 * Mathf.PI);
-
-                float star_light_pos_x = Mathf.Cos(t);
-                float star_light_pos_y = Mathf.Sin(t);
+                float progress_of_day = (float)environment.ProgressOfDay;
+                float star_light_pos_x = environment.StarLightDirection.x;
+                float star_light_pos_y = environment.StarLightDirection.y;
 
 
                 const float threshold = 0.5f;
@@ -1003,22 +1274,8 @@ namespace Weathering
                 MaterialCharacterWithShadow.SetFloat("_StarLightPosX", star_light_pos_x_int);
                 MaterialCharacterWithShadow.SetFloat("_StarLightPosY", star_light_pos_y_int);
 
-                float t_day;
+                float t_day = environment.Daylight;
                 float t_night;
-
-
-                const float twilightTime = 0.125f; // 0.01f - 0.25f
-                if (progress_of_day < twilightTime) {
-                    t_day = progress_of_day / twilightTime;
-                } else if (progress_of_day < 0.5f - twilightTime) {
-                    t_day = 1;
-                } else if (progress_of_day < 0.5f + twilightTime) {
-                    t_day = 1 - (progress_of_day - (0.5f - twilightTime)) / (2 * twilightTime);
-                } else if (progress_of_day < 1 - twilightTime) {
-                    t_day = 0;
-                } else {
-                    t_day = -1 + (progress_of_day - twilightTime);
-                }
                 t_night = 1 - t_day;
 
 
@@ -1162,6 +1419,7 @@ namespace Weathering
                     renderer_tilemapUp.sharedMaterial = MaterialLitWithoutShadow;
                     renderer_tilemapDown.sharedMaterial = MaterialLitWithoutShadow;
                 }
+                SyncChunkMaterials();
             }
         }
         public bool EnableWeather {
@@ -0,0 +1,124 @@
+﻿
+using System;
+using UnityEngine;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 星球一帧内的环境, 由IWeatherDefinition.Environment每帧计算一次, MapView, 天气材质和地块都读这一份
+    /// 星光颜色由MapView.StarLightColorOverTime按ProgressOfDay取值, 这里只算星光方向和强度
+    /// </summary>
+    public readonly struct PlanetEnvironment
+    {
+        public const int MonthForAYear = 12;
+
+        /// <summary>
+        /// time为从1970年开始的秒数
+        /// </summary>
+        public PlanetEnvironment(double time, int secondsForADay, int daysForAMonth) {
+            int daysForAYear = MonthForAYear * daysForAMonth;
+            double days = time / secondsForADay;
+            double years = time / (daysForAYear * secondsForADay);
+            int dayCount = (int)days;
+            int monthCount = (int)(time / (daysForAMonth * secondsForADay));
+            int yearCount = (int)years;
+            double progressOfYear = years - yearCount;
+
+            ProgressOfDay = days - dayCount;
+            ProgressOfYear = progressOfYear;
+            DayCount = dayCount;
+            MonthCount = monthCount;
+            YearCount = yearCount;
+            DayInYear = dayCount - yearCount * daysForAYear;
+            MonthInYear = monthCount - yearCount * MonthForAYear;
+            DayInMonth = dayCount - monthCount * daysForAMonth;
+
+            // 季节
+            float tint = (float)Math.Cos(progressOfYear * (2 * Mathf.PI));
+            Tint = tint;
+            Temporature = -tint;
+
+            // 风和湿度
+            float windNoise = 2 * (float)HashUtility.SimpleValueNoise(4 * days) - 1;
+            float windStrength = windNoise * windNoise * windNoise;
+            float humidity = 2 * (float)HashUtility.SimpleValueNoise(days - 1); // -1~1
+            WindNoise = windNoise;
+            WindStrength = windStrength;
+            Humidity = humidity;
+
+            // 雾和雨雪
+            float t = tint - 0.5f * (float)HashUtility.SimpleValueNoise(days - 1000) - 0.25f;
+            const float smooth = 0.1f;
+            float snow;
+            if (t >= smooth) snow = 1;
+            else if (t <= -smooth) snow = 0;
+            else snow = Mathf.InverseLerp(-smooth, smooth, t);
+            FogDensity = Mathf.Clamp01((humidity + Mathf.Abs(windStrength)) * 0.75f);
+            RainDensity = 1 - snow;
+            SnowDensity = snow;
+
+            // 昼夜
+            float progressOfDay = (float)(days - dayCount);
+            float angle = progressOfDay * (2 * Mathf.PI);
+            StarLightDirection = new Vector2(Mathf.Cos(angle), Mathf.Sin(angle));
+
+            const float twilightTime = 0.125f; // 0.01f - 0.25f
+            float daylight;
+            if (progressOfDay < twilightTime) {
+                daylight = progressOfDay / twilightTime;
+            } else if (progressOfDay < 0.5f - twilightTime) {
+                daylight = 1;
+            } else if (progressOfDay < 0.5f + twilightTime) {
+                daylight = 1 - (progressOfDay - (0.5f - twilightTime)) / (2 * twilightTime);
+            } else if (progressOfDay < 1 - twilightTime) {
+                daylight = 0;
+            } else {
+                daylight = -1 + (progressOfDay - twilightTime);
+            }
+            Daylight = daylight;
+        }
+
+        /// <summary>
+        /// 0-1 昼夜
+        /// </summary>
+        public double ProgressOfDay { get; }
+        /// <summary>
+        /// 0-1 季节
+        /// </summary>
+        public double ProgressOfYear { get; }
+
+        /// <summary>
+        /// 从1970年开始的星球天数, 月数, 年数
+        /// </summary>
+        public int DayCount { get; }
+        public int MonthCount { get; }
+        public int YearCount { get; }
+
+        public int DayInYear { get; }
+        public int MonthInYear { get; }
+        public int DayInMonth { get; }
+
+        public float Temporature { get; }
+        public float Tint { get; }
+
+        public float WindNoise { get; }
+        /// <summary>
+        /// 风力等级
+        /// </summary>
+        public float WindStrength { get; }
+        public float Humidity { get; }
+
+        public float FogDensity { get; }
+        public float RainDensity { get; }
+        public float SnowDensity { get; }
+
+        /// <summary>
+        /// 星光方向, 单位向量
+        /// </summary>
+        public Vector2 StarLightDirection { get; }
+        /// <summary>
+        /// 白天的程度, 白天为1, 夜晚为0, 晨昏时渐变
+        /// </summary>
+        public float Daylight { get; }
+    }
+}
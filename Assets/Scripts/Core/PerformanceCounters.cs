@@ -0,0 +1,220 @@
+﻿
+using System;
+using System.Diagnostics;
+using System.IO;
+using System.Text;
+using System.Threading;
+using Unity.Profiling;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 热点代码段, 顺序即CSV列顺序
+    /// </summary>
+    public enum PerformanceSection
+    {
+        UpdateMap,
+        UpdateWeather,
+        UpdateMapAnimation,
+        SaveGame,
+        LoadMapBody,
+        SaveMapBody,
+        GenerateNoise,
+    }
+
+    /// <summary>
+    /// 每帧计数, 顺序即CSV列顺序
+    /// </summary>
+    public enum PerformanceCounter
+    {
+        TilemapSetTile, // 传给Tilemap.SetTiles/SetTilesBlock的格子数, 每层算一次
+        SpriteKeyRefresh, // 重新读取贴图id的地块数
+        TileMiss, // Res.TryGetTile按id查询时缓存未命中, 需要按名字解析
+        ChunkRebuild, // ChunkedMapRenderer重建的区块数
+    }
+
+    /// <summary>
+    /// 内置的性能统计
+    /// 1. Measure包住热点代码段, 总是打ProfilerMarker, 供Unity Profiler使用; 开启记录时另外用Stopwatch计时
+    /// 2. Count累加每帧计数, 只是整数加法, 不开启也可以调用
+    /// 3. 开启记录时每帧EndFrame一次, 最近MaxFrames帧存在环形缓冲里, 可导出为CSV
+    /// 计时和计数用Interlocked累加, 存档线程, 地形生成的并行行也可以调用
+    /// </summary>
+    public static class PerformanceCounters
+    {
+        public const int MaxFrames = 1800; // 60帧时约30秒
+        public const int MaxExportFiles = 5; // 导出目录只保留最近几份
+
+        private static readonly string[] sectionNames = Enum.GetNames(typeof(PerformanceSection));
+        private static readonly string[] counterNames = Enum.GetNames(typeof(PerformanceCounter));
+        public static int SectionCount => sectionNames.Length;
+        public static int CounterCount => counterNames.Length;
+
+        private static readonly ProfilerMarker[] markers = CreateMarkers();
+        private static ProfilerMarker[] CreateMarkers() {
+            ProfilerMarker[] result = new ProfilerMarker[sectionNames.Length];
+            for (int k = 0; k < result.Length; k++) {
+                result[k] = new ProfilerMarker($"Weathering.{sectionNames[k]}");
+            }
+            return result;
+        }
+
+        // 本帧累计
+        private static readonly long[] sectionTicks = new long[sectionNames.Length];
+        private static readonly long[] counters = new long[counterNames.Length];
+
+        public static bool Recording { get; private set; }
+
+        public struct Scope : IDisposable
+        {
+            private readonly int section;
+            private readonly long start;
+            public Scope(PerformanceSection section) {
+                this.section = (int)section;
+                markers[this.section].Begin();
+                start = Recording ? Stopwatch.GetTimestamp() : 0;
+            }
+            public void Dispose() {
+                if (start != 0) Interlocked.Add(ref sectionTicks[section], Stopwatch.GetTimestamp() - start);
+                markers[section].End();
+            }
+        }
+
+        /// <summary>
+        /// using (PerformanceCounters.Measure(PerformanceSection.UpdateMap)) { ... }
+        /// </summary>
+        public static Scope Measure(PerformanceSection section) => new Scope(section);
+
+        public static void Count(PerformanceCounter counter, int n = 1) {
+            Interlocked.Add(ref counters[(int)counter], n);
+        }
+
+        // 环形缓冲, 每帧一行
+        private static int frameCount = 0; // 已记录的帧数, 不超过MaxFrames
+        private static int frameNext = 0;
+        private static readonly long[] frameIndex = new long[MaxFrames];
+        private static readonly float[] frameTime = new float[MaxFrames];
+        private static readonly float[] frameDeltaMs = new float[MaxFrames];
+        private static readonly float[] frameSectionMs = new float[MaxFrames * sectionNames.Length];
+        private static readonly int[] frameCounters = new int[MaxFrames * counterNames.Length];
+        private static readonly long[] frameGCAllocBytes = new long[MaxFrames];
+        private static readonly int[] frameGCCollections = new int[MaxFrames];
+
+        private static long lastTotalMemory = 0;
+        private static int lastCollectionCount = 0;
+
+        public static void SetRecording(bool recording) {
+            if (Recording == recording) return;
+            Recording = recording;
+            Array.Clear(sectionTicks, 0, sectionTicks.Length);
+            Array.Clear(counters, 0, counters.Length);
+            lastTotalMemory = GC.GetTotalMemory(false);
+            lastCollectionCount = GC.CollectionCount(0);
+        }
+
+        /// <summary>
+        /// 每帧末尾调用一次, 把本帧累计写入环形缓冲并清零
+        /// </summary>
+        public static void EndFrame(long frame, float time, float deltaTime) {
+            if (!Recording) return;
+            int row = frameNext;
+            frameIndex[row] = frame;
+            frameTime[row] = time;
+            frameDeltaMs[row] = deltaTime * 1000f;
+            for (int k = 0; k < sectionTicks.Length; k++) {
+                frameSectionMs[row * sectionTicks.Length + k] = (float)(Interlocked.Exchange(ref sectionTicks[k], 0) * 1000.0 / Stopwatch.Frequency);
+            }
+            for (int k = 0; k < counters.Length; k++) {
+                frameCounters[row * counters.Length + k] = (int)Interlocked.Exchange(ref counters[k], 0);
+            }
+
+            // Mono没有按帧的分配统计, 用托管堆大小的增量估计。发生GC时增量不准, 记为当前堆大小
+            long totalMemory = GC.GetTotalMemory(false);
+            int collectionCount = GC.CollectionCount(0);
+            frameGCAllocBytes[row] = totalMemory >= lastTotalMemory ? totalMemory - lastTotalMemory : totalMemory;
+            frameGCCollections[row] = collectionCount - lastCollectionCount;
+            lastTotalMemory = totalMemory;
+            lastCollectionCount = collectionCount;
+
+            frameNext = (frameNext + 1) % MaxFrames;
+            if (frameCount < MaxFrames) frameCount++;
+        }
+
+        public static int FrameCount => frameCount;
+        private static int RowOf(int framesAgo) => (frameNext - 1 - framesAgo + MaxFrames * 2) % MaxFrames;
+
+        public static float SectionMs(PerformanceSection section, int framesAgo = 0) => frameCount == 0 ? 0 : frameSectionMs[RowOf(framesAgo) * sectionNames.Length + (int)section];
+        public static int CounterValue(PerformanceCounter counter, int framesAgo = 0) => frameCount == 0 ? 0 : frameCounters[RowOf(framesAgo) * counterNames.Length + (int)counter];
+        public static long GCAllocBytes(int framesAgo = 0) => frameCount == 0 ? 0 : frameGCAllocBytes[RowOf(framesAgo)];
+        public static int GCCollections(int framesAgo = 0) => frameCount == 0 ? 0 : frameGCCollections[RowOf(framesAgo)];
+        public static float DeltaMs(int framesAgo = 0) => frameCount == 0 ? 0 : frameDeltaMs[RowOf(framesAgo)];
+
+        /// <summary>
+        /// 最近frames帧某代码段的平均耗时
+        /// </summary>
+        public static float AverageSectionMs(PerformanceSection section, int frames) {
+            frames = Math.Min(frames, frameCount);
+            if (frames == 0) return 0;
+            float sum = 0;
+            for (int i = 0; i < frames; i++) {
+                sum += SectionMs(section, i);
+            }
+            return sum / frames;
+        }
+        public static float AverageDeltaMs(int frames) {
+            frames = Math.Min(frames, frameCount);
+            if (frames == 0) return 0;
+            float sum = 0;
+            for (int i = 0; i < frames; i++) {
+                sum += DeltaMs(i);
+            }
+            return sum / frames;
+        }
+
+        public static string ToCsv() {
+            StringBuilder sb = new StringBuilder((frameCount + 1) * 128);
+            sb.Append("frame,time,delta_ms");
+            foreach (var name in sectionNames) sb.Append(',').Append(name).Append("_ms");
+            foreach (var name in counterNames) sb.Append(',').Append(name);
+            sb.Append(",GCAllocBytes,GCCollections\n");
+
+            System.Globalization.CultureInfo invariant = System.Globalization.CultureInfo.InvariantCulture;
+            for (int i = frameCount - 1; i >= 0; i--) {
+                int row = RowOf(i);
+                sb.Append(frameIndex[row]);
+                sb.Append(',').Append(frameTime[row].ToString("F3", invariant));
+                sb.Append(',').Append(frameDeltaMs[row].ToString("F3", invariant));
+                for (int k = 0; k < sectionNames.Length; k++) {
+                    sb.Append(',').Append(frameSectionMs[row * sectionNames.Length + k].ToString("F3", invariant));
+                }
+                for (int k = 0; k < counterNames.Length; k++) {
+                    sb.Append(',').Append(frameCounters[row * counterNames.Length + k]);
+                }
+                sb.Append(',').Append(frameGCAllocBytes[row]);
+                sb.Append(',').Append(frameGCCollections[row]);
+                sb.Append('\n');
+            }
+            return sb.ToString();
+        }
+
+        /// <summary>
+        /// 把最近MaxFrames帧写成CSV, 返回文件路径。目录里超过MaxExportFiles份时删除最旧的
+        /// </summary>
+        public static string ExportCsv(string directory) {
+            if (!Directory.Exists(directory)) {
+                Directory.CreateDirectory(directory);
+            }
+            string path = Path.Combine(directory, $"performance-{DateTime.Now:yyyyMMdd-HHmmss}.csv");
+            File.WriteAllText(path, ToCsv(), Encoding.UTF8);
+
+            string[] files = Directory.GetFiles(directory, "performance-*.csv");
+            if (files.Length > MaxExportFiles) {
+                Array.Sort(files, StringComparer.Ordinal); // 文件名里的时间可按字符串排序
+                for (int i = 0; i < files.Length - MaxExportFiles; i++) {
+                    File.Delete(files[i]);
+                }
+            }
+            return path;
+        }
+    }
+}
@@ -82,6 +82,34 @@ namespace Weathering
             return unchecked(Hash((uint)(offset * width + height + i + j * width)));
         }
 
+        /// <summary>
+        /// 批量计算 Hash(i0 + k, j, width, height, offset), k从0到count, 结果与逐个调用一致
+        /// </summary>
+        public static void HashRow(int i0, int j, int width, int height, int offset, uint[] output, int outputOffset, int count) {
+            HashSequence(unchecked((uint)(offset * width + height + i0 + j * width)), 1, output, outputOffset, count);
+        }
+        /// <summary>
+        /// 批量计算 Hash(i, j0 + k, width, height, offset), k从0到count, 结果与逐个调用一致
+        /// </summary>
+        public static void HashColumn(int i, int j0, int width, int height, int offset, uint[] output, int outputOffset, int count) {
+            HashSequence(unchecked((uint)(offset * width + height + i + j0 * width)), unchecked((uint)width), output, outputOffset, count);
+        }
+        // Mono和IL2CPP都不会把Vector<uint>编译成SIMD指令, 这里用不跨调用的紧凑循环
+        private static void HashSequence(uint start, uint step, uint[] output, int outputOffset, int count) {
+            if (outputOffset < 0 || count < 0 || outputOffset + count > output.Length) throw new Exception();
+            uint seed = start;
+            for (int k = 0; k < count; k++) {
+                uint a = seed;
+                a = (a ^ 61) ^ (a >> 16);
+                a = a + (a << 3);
+                a = a ^ (a >> 4);
+                a = a * 0x27d4eb2d;
+                a = a ^ (a >> 15);
+                output[outputOffset + k] = a;
+                seed = unchecked(seed + step);
+            }
+        }
+
         public static uint Hash(Vector2Int pos, Vector2Int size) {
             return Hash((uint)(pos.x + pos.y + size.x));
         }
@@ -159,6 +187,54 @@ namespace Weathering
 
 
 
+        /// <summary>
+        /// 一行的PerlinNoise, output[outputOffset + i] 与 PerlinNoise((float)size * i / width, (float)size * j / height, size, size, layer) 一致, i从0到width
+        /// 与y有关的部分每行只算一次, 同一格子内的四个梯度只算一次
+        /// </summary>
+        public static void PerlinNoiseRow(int size, int j, int width, int height, int layer, float[] output, int outputOffset = 0) {
+            if (outputOffset < 0 || outputOffset + width > output.Length) throw new Exception();
+            float y = (float)size * j / height;
+            int p0y = (int)(y);
+            int p1y = p0y + 1;
+            float v0y = y - p0y; // P0, P3点方向向量的y
+            float v1y = y - p1y; // P1, P2点方向向量的y
+            float d1 = y - p0y;
+            d1 = d1 * d1 * d1 * (d1 * (d1 * 6 - 15) + 10);
+
+            int p0x = 0;
+            float g0x = 0, g0y = 0, g1x = 0, g1y = 0, g2x = 0, g2y = 0, g3x = 0, g3y = 0;
+            for (int i = 0; i < width; i++) {
+                float x = (float)size * i / width;
+                int cellX = (int)(x);
+                if (i == 0 || cellX != p0x) {
+                    p0x = cellX;
+                    Vector2 g0 = RandomVec2Simple(p0x, p0y, size, size, layer);
+                    Vector2 g1 = RandomVec2Simple(p0x, p1y, size, size, layer);
+                    Vector2 g2 = RandomVec2Simple(p0x + 1, p1y, size, size, layer);
+                    Vector2 g3 = RandomVec2Simple(p0x + 1, p0y, size, size, layer);
+                    g0x = g0.x; g0y = g0.y;
+                    g1x = g1.x; g1y = g1.y;
+                    g2x = g2.x; g2y = g2.y;
+                    g3x = g3.x; g3y = g3.y;
+                }
+                float v0x = x - p0x;
+                float v2x = x - (p0x + 1);
+
+                float product0 = g0x * v0x + g0y * v0y;
+                float product1 = g1x * v0x + g1y * v1y;
+                float product2 = g2x * v2x + g2y * v1y;
+                float product3 = g3x * v2x + g3y * v0y;
+
+                float d0 = x - p0x;
+                d0 = d0 * d0 * d0 * (d0 * (d0 * 6 - 15) + 10);
+
+                float n0 = product1 * (1.0f - d0) + product2 * d0;
+                float n1 = product0 * (1.0f - d0) + product3 * d0;
+                output[outputOffset + i] = n1 * (1.0f - d1) + n0 * d1;
+            }
+        }
+
+
         /// <summary>
         /// Thomas has 64-bit integer hashes too. I don't have any of those yet.
         /// Here's a way to do it in 6 shifts:
@@ -10,6 +10,7 @@ namespace Weathering
     {
         // Tile GetTile(string name);
         bool TryGetTile(string name, out Tile result); // 这种形式便于判断
+        bool TryGetTile(int spriteId, out Tile result); // 渲染用, 按整数id查数组
         // Sprite GetSprite(string name);
         Sprite TryGetSprite(string name); // 这种形式便于直接返回null
     }
@@ -18,6 +19,64 @@ namespace Weathering
     {
         public static IRes Ins;
 
+        /// <summary>
+        /// 贴图名字驻留为整数id, 第一次出现时分配, 之后的查询不再拼接和哈希字符串
+        /// id只在本次运行中有效, 不要存档
+        /// </summary>
+        public const int NoSprite = 0; // 对应null
+        private static readonly Dictionary<string, int> spriteIds = new Dictionary<string, int>();
+        private static readonly List<string> spriteNames = new List<string> { null };
+        private static readonly Dictionary<string, int[]> spriteIdTables = new Dictionary<string, int[]>();
+
+        public static int SpriteId(string name) {
+            if (name == null) return NoSprite;
+            if (spriteIds.TryGetValue(name, out int id)) {
+                return id;
+            }
+            id = spriteNames.Count;
+            spriteNames.Add(name);
+            spriteIds.Add(name, id);
+            return id;
+        }
+        public static string SpriteName(int spriteId) => spriteNames[spriteId];
+
+        /// <summary>
+        /// {prefix}_{index} 形式的一组贴图id, 用于规则贴图和帧动画
+        /// </summary>
+        public static int[] SpriteIds(string prefix, int count) {
+            if (spriteIdTables.TryGetValue(prefix, out int[] table) && table.Length >= count) {
+                return table;
+            }
+            table = new int[count];
+            for (int i = 0; i < count; i++) {
+                table[i] = SpriteId($"{prefix}_{i}");
+            }
+            spriteIdTables[prefix] = table;
+            return table;
+        }
+
+        // 下标是贴图id, 第一次渲染时解析
+        private readonly List<Tile> tilesById = new List<Tile>();
+        private readonly List<bool> tilesByIdResolved = new List<bool>();
+        public bool TryGetTile(int spriteId, out Tile result) {
+            if (spriteId == NoSprite) {
+                result = null;
+                return false;
+            }
+            while (tilesById.Count <= spriteId) {
+                tilesById.Add(null);
+                tilesByIdResolved.Add(false);
+            }
+            if (!tilesByIdResolved[spriteId]) {
+                PerformanceCounters.Count(PerformanceCounter.TileMiss);
+                TryGetTile(spriteNames[spriteId], out Tile tile);
+                tilesById[spriteId] = tile;
+                tilesByIdResolved[spriteId] = true;
+            }
+            result = tilesById[spriteId];
+            return result != null;
+        }
+
         [SerializeField]
         private Tile EmptyTilePrefab;
 
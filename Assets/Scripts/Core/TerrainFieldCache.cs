@@ -0,0 +1,190 @@
+﻿
+using System;
+using System.Collections.Generic;
+using System.IO;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 一张地图生成的地形噪声。数组为扁平数组, 下标为 i + j * Width, 没有生成的为null
+    /// </summary>
+    public class TerrainFields
+    {
+        public string MapKey;
+        public string Signature;
+        public int Width;
+        public int Height;
+        public int[] Altitudes;
+        public AltitudeTypeId[] AltitudeTypes;
+        public int[] Moistures;
+        public MoistureTypeId[] MoistureTypes;
+        public int[] Temporatures;
+        public TemporatureTypeId[] TemporatureTypes;
+    }
+
+    /// <summary>
+    /// 地形噪声由地图参数唯一决定, 进入地图时不必每次重新生成
+    /// 1. 内存里保留最近访问的几张地图
+    /// 2. 设置了DiskPath时, 同时存为二进制文件, 以MapKey命名
+    /// 签名包含生成器版本和所有生成参数, 签名不一致的缓存视为不存在
+    /// </summary>
+    public static class TerrainFieldCache
+    {
+        // 修改噪声算法时加一
+        public const int GeneratorVersion = 1;
+        public const int MemoryCapacity = 8;
+        public const string Suffix = ".terrain";
+        private const int Magic = 0x57544601; // 缓存文件头
+
+        /// <summary>
+        /// 磁盘缓存目录, null时只用内存缓存
+        /// </summary>
+        public static string DiskPath { get; set; }
+
+        private static readonly Dictionary<string, LinkedListNode<TerrainFields>> memory = new Dictionary<string, LinkedListNode<TerrainFields>>();
+        private static readonly LinkedList<TerrainFields> recent = new LinkedList<TerrainFields>();
+
+        public static bool TryGet(string mapKey, string signature, out TerrainFields fields) {
+            if (mapKey == null) {
+                fields = null;
+                return false;
+            }
+            if (memory.TryGetValue(mapKey, out var node)) {
+                if (node.Value.Signature == signature) {
+                    recent.Remove(node);
+                    recent.AddFirst(node);
+                    fields = node.Value;
+                    return true;
+                }
+                RemoveNode(node);
+            }
+            fields = ReadDisk(mapKey, signature);
+            if (fields == null) return false;
+            Remember(fields);
+            return true;
+        }
+
+        public static void Put(string mapKey, TerrainFields fields) {
+            if (mapKey == null) return;
+            fields.MapKey = mapKey;
+            Remember(fields);
+            WriteDisk(mapKey, fields);
+        }
+
+        public static void Remove(string mapKey) {
+            if (mapKey == null) return;
+            if (memory.TryGetValue(mapKey, out var node)) {
+                RemoveNode(node);
+            }
+            if (DiskPath != null) {
+                string path = DiskPath + mapKey + Suffix;
+                if (File.Exists(path)) File.Delete(path);
+            }
+        }
+
+        public static void ClearMemory() {
+            memory.Clear();
+            recent.Clear();
+        }
+
+        private static void Remember(TerrainFields fields) {
+            if (memory.TryGetValue(fields.MapKey, out var old)) {
+                RemoveNode(old);
+            }
+            memory.Add(fields.MapKey, recent.AddFirst(fields));
+            while (recent.Count > MemoryCapacity) {
+                RemoveNode(recent.Last);
+            }
+        }
+        private static void RemoveNode(LinkedListNode<TerrainFields> node) {
+            recent.Remove(node);
+            memory.Remove(node.Value.MapKey);
+        }
+
+
+        private static void WriteDisk(string mapKey, TerrainFields fields) {
+            if (DiskPath == null) return;
+            if (!Directory.Exists(DiskPath)) Directory.CreateDirectory(DiskPath);
+            string path = DiskPath + mapKey + Suffix;
+            string temp = path + ".temp";
+            using (var writer = new BinaryWriter(File.Create(temp))) {
+                writer.Write(Magic);
+                writer.Write(fields.Signature);
+                writer.Write(fields.Width);
+                writer.Write(fields.Height);
+                WriteInts(writer, fields.Altitudes);
+                WriteBytes(writer, fields.AltitudeTypes, id => (byte)id);
+                WriteInts(writer, fields.Moistures);
+                WriteBytes(writer, fields.MoistureTypes, id => (byte)id);
+                WriteInts(writer, fields.Temporatures);
+                WriteBytes(writer, fields.TemporatureTypes, id => (byte)id);
+            }
+            if (File.Exists(path)) File.Delete(path);
+            File.Move(temp, path);
+        }
+
+        private static TerrainFields ReadDisk(string mapKey, string signature) {
+            if (DiskPath == null) return null;
+            string path = DiskPath + mapKey + Suffix;
+            if (!File.Exists(path)) return null;
+            try {
+                using (var reader = new BinaryReader(File.OpenRead(path))) {
+                    if (reader.ReadInt32() != Magic) return null;
+                    if (reader.ReadString() != signature) return null;
+                    TerrainFields fields = new TerrainFields();
+                    fields.MapKey = mapKey;
+                    fields.Signature = signature;
+                    fields.Width = reader.ReadInt32();
+                    fields.Height = reader.ReadInt32();
+                    int count = fields.Width * fields.Height;
+                    fields.Altitudes = ReadInts(reader, count);
+                    fields.AltitudeTypes = ReadBytes(reader, count, b => (AltitudeTypeId)b);
+                    fields.Moistures = ReadInts(reader, count);
+                    fields.MoistureTypes = ReadBytes(reader, count, b => (MoistureTypeId)b);
+                    fields.Temporatures = ReadInts(reader, count);
+                    fields.TemporatureTypes = ReadBytes(reader, count, b => (TemporatureTypeId)b);
+                    return fields;
+                }
+            } catch (EndOfStreamException) {
+                // 缓存文件不完整, 重新生成
+                return null;
+            }
+        }
+
+        private static void WriteInts(BinaryWriter writer, int[] array) {
+            writer.Write(array != null);
+            if (array == null) return;
+            byte[] bytes = new byte[array.Length * sizeof(int)];
+            Buffer.BlockCopy(array, 0, bytes, 0, bytes.Length);
+            writer.Write(bytes);
+        }
+        private static int[] ReadInts(BinaryReader reader, int count) {
+            if (!reader.ReadBoolean()) return null;
+            byte[] bytes = reader.ReadBytes(count * sizeof(int));
+            if (bytes.Length != count * sizeof(int)) throw new EndOfStreamException();
+            int[] array = new int[count];
+            Buffer.BlockCopy(bytes, 0, array, 0, bytes.Length);
+            return array;
+        }
+
+        private static void WriteBytes<T>(BinaryWriter writer, T[] array, Func<T, byte> toByte) {
+            writer.Write(array != null);
+            if (array == null) return;
+            byte[] bytes = new byte[array.Length];
+            for (int i = 0; i < array.Length; i++) {
+                bytes[i] = toByte(array[i]);
+            }
+            writer.Write(bytes);
+        }
+        private static T[] ReadBytes<T>(BinaryReader reader, int count, Func<byte, T> fromByte) {
+            if (!reader.ReadBoolean()) return null;
+            byte[] bytes = reader.ReadBytes(count);
+            if (bytes.Length != count) throw new EndOfStreamException();
+            T[] array = new T[count];
+            for (int i = 0; i < count; i++) {
+                array[i] = fromByte(bytes[i]);
+            }
+            return array;
+        }
+    }
+}
@@ -0,0 +1,160 @@
+﻿
+// 由TileFactoryGenerator生成, 不要手动修改。菜单: Weathering/生成地块构造表
+using System;
+using System.Collections.Generic;
+
+namespace Weathering
+{
+    public static partial class TypeRegistry
+    {
+        private static readonly Dictionary<Type, Func<ITileDefinition>> generatedTileFactories = new Dictionary<Type, Func<ITileDefinition>> {
+            { typeof(global::Weathering.AESReward), () => new global::Weathering.AESReward() },
+            { typeof(global::Weathering.AbstractMuseum), () => new global::Weathering.AbstractMuseum() },
+            { typeof(global::Weathering.BerryBush), () => new global::Weathering.BerryBush() },
+            { typeof(global::Weathering.CellarForPersonalStorage), () => new global::Weathering.CellarForPersonalStorage() },
+            { typeof(global::Weathering.CheatHouse), () => new global::Weathering.CheatHouse() },
+            { typeof(global::Weathering.FactoryAsAirSeparator), () => new global::Weathering.FactoryAsAirSeparator() },
+            { typeof(global::Weathering.FactoryOfAluminiumWorking), () => new global::Weathering.FactoryOfAluminiumWorking() },
+            { typeof(global::Weathering.FactoryOfCircuitBoardAdvanced), () => new global::Weathering.FactoryOfCircuitBoardAdvanced() },
+            { typeof(global::Weathering.FactoryOfCircuitBoardIntegrated), () => new global::Weathering.FactoryOfCircuitBoardIntegrated() },
+            { typeof(global::Weathering.FactoryOfCircuitBoardSimple), () => new global::Weathering.FactoryOfCircuitBoardSimple() },
+            { typeof(global::Weathering.FactoryOfCombustionMotor), () => new global::Weathering.FactoryOfCombustionMotor() },
+            { typeof(global::Weathering.FactoryOfConductorOfCopperWire), () => new global::Weathering.FactoryOfConductorOfCopperWire() },
+            { typeof(global::Weathering.FactoryOfCopperSmelting), () => new global::Weathering.FactoryOfCopperSmelting() },
+            { typeof(global::Weathering.FactoryOfDesalination), () => new global::Weathering.FactoryOfDesalination() },
+            { typeof(global::Weathering.FactoryOfElectroMotor), () => new global::Weathering.FactoryOfElectroMotor() },
+            { typeof(global::Weathering.FactoryOfElectrolysisOfSaltedWater), () => new global::Weathering.FactoryOfElectrolysisOfSaltedWater() },
+            { typeof(global::Weathering.FactoryOfElectrolysisOfWater), () => new global::Weathering.FactoryOfElectrolysisOfWater() },
+            { typeof(global::Weathering.FactoryOfFuelPack_Oxygen_Hydrogen), () => new global::Weathering.FactoryOfFuelPack_Oxygen_Hydrogen() },
+            { typeof(global::Weathering.FactoryOfFuelPack_Oxygen_JetFuel), () => new global::Weathering.FactoryOfFuelPack_Oxygen_JetFuel() },
+            { typeof(global::Weathering.FactoryOfHeavyOilCracking), () => new global::Weathering.FactoryOfHeavyOilCracking() },
+            { typeof(global::Weathering.FactoryOfIronSmelting), () => new global::Weathering.FactoryOfIronSmelting() },
+            { typeof(global::Weathering.FactoryOfJetFuel), () => new global::Weathering.FactoryOfJetFuel() },
+            { typeof(global::Weathering.FactoryOfLightMaterial), () => new global::Weathering.FactoryOfLightMaterial() },
+            { typeof(global::Weathering.FactoryOfLightOilCracking), () => new global::Weathering.FactoryOfLightOilCracking() },
+            { typeof(global::Weathering.FactoryOfPetroleumRefining), () => new global::Weathering.FactoryOfPetroleumRefining() },
+            { typeof(global::Weathering.FactoryOfPlastic), () => new global::Weathering.FactoryOfPlastic() },
+            { typeof(global::Weathering.FactoryOfSatelliteComponent), () => new global::Weathering.FactoryOfSatelliteComponent() },
+            { typeof(global::Weathering.FactoryOfSolarPanelComponent), () => new global::Weathering.FactoryOfSolarPanelComponent() },
+            { typeof(global::Weathering.FactoryOfSteelGear), () => new global::Weathering.FactoryOfSteelGear() },
+            { typeof(global::Weathering.FactoryOfSteelPipe), () => new global::Weathering.FactoryOfSteelPipe() },
+            { typeof(global::Weathering.FactoryOfSteelPlate), () => new global::Weathering.FactoryOfSteelPlate() },
+            { typeof(global::Weathering.FactoryOfSteelRod), () => new global::Weathering.FactoryOfSteelRod() },
+            { typeof(global::Weathering.FactoryOfSteelWire), () => new global::Weathering.FactoryOfSteelWire() },
+            { typeof(global::Weathering.FactoryOfSteelWorking), () => new global::Weathering.FactoryOfSteelWorking() },
+            { typeof(global::Weathering.FactoryOfTurbine), () => new global::Weathering.FactoryOfTurbine() },
+            { typeof(global::Weathering.FactoryOfWindTurbineComponent), () => new global::Weathering.FactoryOfWindTurbineComponent() },
+            { typeof(global::Weathering.Farm), () => new global::Weathering.Farm() },
+            { typeof(global::Weathering.ForestLoggingCamp), () => new global::Weathering.ForestLoggingCamp() },
+            { typeof(global::Weathering.Hennery), () => new global::Weathering.Hennery() },
+            { typeof(global::Weathering.HuntingGround), () => new global::Weathering.HuntingGround() },
+            { typeof(global::Weathering.LaunchSite), () => new global::Weathering.LaunchSite() },
+            { typeof(global::Weathering.LibraryOfAgriculture), () => new global::Weathering.LibraryOfAgriculture() },
+            { typeof(global::Weathering.LibraryOfAll), () => new global::Weathering.LibraryOfAll() },
+            { typeof(global::Weathering.LibraryOfConstruction), () => new global::Weathering.LibraryOfConstruction() },
+            { typeof(global::Weathering.LibraryOfEconomy), () => new global::Weathering.LibraryOfEconomy() },
+            { typeof(global::Weathering.LibraryOfGeography), () => new global::Weathering.LibraryOfGeography() },
+            { typeof(global::Weathering.LibraryOfHandcraft), () => new global::Weathering.LibraryOfHandcraft() },
+            { typeof(global::Weathering.LibraryOfLogistics), () => new global::Weathering.LibraryOfLogistics() },
+            { typeof(global::Weathering.LibraryOfMetalWorking), () => new global::Weathering.LibraryOfMetalWorking() },
+            { typeof(global::Weathering.MagicSchool), () => new global::Weathering.MagicSchool() },
+            { typeof(global::Weathering.MapOfGalaxyDefaultTile), () => new global::Weathering.MapOfGalaxyDefaultTile() },
+            { typeof(global::Weathering.MapOfPlanetDefaultTile), () => new global::Weathering.MapOfPlanetDefaultTile() },
+            { typeof(global::Weathering.MapOfStarSystemDefaultTile), () => new global::Weathering.MapOfStarSystemDefaultTile() },
+            { typeof(global::Weathering.MapOfUniverseDefaultTile), () => new global::Weathering.MapOfUniverseDefaultTile() },
+            { typeof(global::Weathering.MarketForPlayer), () => new global::Weathering.MarketForPlayer() },
+            { typeof(global::Weathering.MarketForSpaceProgram), () => new global::Weathering.MarketForSpaceProgram() },
+            { typeof(global::Weathering.MarketOfAgriculture), () => new global::Weathering.MarketOfAgriculture() },
+            { typeof(global::Weathering.MarketOfHandcraft), () => new global::Weathering.MarketOfHandcraft() },
+            { typeof(global::Weathering.MarketOfMetalProduct), () => new global::Weathering.MarketOfMetalProduct() },
+            { typeof(global::Weathering.MarketOfMineral), () => new global::Weathering.MarketOfMineral() },
+            { typeof(global::Weathering.MineOfAluminum), () => new global::Weathering.MineOfAluminum() },
+            { typeof(global::Weathering.MineOfClay), () => new global::Weathering.MineOfClay() },
+            { typeof(global::Weathering.MineOfCoal), () => new global::Weathering.MineOfCoal() },
+            { typeof(global::Weathering.MineOfCopper), () => new global::Weathering.MineOfCopper() },
+            { typeof(global::Weathering.MineOfGold), () => new global::Weathering.MineOfGold() },
+            { typeof(global::Weathering.MineOfIron), () => new global::Weathering.MineOfIron() },
+            { typeof(global::Weathering.MineOfSalt), () => new global::Weathering.MineOfSalt() },
+            { typeof(global::Weathering.MineOfSand), () => new global::Weathering.MineOfSand() },
+            { typeof(global::Weathering.MountainMine), () => new global::Weathering.MountainMine() },
+            { typeof(global::Weathering.MountainQuarry), () => new global::Weathering.MountainQuarry() },
+            { typeof(global::Weathering.OilDriller), () => new global::Weathering.OilDriller() },
+            { typeof(global::Weathering.OilDrillerOnSea), () => new global::Weathering.OilDrillerOnSea() },
+            { typeof(global::Weathering.Pasture), () => new global::Weathering.Pasture() },
+            { typeof(global::Weathering.PlanetLander), () => new global::Weathering.PlanetLander() },
+            { typeof(global::Weathering.PowerGeneratorOfCoal), () => new global::Weathering.PowerGeneratorOfCoal() },
+            { typeof(global::Weathering.PowerGeneratorOfLiquefiedPetroleumGas), () => new global::Weathering.PowerGeneratorOfLiquefiedPetroleumGas() },
+            { typeof(global::Weathering.PowerGeneratorOfNulearFissionEnergy), () => new global::Weathering.PowerGeneratorOfNulearFissionEnergy() },
+            { typeof(global::Weathering.PowerGeneratorOfNulearFusionEnergy), () => new global::Weathering.PowerGeneratorOfNulearFusionEnergy() },
+            { typeof(global::Weathering.PowerGeneratorOfSolarPanelStation), () => new global::Weathering.PowerGeneratorOfSolarPanelStation() },
+            { typeof(global::Weathering.PowerGeneratorOfWindTurbineStation), () => new global::Weathering.PowerGeneratorOfWindTurbineStation() },
+            { typeof(global::Weathering.PowerGeneratorOfWood), () => new global::Weathering.PowerGeneratorOfWood() },
+            { typeof(global::Weathering.PowerPlant), () => new global::Weathering.PowerPlant() },
+            { typeof(global::Weathering.Pyramid), () => new global::Weathering.Pyramid() },
+            { typeof(global::Weathering.RecycleStation), () => new global::Weathering.RecycleStation() },
+            { typeof(global::Weathering.ResidenceCoastal), () => new global::Weathering.ResidenceCoastal() },
+            { typeof(global::Weathering.ResidenceOfBrick), () => new global::Weathering.ResidenceOfBrick() },
+            { typeof(global::Weathering.ResidenceOfConcrete), () => new global::Weathering.ResidenceOfConcrete() },
+            { typeof(global::Weathering.ResidenceOfGrass), () => new global::Weathering.ResidenceOfGrass() },
+            { typeof(global::Weathering.ResidenceOfStone), () => new global::Weathering.ResidenceOfStone() },
+            { typeof(global::Weathering.ResidenceOfWood), () => new global::Weathering.ResidenceOfWood() },
+            { typeof(global::Weathering.ResidenceOverTree), () => new global::Weathering.ResidenceOverTree() },
+            { typeof(global::Weathering.RoadAsBridge), () => new global::Weathering.RoadAsBridge() },
+            { typeof(global::Weathering.RoadAsCanal), () => new global::Weathering.RoadAsCanal() },
+            { typeof(global::Weathering.RoadAsRailRoad), () => new global::Weathering.RoadAsRailRoad() },
+            { typeof(global::Weathering.RoadAsTunnel), () => new global::Weathering.RoadAsTunnel() },
+            { typeof(global::Weathering.RoadForFluid), () => new global::Weathering.RoadForFluid() },
+            { typeof(global::Weathering.RoadForSolid), () => new global::Weathering.RoadForSolid() },
+            { typeof(global::Weathering.RoadLoaderOfRoadAsCanal), () => new global::Weathering.RoadLoaderOfRoadAsCanal() },
+            { typeof(global::Weathering.RoadLoaderOfRoadAsRailRoad), () => new global::Weathering.RoadLoaderOfRoadAsRailRoad() },
+            { typeof(global::Weathering.RoadOfConcrete), () => new global::Weathering.RoadOfConcrete() },
+            { typeof(global::Weathering.RoadOfStone), () => new global::Weathering.RoadOfStone() },
+            { typeof(global::Weathering.SchoolOfAll), () => new global::Weathering.SchoolOfAll() },
+            { typeof(global::Weathering.SchoolOfChemistry), () => new global::Weathering.SchoolOfChemistry() },
+            { typeof(global::Weathering.SchoolOfElectronics), () => new global::Weathering.SchoolOfElectronics() },
+            { typeof(global::Weathering.SchoolOfEngineering), () => new global::Weathering.SchoolOfEngineering() },
+            { typeof(global::Weathering.SchoolOfGeology), () => new global::Weathering.SchoolOfGeology() },
+            { typeof(global::Weathering.SchoolOfLogistics), () => new global::Weathering.SchoolOfLogistics() },
+            { typeof(global::Weathering.SchoolOfPhysics), () => new global::Weathering.SchoolOfPhysics() },
+            { typeof(global::Weathering.SchoolOfSpace), () => new global::Weathering.SchoolOfSpace() },
+            { typeof(global::Weathering.SeaFishery), () => new global::Weathering.SeaFishery() },
+            { typeof(global::Weathering.SeaWaterPump), () => new global::Weathering.SeaWaterPump() },
+            { typeof(global::Weathering.SpaceElevator), () => new global::Weathering.SpaceElevator() },
+            { typeof(global::Weathering.SpaceElevatorDest), () => new global::Weathering.SpaceElevatorDest() },
+            { typeof(global::Weathering.Torii), () => new global::Weathering.Torii() },
+            { typeof(global::Weathering.TotemOfAncestors), () => new global::Weathering.TotemOfAncestors() },
+            { typeof(global::Weathering.TotemOfNature), () => new global::Weathering.TotemOfNature() },
+            { typeof(global::Weathering.TransportStationAirport), () => new global::Weathering.TransportStationAirport() },
+            { typeof(global::Weathering.TransportStationDestAirport), () => new global::Weathering.TransportStationDestAirport() },
+            { typeof(global::Weathering.TransportStationDestPort), () => new global::Weathering.TransportStationDestPort() },
+            { typeof(global::Weathering.TransportStationDestSimpliest), () => new global::Weathering.TransportStationDestSimpliest() },
+            { typeof(global::Weathering.TransportStationPort), () => new global::Weathering.TransportStationPort() },
+            { typeof(global::Weathering.TransportStationSimpliest), () => new global::Weathering.TransportStationSimpliest() },
+            { typeof(global::Weathering.WallOfStoneBrick), () => new global::Weathering.WallOfStoneBrick() },
+            { typeof(global::Weathering.Wardenclyffe), () => new global::Weathering.Wardenclyffe() },
+            { typeof(global::Weathering.WareHouseOfBrick), () => new global::Weathering.WareHouseOfBrick() },
+            { typeof(global::Weathering.WareHouseOfConcrete), () => new global::Weathering.WareHouseOfConcrete() },
+            { typeof(global::Weathering.WareHouseOfGrass), () => new global::Weathering.WareHouseOfGrass() },
+            { typeof(global::Weathering.WareHouseOfStone), () => new global::Weathering.WareHouseOfStone() },
+            { typeof(global::Weathering.WareHouseOfWood), () => new global::Weathering.WareHouseOfWood() },
+            { typeof(global::Weathering.WorkshopOfBook), () => new global::Weathering.WorkshopOfBook() },
+            { typeof(global::Weathering.WorkshopOfBrickMaking), () => new global::Weathering.WorkshopOfBrickMaking() },
+            { typeof(global::Weathering.WorkshopOfBuildingPrefabrication), () => new global::Weathering.WorkshopOfBuildingPrefabrication() },
+            { typeof(global::Weathering.WorkshopOfConcrete), () => new global::Weathering.WorkshopOfConcrete() },
+            { typeof(global::Weathering.WorkshopOfCopperCasting), () => new global::Weathering.WorkshopOfCopperCasting() },
+            { typeof(global::Weathering.WorkshopOfCopperSmelting), () => new global::Weathering.WorkshopOfCopperSmelting() },
+            { typeof(global::Weathering.WorkshopOfIronCasting), () => new global::Weathering.WorkshopOfIronCasting() },
+            { typeof(global::Weathering.WorkshopOfIronSmelting), () => new global::Weathering.WorkshopOfIronSmelting() },
+            { typeof(global::Weathering.WorkshopOfMachinePrimitive), () => new global::Weathering.WorkshopOfMachinePrimitive() },
+            { typeof(global::Weathering.WorkshopOfMetalCasting), () => new global::Weathering.WorkshopOfMetalCasting() },
+            { typeof(global::Weathering.WorkshopOfMetalSmelting), () => new global::Weathering.WorkshopOfMetalSmelting() },
+            { typeof(global::Weathering.WorkshopOfPaperMaking), () => new global::Weathering.WorkshopOfPaperMaking() },
+            { typeof(global::Weathering.WorkshopOfSchoolEquipment), () => new global::Weathering.WorkshopOfSchoolEquipment() },
+            { typeof(global::Weathering.WorkshopOfSteelWorking), () => new global::Weathering.WorkshopOfSteelWorking() },
+            { typeof(global::Weathering.WorkshopOfStonecutting), () => new global::Weathering.WorkshopOfStonecutting() },
+            { typeof(global::Weathering.WorkshopOfToolPrimitive), () => new global::Weathering.WorkshopOfToolPrimitive() },
+            { typeof(global::Weathering.WorkshopOfWheelPrimitive), () => new global::Weathering.WorkshopOfWheelPrimitive() },
+            { typeof(global::Weathering.WorkshopOfWoodcutting), () => new global::Weathering.WorkshopOfWoodcutting() },
+        };
+    }
+}
@@ -0,0 +1,82 @@
+﻿
+using System;
+using System.Collections.Generic;
+using System.Reflection;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 启动时扫描一次程序集
+    /// 1. FullName => Type 的缓存, 代替逐个调用Type.GetType
+    /// 2. 每个可实例化的ITileDefinition类型有一个紧凑的整数id和构造委托。委托是TypeRegistry.Factories.cs里生成的 () => new T(), 不经过反射
+    ///
+    /// id按FullName排序分配, 只在本次运行中有效。存档里仍然使用每个文件自带的类型表, 否则新增地块类型会使旧存档失效
+    /// </summary>
+    public static partial class TypeRegistry
+    {
+        public const int NoTile = 0; // 0不对应任何地块类型
+
+        private static readonly Dictionary<string, Type> typesByName = new Dictionary<string, Type>();
+        private static readonly List<Type> tileTypes = new List<Type> { null };
+        private static readonly List<Func<ITileDefinition>> tileFactories = new List<Func<ITileDefinition>> { null };
+        private static readonly Dictionary<Type, int> tileIds = new Dictionary<Type, int>();
+
+        static TypeRegistry() {
+            Assembly assembly = Assembly.GetExecutingAssembly();
+            Type[] types = assembly.GetTypes();
+            Array.Sort(types, (a, b) => string.CompareOrdinal(a.FullName, b.FullName));
+
+            foreach (var type in types) {
+                typesByName[type.FullName] = type;
+
+                if (type.IsAbstract || type.IsInterface || type.ContainsGenericParameters) continue;
+                if (!typeof(ITileDefinition).IsAssignableFrom(type)) continue;
+                if (type.GetConstructor(Type.EmptyTypes) == null) continue;
+
+                tileIds.Add(type, tileTypes.Count);
+                tileTypes.Add(type);
+                tileFactories.Add(generatedTileFactories.TryGetValue(type, out Func<ITileDefinition> factory) ? factory : FallbackFactory(type));
+            }
+        }
+
+        // 生成的构造表过期时才会用到, 即编辑器里新增了地块类型但还没有重新生成。打包前会检查, 发布版本不会用到
+        private static Func<ITileDefinition> FallbackFactory(Type type) {
+#if UNITY_EDITOR
+            UnityEngine.Debug.LogWarning($"地块构造表过期, 需要重新生成 {type.FullName}");
+#endif
+            return () => (ITileDefinition)Activator.CreateInstance(type);
+        }
+
+        /// <summary>
+        /// 与Type.GetType一致, 找不到时返回null
+        /// </summary>
+        public static Type Find(string fullName) {
+            if (fullName == null) return null;
+            if (typesByName.TryGetValue(fullName, out Type type)) {
+                return type;
+            }
+            // 程序集以外的类型
+            type = Type.GetType(fullName);
+            if (type != null) {
+                typesByName.Add(fullName, type);
+            }
+            return type;
+        }
+
+        public static int TileCount => tileTypes.Count - 1;
+
+        public static int TileId(Type type) {
+            if (tileIds.TryGetValue(type, out int id)) {
+                return id;
+            }
+            throw new Exception($"不是可创建的地块类型 {type?.FullName}");
+        }
+        public static Type TileType(int id) => tileTypes[id];
+
+        public static Func<ITileDefinition> TileFactory(Type type) => tileFactories[TileId(type)];
+        public static Func<ITileDefinition> TileFactory(int id) => tileFactories[id];
+
+        public static ITileDefinition CreateTile(Type type) => tileFactories[TileId(type)]();
+        public static ITileDefinition CreateTile(int id) => tileFactories[id]();
+    }
+}
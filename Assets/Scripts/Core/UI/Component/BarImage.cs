@@ -6,7 +6,7 @@ using UnityEngine.UI;
 
 namespace Weathering
 {
-	public class BarImage : MonoBehaviour
+	public class BarImage : MonoBehaviour, IUIWidget
 	{
 		public Image RealImage;
 		public Button Button;
@@ -14,6 +14,32 @@ namespace Weathering
 		public void TapButton() {
 			OnButtonTapped?.Invoke();
         }
+
+		// 预制体的初始状态, 复用时恢复
+		private bool captured = false;
+		private Sprite defaultSprite;
+		private Color defaultColor;
+		private Vector2 defaultSize;
+		private Vector2 defaultImageSize;
+		private bool defaultButtonEnabled;
+		public void ResetState() {
+			RectTransform trans = transform as RectTransform;
+			if (!captured) {
+				captured = true;
+				defaultSprite = RealImage.sprite;
+				defaultColor = RealImage.color;
+				defaultSize = trans.sizeDelta;
+				defaultImageSize = RealImage.rectTransform.sizeDelta;
+				defaultButtonEnabled = Button.enabled;
+				return;
+			}
+			RealImage.sprite = defaultSprite;
+			RealImage.color = defaultColor;
+			trans.sizeDelta = defaultSize;
+			RealImage.rectTransform.sizeDelta = defaultImageSize;
+			Button.enabled = defaultButtonEnabled;
+			OnButtonTapped = null;
+		}
 	}
 }
 
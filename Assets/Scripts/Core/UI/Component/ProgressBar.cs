@@ -5,7 +5,7 @@ using UnityEngine;
 
 namespace Weathering
 {
-    public class ProgressBar : MonoBehaviour
+    public class ProgressBar : MonoBehaviour, IUIWidget
     {
         public UnityEngine.UI.Slider Slider;
 
@@ -59,6 +59,62 @@ namespace Weathering
             velocity = 0;
         }
         public float Dampping = 0.05f;
+
+        // 预制体的初始状态, 复用时恢复
+        private bool captured = false;
+        private Sprite defaultBackgroundSprite;
+        private Color defaultBackgroundColor;
+        private bool defaultBackgroundRaycast;
+        private Sprite defaultForegroundSprite;
+        private Color defaultForegroundColor;
+        private bool defaultForegroundActive;
+        private Vector2 defaultTextPosition;
+        private bool defaultIconEnabled;
+        private Sprite defaultIconSprite;
+        private bool defaultSliderEnabled;
+        private bool defaultSliderInteractable;
+        private bool defaultSliderRaycast;
+        private bool defaultButtonInteractable;
+        private float defaultDampping;
+        public void ResetState() {
+            RectTransform textTransform = Text.GetComponent<RectTransform>();
+            if (!captured) {
+                captured = true;
+                defaultBackgroundSprite = Background.sprite;
+                defaultBackgroundColor = Background.color;
+                defaultBackgroundRaycast = Background.raycastTarget;
+                defaultForegroundSprite = Foreground.sprite;
+                defaultForegroundColor = Foreground.color;
+                defaultForegroundActive = Foreground.gameObject.activeSelf;
+                defaultTextPosition = textTransform.anchoredPosition;
+                defaultIconEnabled = IconImage.enabled;
+                defaultIconSprite = IconImage.sprite;
+                defaultSliderEnabled = Slider.enabled;
+                defaultSliderInteractable = Slider.interactable;
+                defaultSliderRaycast = SliderRaycast.raycastTarget;
+                defaultButtonInteractable = Button.interactable;
+                defaultDampping = Dampping;
+                return;
+            }
+            Background.sprite = defaultBackgroundSprite;
+            Background.color = defaultBackgroundColor;
+            Background.raycastTarget = defaultBackgroundRaycast;
+            Foreground.sprite = defaultForegroundSprite;
+            Foreground.color = defaultForegroundColor;
+            Foreground.gameObject.SetActive(defaultForegroundActive);
+            Text.text = null;
+            textTransform.anchoredPosition = defaultTextPosition;
+            IconImage.enabled = defaultIconEnabled;
+            IconImage.sprite = defaultIconSprite;
+            Slider.enabled = defaultSliderEnabled;
+            Slider.interactable = defaultSliderInteractable;
+            SliderRaycast.raycastTarget = defaultSliderRaycast;
+            Button.interactable = defaultButtonInteractable;
+            Dampping = defaultDampping;
+            onTap = null;
+            SetTo(0);
+        }
+
         private void Update() {
             if (Slider.enabled && !Slider.interactable) {
                 Slider.value = Mathf.SmoothDamp(Slider.value, targetValue, ref velocity, Dampping);
@@ -5,9 +5,13 @@ using UnityEngine;
 
 namespace Weathering
 {
-	public class TextMultiLine : MonoBehaviour
+	public class TextMultiLine : MonoBehaviour, IUIWidget
 	{
 		public UnityEngine.UI.Text Content;
+
+		public void ResetState() {
+			Content.text = null;
+		}
 	}
 }
 
@@ -11,6 +11,10 @@ namespace Weathering
         bool Active { get; set; }
 
         List<IUIItem> GetItems();
+        /// <summary>
+        /// 与GetItems相同, 但ShowItems用完后回收列表, 之后不能再使用
+        /// </summary>
+        List<IUIItem> GetReusableItems();
         void ShowItems(string title, List<IUIItem> uiitems);
         void ShowItems(string title, params IUIItem[] uiitems);
         void Error(Exception e);
@@ -18,6 +22,14 @@ namespace Weathering
         void SetBackgroundTransparency(float a);
     }
 
+    /// <summary>
+    /// 可以放回对象池的UI组件。第一次调用时记录预制体的初始状态, 之后调用时恢复
+    /// </summary>
+    public interface IUIWidget
+    {
+        void ResetState();
+    }
+
 
     public class UI : MonoBehaviour, IUI {
         public static IUI Ins { get; private set; }
@@ -26,6 +38,11 @@ namespace Weathering
             Ins = this;
 
             rawImage.color = Color.white;
+
+            GameObject pool = new GameObject("Pool");
+            pool.SetActive(false);
+            poolRoot = pool.transform;
+            poolRoot.SetParent(transform, false);
         }
 
         public Sprite ColorSprite;
@@ -101,7 +118,16 @@ namespace Weathering
         }
 
 
-        private void DestroyChildren() {
+        // 每种预制体一个对象池。关闭或刷新页面时组件放回池中, 不再销毁
+        public const int MaxPooledPerPrefab = 64;
+        private Transform poolRoot;
+        private readonly Dictionary<GameObject, Stack<GameObject>> pools = new Dictionary<GameObject, Stack<GameObject>>();
+        private readonly Dictionary<GameObject, GameObject> prefabOf = new Dictionary<GameObject, GameObject>();
+        // 刷新页面时, 上一页的组件按顺序优先复用
+        private readonly Dictionary<GameObject, Queue<GameObject>> reusable = new Dictionary<GameObject, Queue<GameObject>>();
+        private int widgetCount = 0;
+
+        private void ClearBindings() {
             valueProgressBar.Clear();
             timeProgressBar.Clear();
             delProgressBar.Clear();
@@ -109,15 +135,57 @@ namespace Weathering
             dynamicButtons.Clear();
             dynamicButtonContents.Clear();
             dynamicSliderContents.Clear();
+        }
+
+        private void DestroyChildren() {
+            ClearBindings();
+            foreach (var queue in reusable.Values) {
+                queue.Clear();
+            }
             Transform trans = Content.transform;
-            int length = trans.childCount;
-            for (int i = 0; i < length; i++) {
-                Destroy(trans.GetChild(i).gameObject);
+            for (int i = trans.childCount - 1; i >= 0; i--) {
+                Release(trans.GetChild(i).gameObject);
+            }
+            widgetCount = 0;
+        }
+
+        private void Release(GameObject widget) {
+            if (!prefabOf.TryGetValue(widget, out GameObject prefab)) {
+                Destroy(widget);
+                return;
+            }
+            if (!pools.TryGetValue(prefab, out Stack<GameObject> pool)) {
+                pool = new Stack<GameObject>();
+                pools.Add(prefab, pool);
+            }
+            if (pool.Count >= MaxPooledPerPrefab) {
+                prefabOf.Remove(widget);
+                Destroy(widget);
+                return;
             }
+            widget.transform.SetParent(poolRoot, false);
+            pool.Push(widget);
+        }
+
+        private T Acquire<T>(GameObject prefab) where T : Component, IUIWidget {
+            GameObject widget;
+            if (reusable.TryGetValue(prefab, out Queue<GameObject> queue) && queue.Count > 0) {
+                widget = queue.Dequeue();
+            } else if (pools.TryGetValue(prefab, out Stack<GameObject> pool) && pool.Count > 0) {
+                widget = pool.Pop();
+                widget.transform.SetParent(Content.transform, false);
+            } else {
+                widget = Instantiate(prefab, Content.transform);
+                prefabOf.Add(widget, prefab);
+            }
+            widget.transform.SetSiblingIndex(widgetCount++);
+            T result = widget.GetComponent<T>();
+            result.ResetState();
+            return result;
         }
 
         private BarImage CreateTransparency(int scale) {
-            BarImage image = Instantiate(BarImage, Content.transform).GetComponent<BarImage>();
+            BarImage image = Acquire<BarImage>(BarImage);
             image.RealImage.sprite = null;
             image.RealImage.color = Color.clear;
 
@@ -152,7 +220,7 @@ namespace Weathering
             }
             if (sprite == null) return null;
 
-            BarImage image = Instantiate(BarImage, Content.transform).GetComponent<BarImage>();
+            BarImage image = Acquire<BarImage>(BarImage);
             image.RealImage.sprite = sprite;
 
             if (onTap != null) {
@@ -181,7 +249,7 @@ namespace Weathering
         }
 
         private TextMultiLine CreateText(string content) {
-            TextMultiLine result = Instantiate(Text, Content.transform).GetComponent<TextMultiLine>();
+            TextMultiLine result = Acquire<TextMultiLine>(Text);
             // result.GetComponent<UnityEngine.UI.ContentSizeFitter>().enabled = true;
             // SetText(text, content);
             result.Content.text = content;
@@ -205,8 +273,7 @@ namespace Weathering
 
         private ProgressBar CreateButton(IUIBackgroundType background, string label = null, string icon = null, Action onTap = null,
                 bool interactable=true, Func<bool> canTap = null, Func<string> dynamicContent = null) {
-            GameObject progressBarGameObject = Instantiate(ProgressBar, Content.transform);
-            ProgressBar result = progressBarGameObject.GetComponent<ProgressBar>();
+            ProgressBar result = Acquire<ProgressBar>(ProgressBar);
 
             if (label != null) result.Text.text = label;
             if (onTap != null) {
@@ -527,6 +594,14 @@ namespace Weathering
         public string InputFieldContent { get => InputFieldTextComponent.text; set => InputFieldTextComponent.text = value; }
         public List<IUIItem> GetItems() => new List<IUIItem>();
 
+        private readonly Stack<List<IUIItem>> itemListPool = new Stack<List<IUIItem>>();
+        private readonly HashSet<List<IUIItem>> lentItemLists = new HashSet<List<IUIItem>>();
+        public List<IUIItem> GetReusableItems() {
+            List<IUIItem> result = itemListPool.Count > 0 ? itemListPool.Pop() : new List<IUIItem>();
+            lentItemLists.Add(result);
+            return result;
+        }
+
         public void ShowItems(string title, List<IUIItem> IUIItems) {
             if (ShowInputFieldNextTime) {
                 InputFieldComponent.gameObject.SetActive(true);
@@ -537,8 +612,27 @@ namespace Weathering
                 InputFieldComponent.gameObject.SetActive(false);
             }
 
-            if (Active) Active = false;
-            Active = true;
+            if (active) {
+                // 刷新: 不关闭再打开, 已有的组件按类型和顺序原地复用
+                ClearBindings();
+                GameMenu.Entry.TrySaveGame();
+                foreach (var queue in reusable.Values) {
+                    queue.Clear(); // 上次显示出错时可能有残留
+                }
+                Transform trans = Content.transform;
+                for (int i = 0; i < trans.childCount; i++) {
+                    GameObject widget = trans.GetChild(i).gameObject;
+                    if (!prefabOf.TryGetValue(widget, out GameObject prefab)) continue;
+                    if (!reusable.TryGetValue(prefab, out Queue<GameObject> queue)) {
+                        queue = new Queue<GameObject>();
+                        reusable.Add(prefab, queue);
+                    }
+                    queue.Enqueue(widget);
+                }
+                widgetCount = 0;
+            } else {
+                Active = true;
+            }
             TitleText.text = title;
             foreach (IUIItem item in IUIItems) {
                 if (item == null) {
@@ -587,6 +681,16 @@ namespace Weathering
                         throw new Exception(item.Type.ToString());
                 }
             }
+            // 没有被复用的旧组件
+            foreach (var queue in reusable.Values) {
+                while (queue.Count > 0) {
+                    Release(queue.Dequeue());
+                }
+            }
+            if (lentItemLists.Remove(IUIItems)) {
+                IUIItems.Clear();
+                itemListPool.Push(IUIItems);
+            }
             LayoutRebuilder.ForceRebuildLayoutImmediate(Content.transform as RectTransform);
         }
 
@@ -0,0 +1,174 @@
+﻿
+using System;
+using System.Collections.Generic;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 可以被ValueScheduler监听的IValue。修改Max, Inc, Dec, Del, Val, Time时, 被监听的值通知调度器重新计算时刻
+    /// </summary>
+    internal interface IWatchableValue
+    {
+        bool Watched { get; set; }
+    }
+
+    /// <summary>
+    /// 数值达到Max时的事件。Value是惰性计算的, 到达Max的时刻由time, inc, dec, del算出, 见ValueState.MaxedTicks
+    /// 调度器按时刻排序, 每帧只处理到期的事件, 不用每帧检查所有地块
+    /// 回调只触发一次。数值被修改时自动重新计算时刻
+    /// </summary>
+    public static class ValueScheduler
+    {
+        public class Subscription
+        {
+            internal IValue Value;
+            internal object Owner;
+            internal Action Callback;
+            internal int Version;
+            internal bool Active;
+
+            public void Cancel() => ValueScheduler.Cancel(this);
+        }
+
+        private struct Entry
+        {
+            public long Ticks;
+            public long Sequence;
+            public int Version;
+            public Subscription Subscription;
+        }
+
+        // 最小堆, 订阅修改后旧的条目不删除, 出堆时按Version跳过
+        private static readonly List<Entry> heap = new List<Entry>();
+        private static long sequence = 0;
+        private static readonly Dictionary<IValue, List<Subscription>> watchers = new Dictionary<IValue, List<Subscription>>();
+
+        public static int Count { get; private set; } = 0;
+
+        /// <summary>
+        /// owner通常是地图, 地图卸载时用CancelAll(owner)取消
+        /// </summary>
+        public static Subscription WhenMaxed(IValue value, object owner, Action callback) {
+            if (value == null) throw new Exception();
+            if (callback == null) throw new Exception();
+            if (!(value is IWatchableValue watchable)) throw new Exception($"无法监听 {value.GetType().Name}");
+
+            Subscription subscription = new Subscription { Value = value, Owner = owner, Callback = callback, Active = true };
+            if (!watchers.TryGetValue(value, out List<Subscription> list)) {
+                list = new List<Subscription>();
+                watchers.Add(value, list);
+                watchable.Watched = true;
+            }
+            list.Add(subscription);
+            Count++;
+            Push(subscription);
+            return subscription;
+        }
+
+        public static void Cancel(Subscription subscription) {
+            if (subscription == null || !subscription.Active) return;
+            subscription.Active = false;
+            subscription.Version++;
+            Count--;
+            if (watchers.TryGetValue(subscription.Value, out List<Subscription> list)) {
+                list.Remove(subscription);
+                if (list.Count == 0) {
+                    watchers.Remove(subscription.Value);
+                    (subscription.Value as IWatchableValue).Watched = false;
+                }
+            }
+        }
+
+        public static void CancelAll(object owner) {
+            List<Subscription> cancelled = null;
+            foreach (var list in watchers.Values) {
+                foreach (var subscription in list) {
+                    if (subscription.Owner != owner) continue;
+                    if (cancelled == null) cancelled = new List<Subscription>();
+                    cancelled.Add(subscription);
+                }
+            }
+            if (cancelled == null) return;
+            foreach (var subscription in cancelled) {
+                Cancel(subscription);
+            }
+        }
+
+        /// <summary>
+        /// 被监听的值修改后调用
+        /// </summary>
+        internal static void Reschedule(IValue value) {
+            if (!watchers.TryGetValue(value, out List<Subscription> list)) return;
+            foreach (var subscription in list) {
+                subscription.Version++;
+                Push(subscription);
+            }
+        }
+
+        /// <summary>
+        /// 每帧调用, 触发所有不晚于now的事件
+        /// </summary>
+        public static void Update(long now) {
+            while (heap.Count > 0 && heap[0].Ticks <= now) {
+                Entry entry = Pop();
+                Subscription subscription = entry.Subscription;
+                if (!subscription.Active || subscription.Version != entry.Version) continue;
+                Cancel(subscription);
+                subscription.Callback();
+            }
+        }
+
+        private static void Push(Subscription subscription) {
+            if (heap.Count > 2 * Count + 64) Compact();
+            long ticks = Value.StateOf(subscription.Value).MaxedTicks;
+            if (ticks == long.MaxValue) return; // 永远不会满
+            heap.Add(new Entry { Ticks = ticks, Sequence = sequence++, Version = subscription.Version, Subscription = subscription });
+            int i = heap.Count - 1;
+            while (i > 0) {
+                int parent = (i - 1) / 2;
+                if (!Less(heap[i], heap[parent])) break;
+                Swap(i, parent);
+                i = parent;
+            }
+        }
+
+        private static Entry Pop() {
+            Entry result = heap[0];
+            int last = heap.Count - 1;
+            heap[0] = heap[last];
+            heap.RemoveAt(last);
+            int i = 0;
+            int count = heap.Count;
+            while (true) {
+                int left = i * 2 + 1;
+                if (left >= count) break;
+                int right = left + 1;
+                int min = right < count && Less(heap[right], heap[left]) ? right : left;
+                if (!Less(heap[min], heap[i])) break;
+                Swap(i, min);
+                i = min;
+            }
+            return result;
+        }
+
+        // 过时的条目太多时重建
+        private static void Compact() {
+            List<Entry> entries = new List<Entry>(heap);
+            heap.Clear();
+            foreach (var entry in entries) {
+                if (entry.Subscription.Active && entry.Subscription.Version == entry.Version) {
+                    heap.Add(entry);
+                }
+            }
+            heap.Sort((a, b) => Less(a, b) ? -1 : (Less(b, a) ? 1 : 0)); // 有序数组也是堆
+        }
+
+        // 同一时刻按订阅顺序触发
+        private static bool Less(Entry a, Entry b) => a.Ticks < b.Ticks || (a.Ticks == b.Ticks && a.Sequence < b.Sequence);
+        private static void Swap(int i, int j) {
+            Entry temp = heap[i];
+            heap[i] = heap[j];
+            heap[j] = temp;
+        }
+    }
+}
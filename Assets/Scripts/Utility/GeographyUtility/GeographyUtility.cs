@@ -60,6 +60,13 @@ namespace Weathering
     [Depend(typeof(Temporature))]
     public class TemporatureFreezing { }
 
+    /// <summary>
+    /// 地形噪声结果的紧凑编号, 生成和查询时不使用Type
+    /// </summary>
+    public enum AltitudeTypeId : byte { Sea, Plain, Mountain }
+    public enum MoistureTypeId : byte { Desert, Grassland, Forest }
+    public enum TemporatureTypeId : byte { Tropical, Temporate, Cold, Freezing }
+
 
 
 
@@ -266,6 +273,41 @@ namespace Weathering
         }
 
 
+        public static AltitudeTypeId GetAltitudeTypeId(int altitude) {
+            if (altitude > 3000) {
+                return AltitudeTypeId.Mountain;
+            } else
+            if (altitude > 0) {
+                return AltitudeTypeId.Plain;
+            } else {
+                return AltitudeTypeId.Sea;
+            }
+        }
+        public static MoistureTypeId GetMoistureTypeId(int moisture) {
+            if (moisture > 55) {
+                return MoistureTypeId.Forest;
+            } else if (moisture > 35) {
+                return MoistureTypeId.Grassland;
+            } else {
+                return MoistureTypeId.Desert;
+            }
+        }
+        // 与GetTemporatureType一致, 目前只有温带和寒带
+        public static TemporatureTypeId GetTemporatureTypeId(int temporature) {
+            if (temporature > 0) {
+                return TemporatureTypeId.Temporate;
+            } else {
+                return TemporatureTypeId.Cold;
+            }
+        }
+
+        private static readonly Type[] altitudeTypes = { typeof(AltitudeSea), typeof(AltitudePlain), typeof(AltitudeMountain) };
+        private static readonly Type[] moistureTypes = { typeof(MoistureDesert), typeof(MoistureGrassland), typeof(MoistureForest) };
+        private static readonly Type[] temporatureTypes = { typeof(TemporatureTropical), typeof(TemporatureTemporate), typeof(TemporatureCold), typeof(TemporatureFreezing) };
+        public static Type TypeOf(AltitudeTypeId id) => altitudeTypes[(int)id];
+        public static Type TypeOf(MoistureTypeId id) => moistureTypes[(int)id];
+        public static Type TypeOf(TemporatureTypeId id) => temporatureTypes[(int)id];
+
         public static Type GetAltitudeType(int altitude) {
             if (altitude > 3000) {
                 return typeof(AltitudeMountain);
@@ -0,0 +1,78 @@
+﻿
+using System;
+
+namespace Weathering
+{
+    /// <summary>
+    /// 一层地块的8邻域连通掩码, 每格一个字节。地图首尾相接
+    /// 某格是否属于这一层改变时, 只更新周围8格的掩码, 渲染时用TileUtility查表得到贴图序号
+    /// </summary>
+    public class NeighborMaskPlane
+    {
+        public const byte Left = 1 << 0;
+        public const byte Right = 1 << 1;
+        public const byte Up = 1 << 2;
+        public const byte Down = 1 << 3;
+        public const byte UpLeft = 1 << 4;
+        public const byte UpRight = 1 << 5;
+        public const byte DownLeft = 1 << 6;
+        public const byte DownRight = 1 << 7;
+
+        // 邻居相对自己的偏移, 以及自己在邻居掩码里对应的位
+        private static readonly int[] di = { -1, 1, 0, 0, -1, 1, -1, 1 };
+        private static readonly int[] dj = { 0, 0, 1, -1, 1, 1, -1, -1 };
+        private static readonly byte[] bitInNeighbor = { Right, Left, Down, Up, DownRight, DownLeft, UpRight, UpLeft };
+
+        public readonly int Width;
+        public readonly int Height;
+        private readonly bool[] members;
+        private readonly byte[] masks;
+
+        public NeighborMaskPlane(int width, int height, Func<int, int, bool> isMember) {
+            if (width <= 0 || height <= 0) throw new Exception();
+            Width = width;
+            Height = height;
+            members = new bool[width * height];
+            masks = new byte[width * height];
+            for (int j = 0; j < height; j++) {
+                for (int i = 0; i < width; i++) {
+                    members[i + j * width] = isMember(i, j);
+                }
+            }
+            for (int j = 0; j < height; j++) {
+                for (int i = 0; i < width; i++) {
+                    byte mask = 0;
+                    for (int k = 0; k < 8; k++) {
+                        if (members[Index(i + di[k], j + dj[k])]) mask |= (byte)(1 << k);
+                    }
+                    masks[i + j * width] = mask;
+                }
+            }
+        }
+
+        public bool Has(int i, int j) => members[Index(i, j)];
+        public byte Mask(int i, int j) => masks[Index(i, j)];
+
+        public void Set(int i, int j, bool isMember) {
+            int index = Index(i, j);
+            if (members[index] == isMember) return;
+            members[index] = isMember;
+            for (int k = 0; k < 8; k++) {
+                int neighbor = Index(i + di[k], j + dj[k]);
+                if (isMember) {
+                    masks[neighbor] |= bitInNeighbor[k];
+                } else {
+                    masks[neighbor] &= (byte)~bitInNeighbor[k];
+                }
+            }
+        }
+
+        private int Index(int i, int j) {
+            i %= Width;
+            if (i < 0) i += Width;
+            j %= Height;
+            if (j < 0) j += Height;
+            return i + j * Width;
+        }
+    }
+}
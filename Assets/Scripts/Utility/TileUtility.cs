@@ -92,6 +92,33 @@ namespace Weathering
             return index;
         }
 
+        // 以NeighborMaskPlane的掩码为下标的查找表
+        private static readonly int[] ruleTile4x4Table = CreateRuleTile4x4Table();
+        private static readonly int[] ruleTile6x8Table = CreateRuleTile6x8Table();
+        private static int[] CreateRuleTile4x4Table() {
+            int[] table = new int[16];
+            for (int mask = 0; mask < table.Length; mask++) {
+                table[mask] = Calculate4x4RuleTileIndex((mask & NeighborMaskPlane.Left) != 0, (mask & NeighborMaskPlane.Right) != 0,
+                    (mask & NeighborMaskPlane.Up) != 0, (mask & NeighborMaskPlane.Down) != 0);
+            }
+            return table;
+        }
+        private static int[] CreateRuleTile6x8Table() {
+            int[] table = new int[256];
+            for (int mask = 0; mask < table.Length; mask++) {
+                table[mask] = Calculate6x8RuleTileIndex((mask & NeighborMaskPlane.Left) != 0, (mask & NeighborMaskPlane.Right) != 0,
+                    (mask & NeighborMaskPlane.Up) != 0, (mask & NeighborMaskPlane.Down) != 0,
+                    (mask & NeighborMaskPlane.UpLeft) != 0, (mask & NeighborMaskPlane.UpRight) != 0,
+                    (mask & NeighborMaskPlane.DownLeft) != 0, (mask & NeighborMaskPlane.DownRight) != 0);
+            }
+            return table;
+        }
+        /// <summary>
+        /// 只用掩码的上下左右4位
+        /// </summary>
+        public static int Calculate4x4RuleTileIndex(byte mask) => ruleTile4x4Table[mask & 0x0f];
+        public static int Calculate6x8RuleTileIndex(byte mask) => ruleTile6x8Table[mask];
+
         private static int Calculate4x4RuleTileIndex(bool left, bool right, bool up, bool down) {
             if (left) {
                 if (right) {
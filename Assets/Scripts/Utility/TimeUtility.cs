@@ -29,7 +29,17 @@ namespace Weathering
         //    // will be replaced by in-game ticks
         //    return lastTicks;
         //}
-        public static long GetTicks() => GameEntry.FrameBuffer(ref lastTicks, ref lastFrame, () => DateTime.Now.Ticks);
+        /// <summary>
+        /// 同一帧内返回同一个值
+        /// </summary>
+        public static long GetTicks() {
+            long thisFrame = GameEntry.Ins.FrameCount;
+            if (thisFrame != lastFrame) {
+                lastFrame = thisFrame;
+                lastTicks = DateTime.Now.Ticks;
+            }
+            return lastTicks;
+        }
 
         public static long GetMiniSeconds() {
             return GetTicks() / Value.MiniSecond;
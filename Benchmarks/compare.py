@@ -0,0 +1,127 @@
+"""
+比较 Unity Performance Testing 的结果与基线。
+
+用法：
+    python3 Benchmarks/compare.py results.json              # 与 Benchmarks/baseline.json 比较
+    python3 Benchmarks/compare.py results.json --update     # 用本次结果覆盖基线
+中位数变差超过阈值（默认 15%）的项目算回退，此时退出码为 1。
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+from typing import Dict, List, Optional
+
+
+BASELINE_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "baseline.json")
+DEFAULT_THRESHOLD = 0.15
+
+# 这些样本组记录的是数量而不是耗时，只列出变化，不判断回退
+COUNT_GROUPS = {"SerializedBytes", "InventoryTypes", "LinkNodes"}
+
+Summary = Dict[str, Dict[str, Dict[str, object]]]
+
+
+def _median(group: Dict[str, object]) -> Optional[float]:
+    samples = group.get("Samples") or []
+    if samples:
+        return float(statistics.median(samples))
+    median = group.get("Median")
+    return None if median is None else float(median)
+
+
+def load_results(path: str) -> Summary:
+    """读取 PerformanceTestResults.json，整理为 {测试名: {样本组: {median, unit, increase_is_better}}}"""
+    with open(path, "r", encoding="utf-8-sig") as f:
+        raw = json.load(f)
+    summary: Summary = {}
+    for result in raw.get("Results", []):
+        groups: Dict[str, Dict[str, object]] = {}
+        for group in result.get("SampleGroups", []):
+            median = _median(group)
+            if median is None:
+                continue
+            groups[group["Name"]] = {
+                "median": median,
+                "unit": group.get("Unit"),
+                "increase_is_better": bool(group.get("IncreaseIsBetter", False)),
+            }
+        if groups:
+            summary[result["Name"]] = groups
+    return summary
+
+
+def current_commit() -> str:
+    try:
+        return subprocess.check_output(["git", "rev-parse", "--short", "HEAD"], text=True).strip()
+    except Exception:
+        return ""
+
+
+def compare(baseline: Summary, current: Summary, threshold: float) -> List[str]:
+    """打印对比表，返回回退的项目"""
+    regressions: List[str] = []
+    print(f"{'测试 / 样本组':<72} {'基线':>12} {'本次':>12} {'变化':>8}")
+    for test in sorted(current):
+        for name, group in sorted(current[test].items()):
+            label = f"{test.rsplit('.', 1)[-1]} / {name}"
+            value = float(group["median"])
+            base = baseline.get(test, {}).get(name)
+            if base is None:
+                print(f"{label:<72} {'-':>12} {value:>12.4f} {'新增':>8}")
+                continue
+            base_value = float(base["median"])
+            change = 0.0 if base_value == 0 else (value - base_value) / base_value
+            worse = -change if group["increase_is_better"] else change
+            mark = ""
+            if name not in COUNT_GROUPS and not name.endswith(".GC()") and worse > threshold:
+                mark = " 回退"
+                regressions.append(label)
+            elif name not in COUNT_GROUPS and worse < -threshold:
+                mark = " 改进"
+            print(f"{label:<72} {base_value:>12.4f} {value:>12.4f} {change:>+8.1%}{mark}")
+    return regressions
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="比较性能测试结果与基线")
+    parser.add_argument("results", help="Unity 导出的 PerformanceTestResults.json")
+    parser.add_argument("--baseline", default=BASELINE_PATH)
+    parser.add_argument("--threshold", type=float, default=DEFAULT_THRESHOLD)
+    parser.add_argument("--update", action="store_true", help="用本次结果覆盖基线")
+    args = parser.parse_args()
+
+    current = load_results(args.results)
+    if not current:
+        print(f"{args.results} 中没有性能测试结果")
+        return 1
+
+    if args.update:
+        with open(args.baseline, "w", encoding="utf-8") as f:
+            json.dump({"commit": current_commit(), "results": current}, f, ensure_ascii=False, indent=2, sort_keys=True)
+            f.write("\n")
+        print(f"基线已更新：{args.baseline}（{len(current)} 个测试）")
+        return 0
+
+    if not os.path.exists(args.baseline):
+        print(f"没有基线 {args.baseline}，先用 --update 生成")
+        return 1
+    with open(args.baseline, "r", encoding="utf-8") as f:
+        baseline_data = json.load(f)
+    print(f"基线提交：{baseline_data.get('commit') or '未知'}，本次提交：{current_commit() or '未知'}")
+    regressions = compare(baseline_data.get("results", {}), current, args.threshold)
+    if regressions:
+        print(f"\n{len(regressions)} 项回退超过 {args.threshold:.0%}：")
+        for label in regressions:
+            print(f"  {label}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,17 @@
+#!/usr/bin/env bash
+# 无界面运行性能测试并与基线比较
+# 用法：UNITY=/path/to/Unity Benchmarks/run.sh [--update]
+set -euo pipefail
+
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+UNITY="${UNITY:-Unity}"
+OUT="$ROOT/Benchmarks/out"
+mkdir -p "$OUT"
+
+"$UNITY" -batchmode -projectPath "$ROOT" \
+    -runTests -testPlatform editmode -testCategory Benchmark \
+    -testResults "$OUT/TestResults.xml" \
+    -perfTestResults "$OUT/PerformanceTestResults.json" \
+    -logFile "$OUT/unity.log"
+
+python3 "$ROOT/Benchmarks/compare.py" "$OUT/PerformanceTestResults.json" "$@"
@@ -0,0 +1,52 @@
+package com.weathering.generation.bench;
+
+import com.weathering.generation.CelestialGeneration;
+import com.weathering.generation.Hashing;
+import java.util.concurrent.TimeUnit;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Threads;
+import org.openjdk.jmh.annotations.Warmup;
+import org.openjdk.jmh.infra.Blackhole;
+
+/**
+ * Star systems per second for a single benchmark thread: one operation classifies all 32x32 tiles of a system,
+ * which is what a survey does before picking planet candidates.
+ */
+@BenchmarkMode(Mode.Throughput)
+@OutputTimeUnit(TimeUnit.SECONDS)
+@Warmup(iterations = 3, time = 2)
+@Measurement(iterations = 5, time = 2)
+@Fork(1)
+@Threads(1)
+@State(Scope.Thread)
+public class CelestialGenerationBenchmark {
+    private static final int SIZE = 32;
+
+    private long starSystemHash;
+    private long starTypeHash;
+
+    @Setup
+    public void setup() {
+        starSystemHash = Hashing.hashString("Weathering.MapOfStarSystem#=1,4=14,93");
+        starTypeHash = Hashing.hashString("#=1,4=14,93");
+    }
+
+    @Benchmark
+    public void classifyStarSystem(Blackhole blackhole) {
+        var stars = CelestialGeneration.computeStarPositions(starSystemHash);
+        for (int y = 0; y < SIZE; y++) {
+            for (int x = 0; x < SIZE; x++) {
+                long tileHash = Hashing.hash(x, y, SIZE, SIZE, (int) starSystemHash);
+                blackhole.consume(CelestialGeneration.classifyBody(tileHash, starTypeHash, x, y, stars));
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+package com.weathering.generation.bench;
+
+import com.weathering.generation.Hashing;
+import java.util.concurrent.TimeUnit;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Threads;
+import org.openjdk.jmh.annotations.Warmup;
+import org.openjdk.jmh.infra.Blackhole;
+
+/**
+ * Scalar vs batch tile hashing and noise for one 32x32 star system / one 150-wide planet row.
+ */
+@BenchmarkMode(Mode.Throughput)
+@OutputTimeUnit(TimeUnit.SECONDS)
+@Warmup(iterations = 3, time = 2)
+@Measurement(iterations = 5, time = 2)
+@Fork(1)
+@Threads(1)
+@State(Scope.Thread)
+public class HashingBenchmark {
+    private static final int SIZE = 32;
+    private static final int ROW = 150;
+    private final int[] hashes = new int[SIZE * SIZE];
+    private final float[] noise = new float[ROW];
+
+    @Benchmark
+    public void hashTilesScalar(Blackhole blackhole) {
+        for (int y = 0; y < SIZE; y++) {
+            for (int x = 0; x < SIZE; x++) {
+                blackhole.consume(Hashing.hash(x, y, SIZE, SIZE, 123456789));
+            }
+        }
+    }
+
+    @Benchmark
+    public int[] hashTilesBatch() {
+        Hashing.hashRow(0, 0, SIZE, SIZE, 123456789, hashes, 0, hashes.length);
+        return hashes;
+    }
+
+    @Benchmark
+    public void perlinNoiseScalar(Blackhole blackhole) {
+        for (int i = 0; i < ROW; i++) {
+            blackhole.consume(Hashing.perlinNoise((float) 10 * i / ROW, (float) 10 * 37 / ROW, 10, 10, 5));
+        }
+    }
+
+    @Benchmark
+    public float[] perlinNoiseRow() {
+        Hashing.perlinNoiseRow(10, 37, ROW, ROW, 5, noise, 0);
+        return noise;
+    }
+}
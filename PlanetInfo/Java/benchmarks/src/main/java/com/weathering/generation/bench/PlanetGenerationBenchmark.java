@@ -0,0 +1,68 @@
+package com.weathering.generation.bench;
+
+import com.weathering.generation.Hashing;
+import com.weathering.generation.PlanetGeneration;
+import java.util.concurrent.TimeUnit;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Threads;
+import org.openjdk.jmh.annotations.Warmup;
+
+/**
+ * Planets per second for a single benchmark thread, i.e. per core.
+ * {@link #generateFlatParallel} is the exception: it spreads one planet over the common ForkJoin pool,
+ * so its score is planets per second for the whole machine.
+ */
+@BenchmarkMode(Mode.Throughput)
+@OutputTimeUnit(TimeUnit.SECONDS)
+@Warmup(iterations = 3, time = 2)
+@Measurement(iterations = 5, time = 2)
+@Fork(1)
+@Threads(1)
+@State(Scope.Thread)
+public class PlanetGenerationBenchmark {
+    // planet sizes differ per key (50..149), so keep a small and a large one next to the starting planet
+    @Param({
+        "Weathering.MapOfPlanet#=1,4=14,93=24,31",
+        "Weathering.MapOfPlanet#=2,7=31,5=3,18",
+        "Weathering.MapOfPlanet#=9,9=60,12=27,4",
+    })
+    public String mapKey;
+
+    private long mapHash;
+    private long selfMapHash;
+
+    @Setup
+    public void setup() {
+        mapHash = Hashing.hashString(mapKey);
+        selfMapHash = Hashing.hashString(mapKey.substring(mapKey.indexOf('#')));
+    }
+
+    @Benchmark
+    public PlanetGeneration.PlanetMap generate() {
+        return PlanetGeneration.generate(mapHash, selfMapHash, 5);
+    }
+
+    @Benchmark
+    public PlanetGeneration.FlatPlanetMap generateFlat() {
+        return PlanetGeneration.generateFlat(mapHash, selfMapHash, 5, false);
+    }
+
+    @Benchmark
+    public PlanetGeneration.FlatPlanetMap generateFlatParallel() {
+        return PlanetGeneration.generateFlat(mapHash, selfMapHash, 5, true);
+    }
+
+    @Benchmark
+    public PlanetGeneration.PlanetProfile profile() {
+        return PlanetGeneration.profile(mapHash, selfMapHash);
+    }
+}
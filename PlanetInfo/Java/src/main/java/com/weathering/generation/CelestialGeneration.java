@@ -34,7 +34,7 @@ public final class CelestialGeneration {
     public static StarPositions computeStarPositions(long mapHashCode) {
         final int width = 32;
         final int height = 32;
-        int starPos = abs((int) (mapHashCode % (height * height)));
+        int starPos = abs((int) mapHashCode % (height * height)); // same as C#: cast to int first, then %
         int x = starPos % width;
         int y = starPos / height;
 
@@ -27,6 +27,43 @@ public final class Hashing {
         return hash32(seed);
     }
 
+    /**
+     * Batch {@link #hash(int, int, int, int, int)} for {@code i0 + k, j}, {@code k < count}.
+     * Results are the raw 32 bits; read them with {@link Integer#toUnsignedLong(int)}.
+     */
+    public static void hashRow(int i0, int j, int width, int height, int offset, int[] out, int outOffset, int count) {
+        hashSequence(offset * width + height + i0 + j * width, 1, out, outOffset, count);
+    }
+
+    /** Batch {@link #hash(int, int, int, int, int)} for {@code i, j0 + k}, {@code k < count}; raw 32 bits like {@link #hashRow}. */
+    public static void hashColumn(int i, int j0, int width, int height, int offset, int[] out, int outOffset, int count) {
+        hashSequence(offset * width + height + i + j0 * width, width, out, outOffset, count);
+    }
+
+    // Plain int loops: C2 auto-vectorizes them (the Vector API is still an incubator module and would need
+    // --add-modules on every javac/java call). int arithmetic wraps exactly like the uint math in C#.
+    private static void hashSequence(int start, int step, int[] out, int outOffset, int count) {
+        for (int k = 0; k < count; k++) {
+            out[outOffset + k] = hash32Bits(start + k * step);
+        }
+    }
+
+    /** Applies {@link #hash32(long)} to each value in place, i.e. one {@link #hashed(UIntRef)} step per value. */
+    public static void hashInPlace(int[] values, int offset, int count) {
+        for (int k = 0; k < count; k++) {
+            values[offset + k] = hash32Bits(values[offset + k]);
+        }
+    }
+
+    private static int hash32Bits(int a) {
+        a = (a ^ 61) ^ (a >>> 16);
+        a = a + (a << 3);
+        a = a ^ (a >>> 4);
+        a = a * 0x27d4eb2d;
+        a = a ^ (a >>> 15);
+        return a;
+    }
+
     public static long addSalt(long a, long salt) {
         return hash32((a + salt) & 0xFFFFFFFFL);
     }
@@ -89,6 +126,45 @@ public final class Hashing {
         return n1 * (1.0f - d1) + n0 * d1;
     }
 
+    /**
+     * One row of noise: {@code out[outOffset + i] == perlinNoise((float) size * i / width, (float) size * j / height, size, size, layer)}
+     * for {@code i < width}. The y terms are computed once per row and the four gradients once per lattice cell.
+     */
+    public static void perlinNoiseRow(int size, int j, int width, int height, int layer, float[] out, int outOffset) {
+        float y = (float) size * j / height;
+        int p0y = (int) y;
+        int p1y = p0y + 1;
+        float v0y = y - p0y;
+        float v1y = y - p1y;
+        float d1 = fade(y - p0y);
+
+        int p0x = 0;
+        Vec2 g0 = null, g1 = null, g2 = null, g3 = null;
+        for (int i = 0; i < width; i++) {
+            float x = (float) size * i / width;
+            int cellX = (int) x;
+            if (i == 0 || cellX != p0x) {
+                p0x = cellX;
+                g0 = randomVec2Simple(p0x, p0y, size, size, layer);
+                g1 = randomVec2Simple(p0x, p1y, size, size, layer);
+                g2 = randomVec2Simple(p0x + 1, p1y, size, size, layer);
+                g3 = randomVec2Simple(p0x + 1, p0y, size, size, layer);
+            }
+            float v0x = x - p0x;
+            float v2x = x - (p0x + 1);
+
+            float product0 = g0.x * v0x + g0.y * v0y;
+            float product1 = g1.x * v0x + g1.y * v1y;
+            float product2 = g2.x * v2x + g2.y * v1y;
+            float product3 = g3.x * v2x + g3.y * v0y;
+
+            float d0 = fade(x - p0x);
+            float n0 = product1 * (1.0f - d0) + product2 * d0;
+            float n1 = product0 * (1.0f - d0) + product3 * d0;
+            out[outOffset + i] = n1 * (1.0f - d1) + n0 * d1;
+        }
+    }
+
     private static float fade(float t) {
         return t * t * t * (t * (t * 6 - 15) + 10);
     }
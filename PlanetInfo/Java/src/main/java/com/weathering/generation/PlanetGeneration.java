@@ -1,5 +1,7 @@
 package com.weathering.generation;
 
+import java.util.stream.IntStream;
+
 public final class PlanetGeneration {
     private PlanetGeneration() {}
 
@@ -17,6 +19,51 @@ public final class PlanetGeneration {
                             TerrainType[][] terrainTypes,
                             OreType[][] oreTypes) {}
 
+    /** No ore on this cell in {@link FlatPlanetMap#oreTypes()}. */
+    public static final byte NO_ORE = -1;
+
+    private static final AltitudeType[] ALTITUDE_TYPES = AltitudeType.values();
+    private static final MoistureType[] MOISTURE_TYPES = MoistureType.values();
+    private static final TemperatureType[] TEMPERATURE_TYPES = TemperatureType.values();
+    private static final TerrainType[] TERRAIN_TYPES = TerrainType.values();
+    private static final OreType[] ORE_TYPES = OreType.values();
+
+    /**
+     * Same content as {@link PlanetMap}, stored as flat arrays indexed by {@code i + j * width}.
+     * Enum planes hold ordinals; {@link #oreTypes()} holds {@link #NO_ORE} where there is no ore.
+     */
+    public record FlatPlanetMap(int width, int height, int[] altitudes, byte[] altitudeTypes,
+                                int[] moistures, byte[] moistureTypes,
+                                int[] temperatures, byte[] temperatureTypes,
+                                byte[] terrainTypes,
+                                byte[] oreTypes) {
+        public int index(int i, int j) {
+            return i + j * width;
+        }
+
+        public AltitudeType altitudeTypeAt(int i, int j) {
+            return ALTITUDE_TYPES[altitudeTypes[index(i, j)]];
+        }
+
+        public MoistureType moistureTypeAt(int i, int j) {
+            return MOISTURE_TYPES[moistureTypes[index(i, j)]];
+        }
+
+        public TemperatureType temperatureTypeAt(int i, int j) {
+            return TEMPERATURE_TYPES[temperatureTypes[index(i, j)]];
+        }
+
+        public TerrainType terrainTypeAt(int i, int j) {
+            return TERRAIN_TYPES[terrainTypes[index(i, j)]];
+        }
+
+        /** Returns null where there is no ore, like {@link PlanetMap#oreTypes()}. */
+        public OreType oreTypeAt(int i, int j) {
+            byte ore = oreTypes[index(i, j)];
+            return ore == NO_ORE ? null : ORE_TYPES[ore];
+        }
+    }
+
     public static int calculatePlanetSize(long selfMapHashCode) {
         return 50 + (int) (selfMapHashCode % 100);
     }
@@ -104,6 +151,104 @@ public final class PlanetGeneration {
         return new PlanetMap(width, height, altitudes, altitudeTypes, moistures, moistureTypes, temperatures, temperatureTypes, terrainTypes, oreTypes);
     }
 
+    public static FlatPlanetMap generateFlat(long mapHashCode, long selfMapHashCode, int randomSeed) {
+        return generateFlat(mapHashCode, selfMapHashCode, randomSeed, true);
+    }
+
+    /**
+     * Flat-array variant of {@link #generate}. Every cell only depends on its own coordinates, so the three
+     * passes are fused into one, noise is computed a row at a time with {@link Hashing#perlinNoiseRow}, and rows
+     * are filled independently (in parallel on the common ForkJoin pool
+     * when {@code parallel} is set). The per-cell arithmetic is the same as {@link #generate}, so the result
+     * is bit-exact with it.
+     * Pass {@code parallel = false} when the caller already spreads planets across threads.
+     */
+    public static FlatPlanetMap generateFlat(long mapHashCode, long selfMapHashCode, int randomSeed, boolean parallel) {
+        PlanetProfile p = profile(mapHashCode, selfMapHashCode);
+        int width = p.size;
+        int height = p.size;
+        int cells = width * height;
+
+        int[] altitudes = new int[cells];
+        byte[] altitudeTypes = new byte[cells];
+        int[] moistures = new int[cells];
+        byte[] moistureTypes = new byte[cells];
+        int[] temperatures = new int[cells];
+        byte[] temperatureTypes = new byte[cells];
+        byte[] terrainTypes = new byte[cells];
+        byte[] oreTypes = new byte[cells];
+        FlatPlanetMap map = new FlatPlanetMap(width, height, altitudes, altitudeTypes, moistures, moistureTypes,
+            temperatures, temperatureTypes, terrainTypes, oreTypes);
+
+        // same seed layout as generate: altitude takes three layers, then moisture, then temperature
+        int layer0 = randomSeed + (int) mapHashCode;
+        IntStream rows = IntStream.range(0, height);
+        if (parallel) {
+            rows = rows.parallel();
+        }
+        rows.forEach(j -> fillRow(map, p, mapHashCode, layer0, j));
+        return map;
+    }
+
+    private static void fillRow(FlatPlanetMap map, PlanetProfile p, long mapHashCode, int layer0, int j) {
+        int width = map.width;
+        int height = map.height;
+        int noise0 = p.baseAltitudeNoiseSize;
+        int noise1 = noise0 * 2;
+        int noise2 = noise1 * 2;
+        int mSize = p.baseMoistureNoiseSize;
+        int tSize = 4;
+        float latitude = (float) Math.sin(Math.PI * j / width);
+
+        float[] noise0Row = new float[width];
+        float[] noise1Row = new float[width];
+        float[] noise2Row = new float[width];
+        float[] moistureRow = new float[width];
+        float[] temperatureRow = new float[width];
+        Hashing.perlinNoiseRow(noise0, j, width, height, layer0, noise0Row, 0);
+        Hashing.perlinNoiseRow(noise1, j, width, height, layer0 + 1, noise1Row, 0);
+        Hashing.perlinNoiseRow(noise2, j, width, height, layer0 + 2, noise2Row, 0);
+        Hashing.perlinNoiseRow(mSize, j, width, height, layer0 + 3, moistureRow, 0);
+        Hashing.perlinNoiseRow(tSize, j, width, height, layer0 + 4, temperatureRow, 0);
+
+        int row = j * width;
+        for (int i = 0; i < width; i++) {
+            int index = row + i;
+
+            float n0 = noise0Row[i];
+            float n1 = noise1Row[i];
+            float n2 = noise2Row[i];
+            int altitude = lerpInt(-10000, 9500, (n0 * 4 + n1 * 2 + n2 + 7) / 14f);
+            AltitudeType altitudeType = getAltitudeType(altitude);
+
+            float m = moistureRow[i];
+            int moisture = lerpInt(0, 100, (m + 1) / 2f);
+            MoistureType moistureType = getMoistureType(moisture);
+
+            float n = temperatureRow[i];
+            n = (n + 1) / 2f;
+            float f = lerp(n, latitude, 0f);
+            if (altitude > 0) {
+                float t = 0.02f * altitude / 9500f;
+                f = lerp(f, -20f, t);
+            }
+            int temperature = -20 + (int) (f * (40 - (-20)));
+            TemperatureType temperatureType = getTemperatureType(temperature);
+
+            TerrainType terrain = deriveTerrain(altitudeType, moistureType, temperatureType);
+            OreType ore = generateOreType(mapHashCode, p.mineralDensity(), i, j, terrain, width, height);
+
+            map.altitudes[index] = altitude;
+            map.altitudeTypes[index] = (byte) altitudeType.ordinal();
+            map.moistures[index] = moisture;
+            map.moistureTypes[index] = (byte) moistureType.ordinal();
+            map.temperatures[index] = temperature;
+            map.temperatureTypes[index] = (byte) temperatureType.ordinal();
+            map.terrainTypes[index] = (byte) terrain.ordinal();
+            map.oreTypes[index] = ore == null ? NO_ORE : (byte) ore.ordinal();
+        }
+    }
+
     static OreType generateOreType(long mapHashCode, int mineralDensity, int x, int y, TerrainType terrain, int width, int height) {
         if (terrain != TerrainType.TerrainType_Mountain) {
             return null;
@@ -0,0 +1,88 @@
+package com.weathering.generation;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.channels.FileChannel;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.StandardCopyOption;
+import java.nio.file.StandardOpenOption;
+
+/**
+ * Writes a {@link UniverseScanner.ScanResult} as the universe index read by {@code UniverseIndex} in planet_info.py.
+ * Little-endian, fixed-width records:
+ * <ul>
+ *   <li>header: magic {@code WUIX}, version, galaxy / system / planet counts (u32)</li>
+ *   <li>galaxies (count + 1): x u8, y u8, pad u16, first system u32; the last entry is a sentinel</li>
+ *   <li>systems (count + 1): x u8, y u8, star type u8, pad u8, first planet u32; the last entry is a sentinel</li>
+ *   <li>planets: x u8, y u8, body type u8, mineral density u8, size u16, seconds per day u16, days per month u8, pad u8</li>
+ * </ul>
+ * Keep in sync with {@code UniverseIndex} / {@code INDEX_VERSION} in planet_info.py.
+ */
+public final class UniverseIndexWriter {
+    private UniverseIndexWriter() {}
+
+    public static final int VERSION = 1;
+    private static final byte[] MAGIC = "WUIX".getBytes(StandardCharsets.US_ASCII);
+    private static final int HEADER_SIZE = 20;
+    private static final int GALAXY_SIZE = 8;
+    private static final int SYSTEM_SIZE = 8;
+    private static final int PLANET_SIZE = 10;
+
+    public static void write(UniverseScanner.ScanResult r, Path path) throws IOException {
+        long size = HEADER_SIZE + (long) GALAXY_SIZE * (r.galaxyCount() + 1)
+            + (long) SYSTEM_SIZE * (r.systemCount() + 1) + (long) PLANET_SIZE * r.planetCount();
+        ByteBuffer buffer = ByteBuffer.allocate(Math.toIntExact(size)).order(ByteOrder.LITTLE_ENDIAN);
+
+        buffer.put(MAGIC);
+        buffer.putInt(VERSION);
+        buffer.putInt(r.galaxyCount());
+        buffer.putInt(r.systemCount());
+        buffer.putInt(r.planetCount());
+
+        for (int g = 0; g <= r.galaxyCount(); g++) {
+            boolean sentinel = g == r.galaxyCount();
+            buffer.put(sentinel ? 0 : r.galaxyX()[g]);
+            buffer.put(sentinel ? 0 : r.galaxyY()[g]);
+            buffer.putShort((short) 0);
+            buffer.putInt(r.galaxySystemStart()[g]);
+        }
+        for (int s = 0; s <= r.systemCount(); s++) {
+            boolean sentinel = s == r.systemCount();
+            buffer.put(sentinel ? 0 : r.systemX()[s]);
+            buffer.put(sentinel ? 0 : r.systemY()[s]);
+            buffer.put(sentinel ? 0 : r.systemStarType()[s]);
+            buffer.put((byte) 0);
+            buffer.putInt(r.systemPlanetStart()[s]);
+        }
+        for (int p = 0; p < r.planetCount(); p++) {
+            buffer.put(r.planetX()[p]);
+            buffer.put(r.planetY()[p]);
+            buffer.put(r.planetType()[p]);
+            buffer.put(r.mineralDensity()[p]);
+            buffer.putShort(r.planetSize()[p]);
+            buffer.putShort(r.secondsForADay()[p]);
+            buffer.put(r.daysForAMonth()[p]);
+            buffer.put((byte) 0);
+        }
+        buffer.flip();
+
+        // write next to the target and rename, so a running service never maps a half-written file
+        Path tmp = path.resolveSibling(path.getFileName() + ".tmp");
+        try {
+            try (FileChannel channel = FileChannel.open(tmp, StandardOpenOption.CREATE, StandardOpenOption.WRITE,
+                StandardOpenOption.TRUNCATE_EXISTING)) {
+                while (buffer.hasRemaining()) {
+                    channel.write(buffer);
+                }
+            }
+            Files.move(tmp, path, StandardCopyOption.REPLACE_EXISTING, StandardCopyOption.ATOMIC_MOVE);
+        } catch (IOException | RuntimeException e) {
+            // e.g. the target is still mapped by planet_info.py on Windows; don't leave the partial file behind
+            Files.deleteIfExists(tmp);
+            throw e;
+        }
+    }
+}
@@ -0,0 +1,322 @@
+package com.weathering.generation;
+
+import java.io.IOException;
+import java.nio.file.Path;
+import java.util.Arrays;
+import java.util.concurrent.ForkJoinPool;
+import java.util.concurrent.RecursiveAction;
+
+/**
+ * Full-universe enumeration of galaxies, star systems and terrestrial planets, same visiting order and rules
+ * as {@code UniverseService._scan_galaxy_rows} in {@code planet_info.py}.
+ * Galaxy rows are scanned as work-stealing tasks on a ForkJoin pool; each row writes into its own columnar buffers,
+ * which are concatenated in row order at the end, so the result does not depend on scheduling.
+ */
+public final class UniverseScanner {
+    private UniverseScanner() {}
+
+    public static final int UNIVERSE_SIZE = 100;
+    public static final int GALAXY_SIZE = 100;
+    public static final int STAR_SYSTEM_SIZE = 32;
+
+    private static final long UNIVERSE_HASH = Hashing.hashString("Weathering.MapOfUniverse#");
+
+    /**
+     * Columnar scan result. Parent links use CSR offsets: systems of galaxy {@code g} are
+     * {@code [galaxySystemStart[g], galaxySystemStart[g + 1])}, planets of system {@code s} are
+     * {@code [systemPlanetStart[s], systemPlanetStart[s + 1])}. Coordinates fit in a byte (all below 100).
+     * {@code systemStarType} holds {@link CelestialGeneration.StarType} ordinals and {@code planetType}
+     * {@link CelestialGeneration.BodyType} ordinals.
+     */
+    public record ScanResult(int galaxyCount, byte[] galaxyX, byte[] galaxyY, int[] galaxySystemStart,
+                             int systemCount, byte[] systemX, byte[] systemY, byte[] systemStarType, int[] systemPlanetStart,
+                             int planetCount, byte[] planetX, byte[] planetY, byte[] planetType, short[] planetSize,
+                             byte[] mineralDensity, short[] secondsForADay, byte[] daysForAMonth) {
+        public CelestialGeneration.StarType starTypeOf(int system) {
+            return STAR_TYPES[systemStarType[system]];
+        }
+
+        public CelestialGeneration.BodyType planetTypeOf(int planet) {
+            return BODY_TYPES[planetType[planet]];
+        }
+
+        /** Index of the system owning {@code planet}; binary search over {@link #systemPlanetStart()}. */
+        public int systemOf(int planet) {
+            return ownerOf(systemPlanetStart, systemCount, planet);
+        }
+
+        /** Index of the galaxy owning {@code system}; binary search over {@link #galaxySystemStart()}. */
+        public int galaxyOf(int system) {
+            return ownerOf(galaxySystemStart, galaxyCount, system);
+        }
+
+        public String planetMapKey(int planet) {
+            int system = systemOf(planet);
+            int galaxy = galaxyOf(system);
+            return "Weathering.MapOfPlanet#=" + galaxyX[galaxy] + "," + galaxyY[galaxy]
+                + "=" + systemX[system] + "," + systemY[system]
+                + "=" + planetX[planet] + "," + planetY[planet];
+        }
+
+        private static int ownerOf(int[] starts, int count, int child) {
+            int index = Arrays.binarySearch(starts, 0, count + 1, child);
+            if (index < 0) {
+                return -index - 2;
+            }
+            // empty parents share the same start; the owner is the last one starting here
+            while (index + 1 < count && starts[index + 1] == child) {
+                index++;
+            }
+            return index;
+        }
+    }
+
+    private static final CelestialGeneration.StarType[] STAR_TYPES = CelestialGeneration.StarType.values();
+    private static final CelestialGeneration.BodyType[] BODY_TYPES = CelestialGeneration.BodyType.values();
+
+    public static ScanResult scan() {
+        return scan(0, UNIVERSE_SIZE, ForkJoinPool.commonPool());
+    }
+
+    public static ScanResult scan(ForkJoinPool pool) {
+        return scan(0, UNIVERSE_SIZE, pool);
+    }
+
+    /** Scans galaxy rows {@code [gyStart, gyEnd)}. */
+    public static ScanResult scan(int gyStart, int gyEnd, ForkJoinPool pool) {
+        if (gyStart < 0 || gyEnd > UNIVERSE_SIZE || gyStart > gyEnd) {
+            throw new IllegalArgumentException("Invalid galaxy row range: " + gyStart + ".." + gyEnd);
+        }
+        Columns[] rows = new Columns[gyEnd - gyStart];
+        pool.invoke(new RowTask(rows, gyStart, gyStart, gyEnd));
+        return Columns.concat(rows);
+    }
+
+    private static final class RowTask extends RecursiveAction {
+        private final Columns[] rows;
+        private final int base;
+        private final int lo;
+        private final int hi;
+
+        RowTask(Columns[] rows, int base, int lo, int hi) {
+            this.rows = rows;
+            this.base = base;
+            this.lo = lo;
+            this.hi = hi;
+        }
+
+        @Override
+        protected void compute() {
+            if (hi - lo <= 1) {
+                if (hi > lo) {
+                    rows[lo - base] = scanRow(lo);
+                }
+                return;
+            }
+            // galaxy density is uneven across rows, so split down to single rows and let idle workers steal
+            int mid = (lo + hi) >>> 1;
+            invokeAll(new RowTask(rows, base, lo, mid), new RowTask(rows, base, mid, hi));
+        }
+    }
+
+    static Columns scanRow(int gy) {
+        Columns out = new Columns();
+        int[] systemTiles = new int[GALAXY_SIZE * GALAXY_SIZE];
+        int[] bodyTiles = new int[STAR_SYSTEM_SIZE * STAR_SYSTEM_SIZE];
+        int[] bodyHashes = new int[STAR_SYSTEM_SIZE * STAR_SYSTEM_SIZE];
+        for (int gx = 0; gx < UNIVERSE_SIZE; gx++) {
+            long universeTileHash = Hashing.hash(gx, gy, UNIVERSE_SIZE, UNIVERSE_SIZE, (int) UNIVERSE_HASH);
+            if (!CelestialGeneration.isGalaxyTile(universeTileHash)) {
+                continue;
+            }
+            out.addGalaxy(gx, gy);
+            String galaxyIndex = "#=" + gx + "," + gy;
+            long galaxyHash = Hashing.hashString("Weathering.MapOfGalaxy" + galaxyIndex);
+            // the tile seeds of a whole map are consecutive, so one batch covers all rows
+            Hashing.hashRow(0, 0, GALAXY_SIZE, GALAXY_SIZE, (int) galaxyHash, systemTiles, 0, systemTiles.length);
+            for (int sy = 0; sy < GALAXY_SIZE; sy++) {
+                for (int sx = 0; sx < GALAXY_SIZE; sx++) {
+                    long galaxyTileHash = Integer.toUnsignedLong(systemTiles[sx + sy * GALAXY_SIZE]);
+                    if (!CelestialGeneration.isStarSystemTile(galaxyTileHash)) {
+                        continue;
+                    }
+                    scanStarSystem(out, galaxyIndex + "=" + sx + "," + sy, sx, sy, bodyTiles, bodyHashes);
+                }
+            }
+        }
+        return out;
+    }
+
+    private static void scanStarSystem(Columns out, String systemIndex, int sx, int sy, int[] bodyTiles, int[] bodyHashes) {
+        long systemHash = Hashing.hashString("Weathering.MapOfStarSystem" + systemIndex);
+        long systemSelfHash = Hashing.hashString(systemIndex);
+        out.addSystem(sx, sy, CelestialGeneration.calculateStarType(systemSelfHash));
+
+        var stars = CelestialGeneration.computeStarPositions(systemHash);
+        // classifyBody hashes the tile hash twice before its first test (% 50 != 0 -> empty space);
+        // run those two rounds in batch and only classify the ~2% of tiles that pass
+        Hashing.hashRow(0, 0, STAR_SYSTEM_SIZE, STAR_SYSTEM_SIZE, (int) systemHash, bodyTiles, 0, bodyTiles.length);
+        System.arraycopy(bodyTiles, 0, bodyHashes, 0, bodyTiles.length);
+        Hashing.hashInPlace(bodyHashes, 0, bodyHashes.length);
+        Hashing.hashInPlace(bodyHashes, 0, bodyHashes.length);
+        for (int py = 0; py < STAR_SYSTEM_SIZE; py++) {
+            for (int px = 0; px < STAR_SYSTEM_SIZE; px++) {
+                int k = px + py * STAR_SYSTEM_SIZE;
+                if (Integer.remainderUnsigned(bodyHashes[k], 50) != 0) {
+                    continue; // empty space, or a star tile, neither of which is terrestrial
+                }
+                long tileHash = Integer.toUnsignedLong(bodyTiles[k]);
+                var body = CelestialGeneration.classifyBody(tileHash, systemSelfHash, px, py, stars);
+                if (!isTerrestrial(body)) {
+                    continue;
+                }
+                String planetIndex = systemIndex + "=" + px + "," + py;
+                long planetHash = Hashing.hashString("Weathering.MapOfPlanet" + planetIndex);
+                long planetSelfHash = Hashing.hashString(planetIndex);
+                long again = Hashing.hash32(Hashing.hash32(tileHash));
+                int slowed = 1 + Math.abs((int) again % 7);
+                out.addPlanet(px, py, body,
+                    PlanetGeneration.calculatePlanetSize(planetSelfHash),
+                    PlanetGeneration.calculateMineralDensity(planetSelfHash),
+                    (60 * 8) / (1 + slowed),
+                    2 + (int) (planetHash % 15));
+            }
+        }
+    }
+
+    /** Playable planets, i.e. {@code PLANET_TYPES} in planet_info.py: no gas giants, asteroids or stars. */
+    public static boolean isTerrestrial(CelestialGeneration.BodyType body) {
+        return body.ordinal() <= CelestialGeneration.BodyType.PlanetSuperDimensional.ordinal();
+    }
+
+    /** Growable columns for one galaxy row. */
+    static final class Columns {
+        int galaxyCount;
+        byte[] galaxyX = new byte[4];
+        byte[] galaxyY = new byte[4];
+        int[] galaxySystemStart = new int[4];
+
+        int systemCount;
+        byte[] systemX = new byte[64];
+        byte[] systemY = new byte[64];
+        byte[] systemStarType = new byte[64];
+        int[] systemPlanetStart = new int[64];
+
+        int planetCount;
+        byte[] planetX = new byte[256];
+        byte[] planetY = new byte[256];
+        byte[] planetType = new byte[256];
+        short[] planetSize = new short[256];
+        byte[] mineralDensity = new byte[256];
+        short[] secondsForADay = new short[256];
+        byte[] daysForAMonth = new byte[256];
+
+        void addGalaxy(int x, int y) {
+            if (galaxyCount == galaxyX.length) {
+                int n = galaxyCount * 2;
+                galaxyX = Arrays.copyOf(galaxyX, n);
+                galaxyY = Arrays.copyOf(galaxyY, n);
+                galaxySystemStart = Arrays.copyOf(galaxySystemStart, n);
+            }
+            galaxyX[galaxyCount] = (byte) x;
+            galaxyY[galaxyCount] = (byte) y;
+            galaxySystemStart[galaxyCount] = systemCount;
+            galaxyCount++;
+        }
+
+        void addSystem(int x, int y, CelestialGeneration.StarType starType) {
+            if (systemCount == systemX.length) {
+                int n = systemCount * 2;
+                systemX = Arrays.copyOf(systemX, n);
+                systemY = Arrays.copyOf(systemY, n);
+                systemStarType = Arrays.copyOf(systemStarType, n);
+                systemPlanetStart = Arrays.copyOf(systemPlanetStart, n);
+            }
+            systemX[systemCount] = (byte) x;
+            systemY[systemCount] = (byte) y;
+            systemStarType[systemCount] = (byte) starType.ordinal();
+            systemPlanetStart[systemCount] = planetCount;
+            systemCount++;
+        }
+
+        void addPlanet(int x, int y, CelestialGeneration.BodyType type, int size, int mineral, int secondsPerDay, int daysPerMonth) {
+            if (planetCount == planetX.length) {
+                int n = planetCount * 2;
+                planetX = Arrays.copyOf(planetX, n);
+                planetY = Arrays.copyOf(planetY, n);
+                planetType = Arrays.copyOf(planetType, n);
+                planetSize = Arrays.copyOf(planetSize, n);
+                mineralDensity = Arrays.copyOf(mineralDensity, n);
+                secondsForADay = Arrays.copyOf(secondsForADay, n);
+                daysForAMonth = Arrays.copyOf(daysForAMonth, n);
+            }
+            planetX[planetCount] = (byte) x;
+            planetY[planetCount] = (byte) y;
+            planetType[planetCount] = (byte) type.ordinal();
+            planetSize[planetCount] = (short) size;
+            mineralDensity[planetCount] = (byte) mineral;
+            secondsForADay[planetCount] = (short) secondsPerDay;
+            daysForAMonth[planetCount] = (byte) daysPerMonth;
+            planetCount++;
+        }
+
+        static ScanResult concat(Columns[] rows) {
+            int galaxies = 0;
+            int systems = 0;
+            int planets = 0;
+            for (Columns row : rows) {
+                galaxies += row.galaxyCount;
+                systems += row.systemCount;
+                planets += row.planetCount;
+            }
+            ScanResult r = new ScanResult(galaxies, new byte[galaxies], new byte[galaxies], new int[galaxies + 1],
+                systems, new byte[systems], new byte[systems], new byte[systems], new int[systems + 1],
+                planets, new byte[planets], new byte[planets], new byte[planets], new short[planets],
+                new byte[planets], new short[planets], new byte[planets]);
+
+            int g = 0;
+            int s = 0;
+            int p = 0;
+            for (Columns row : rows) {
+                System.arraycopy(row.galaxyX, 0, r.galaxyX(), g, row.galaxyCount);
+                System.arraycopy(row.galaxyY, 0, r.galaxyY(), g, row.galaxyCount);
+                for (int k = 0; k < row.galaxyCount; k++) {
+                    r.galaxySystemStart()[g + k] = s + row.galaxySystemStart[k];
+                }
+                System.arraycopy(row.systemX, 0, r.systemX(), s, row.systemCount);
+                System.arraycopy(row.systemY, 0, r.systemY(), s, row.systemCount);
+                System.arraycopy(row.systemStarType, 0, r.systemStarType(), s, row.systemCount);
+                for (int k = 0; k < row.systemCount; k++) {
+                    r.systemPlanetStart()[s + k] = p + row.systemPlanetStart[k];
+                }
+                System.arraycopy(row.planetX, 0, r.planetX(), p, row.planetCount);
+                System.arraycopy(row.planetY, 0, r.planetY(), p, row.planetCount);
+                System.arraycopy(row.planetType, 0, r.planetType(), p, row.planetCount);
+                System.arraycopy(row.planetSize, 0, r.planetSize(), p, row.planetCount);
+                System.arraycopy(row.mineralDensity, 0, r.mineralDensity(), p, row.planetCount);
+                System.arraycopy(row.secondsForADay, 0, r.secondsForADay(), p, row.planetCount);
+                System.arraycopy(row.daysForAMonth, 0, r.daysForAMonth(), p, row.planetCount);
+                g += row.galaxyCount;
+                s += row.systemCount;
+                p += row.planetCount;
+            }
+            r.galaxySystemStart()[galaxies] = systems;
+            r.systemPlanetStart()[systems] = planets;
+            return r;
+        }
+    }
+
+    /** Optional argument: path of the universe index to write, e.g. {@code ../universe.idx}. */
+    public static void main(String[] args) throws IOException {
+        long start = System.nanoTime();
+        ScanResult r = scan();
+        double seconds = (System.nanoTime() - start) / 1e9;
+        System.out.printf("galaxies=%d, starSystems=%d, planets=%d, seconds=%.2f, parallelism=%d%n",
+            r.galaxyCount(), r.systemCount(), r.planetCount(), seconds, ForkJoinPool.commonPool().getParallelism());
+        if (args.length > 0) {
+            Path path = Path.of(args[0]);
+            UniverseIndexWriter.write(r, path);
+            System.out.println("index written: " + path.toAbsolutePath());
+        }
+    }
+}
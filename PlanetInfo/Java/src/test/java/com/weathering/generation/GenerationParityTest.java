@@ -2,6 +2,7 @@ package com.weathering.generation;
 
 import java.util.EnumMap;
 import java.util.Map;
+import java.util.concurrent.ForkJoinPool;
 
 public final class GenerationParityTest {
     public static void main(String[] args) {
@@ -9,6 +10,9 @@ public final class GenerationParityTest {
         testStarSystemClassification();
         testPlanetProfileAndTerrain();
         testKnownHierarchyCoordinates();
+        testBatchHashingMatchesScalar();
+        testFlatGenerationMatchesJagged();
+        testUniverseScannerMatchesPlanetInfo();
         System.out.println("All generation parity checks passed.");
     }
 
@@ -126,6 +130,113 @@ public final class GenerationParityTest {
         require(planetLikeBodies == 16, "Expected 16 planet-like bodies in star system (1,4)->(14,93)");
     }
 
+    private static void testBatchHashingMatchesScalar() {
+        var random = new java.util.Random(3);
+        int[] hashes = new int[300];
+        for (int t = 0; t < 2000; t++) {
+            int width = 1 + random.nextInt(299);
+            int height = 1 + random.nextInt(299);
+            int offset = random.nextInt();
+            int start = random.nextInt(width + 5) - 5;
+            int fixed = random.nextInt(height + 5) - 5;
+            int count = random.nextInt(300);
+            Hashing.hashRow(start, fixed, width, height, offset, hashes, 0, count);
+            for (int k = 0; k < count; k++) {
+                require(Integer.toUnsignedLong(hashes[k]) == Hashing.hash(start + k, fixed, width, height, offset), "hashRow mismatch");
+            }
+            Hashing.hashColumn(fixed, start, width, height, offset, hashes, 0, count);
+            for (int k = 0; k < count; k++) {
+                require(Integer.toUnsignedLong(hashes[k]) == Hashing.hash(fixed, start + k, width, height, offset), "hashColumn mismatch");
+            }
+            Hashing.hashInPlace(hashes, 0, count);
+            for (int k = 0; k < count; k++) {
+                require(Integer.toUnsignedLong(hashes[k]) == Hashing.hash32(Hashing.hash(fixed, start + k, width, height, offset)),
+                    "hashInPlace mismatch");
+            }
+        }
+        float[] noise = new float[400];
+        for (int t = 0; t < 3000; t++) {
+            int size = 1 + random.nextInt(69);
+            int width = 1 + random.nextInt(399);
+            int height = 1 + random.nextInt(399);
+            int layer = random.nextInt();
+            int j = random.nextInt(height);
+            Hashing.perlinNoiseRow(size, j, width, height, layer, noise, 0);
+            for (int i = 0; i < width; i++) {
+                float expected = Hashing.perlinNoise((float) size * i / width, (float) size * j / height, size, size, layer);
+                require(Float.floatToRawIntBits(expected) == Float.floatToRawIntBits(noise[i]), "perlinNoiseRow mismatch");
+            }
+        }
+    }
+
+    private static void testFlatGenerationMatchesJagged() {
+        long[][] keys = {
+            { 99887766L, 1234567890L },
+            { Hashing.hashString("Weathering.MapOfPlanet#=1,4=14,93=24,31"), Hashing.hashString("#=1,4=14,93=24,31") },
+            { 3141592653L, 2718281828L },
+            { 4294967295L, 7L },
+        };
+        for (long[] key : keys) {
+            var jagged = PlanetGeneration.generate(key[0], key[1], 5);
+            for (boolean parallel : new boolean[] { false, true }) {
+                var flat = PlanetGeneration.generateFlat(key[0], key[1], 5, parallel);
+                require(flat.width() == jagged.width() && flat.height() == jagged.height(), "Flat map size mismatch");
+                for (int i = 0; i < jagged.width(); i++) {
+                    for (int j = 0; j < jagged.height(); j++) {
+                        int index = flat.index(i, j);
+                        require(flat.altitudes()[index] == jagged.altitudes()[i][j], "Flat altitude mismatch");
+                        require(flat.moistures()[index] == jagged.moistures()[i][j], "Flat moisture mismatch");
+                        require(flat.temperatures()[index] == jagged.temperatures()[i][j], "Flat temperature mismatch");
+                        require(flat.altitudeTypeAt(i, j) == jagged.altitudeTypes()[i][j], "Flat altitude type mismatch");
+                        require(flat.moistureTypeAt(i, j) == jagged.moistureTypes()[i][j], "Flat moisture type mismatch");
+                        require(flat.temperatureTypeAt(i, j) == jagged.temperatureTypes()[i][j], "Flat temperature type mismatch");
+                        require(flat.terrainTypeAt(i, j) == jagged.terrainTypes()[i][j], "Flat terrain mismatch");
+                        require(flat.oreTypeAt(i, j) == jagged.oreTypes()[i][j], "Flat ore mismatch");
+                    }
+                }
+            }
+        }
+    }
+
+    private static void testUniverseScannerMatchesPlanetInfo() {
+        var stars = CelestialGeneration.computeStarPositions(Hashing.hashString("Weathering.MapOfStarSystem#=1,4=14,93"));
+        require(stars.x() == 17 && stars.y() == 14, "Primary star position mismatch for star system (1,4)->(14,93)");
+
+        // counts and samples from planet_info.py (UniverseService._scan_galaxy_rows / verify_samples)
+        // ForkJoinPool is AutoCloseable since JDK 19, so the pool is closed even when a check fails
+        try (var pool = new ForkJoinPool(4)) {
+            var row4 = UniverseScanner.scan(4, 5, pool);
+            require(row4.galaxyCount() == 7 && row4.systemCount() == 374 && row4.planetCount() == 3046,
+                "Universe scan counts mismatch for galaxy row 4");
+            requirePlanet(row4, "Weathering.MapOfPlanet#=1,4=14,93=24,31", CelestialGeneration.BodyType.PlanetContinental,
+                CelestialGeneration.StarType.StarOrange, 160, 5, 142, 5);
+            requirePlanet(row4, "Weathering.MapOfPlanet#=1,4=14,93=24,1", CelestialGeneration.BodyType.PlanetFrozen,
+                CelestialGeneration.StarType.StarOrange, 80, 2, 71, 3);
+
+            var row11 = UniverseScanner.scan(11, 12, pool);
+            require(row11.galaxyCount() == 3 && row11.systemCount() == 128 && row11.planetCount() == 1024,
+                "Universe scan counts mismatch for galaxy row 11");
+            requirePlanet(row11, "Weathering.MapOfPlanet#=97,11=18,1=20,6", CelestialGeneration.BodyType.PlanetBarren,
+                CelestialGeneration.StarType.StarYellow, 80, 5, 120, 7);
+        }
+    }
+
+    private static void requirePlanet(UniverseScanner.ScanResult scan, String mapKey, CelestialGeneration.BodyType type,
+                                      CelestialGeneration.StarType starType, int secondsForADay, int daysForAMonth,
+                                      int size, int mineralDensity) {
+        for (int p = 0; p < scan.planetCount(); p++) {
+            if (!scan.planetMapKey(p).equals(mapKey)) continue;
+            require(scan.planetTypeOf(p) == type, "Planet type mismatch for " + mapKey);
+            require(scan.starTypeOf(scan.systemOf(p)) == starType, "Star type mismatch for " + mapKey);
+            require(scan.secondsForADay()[p] == secondsForADay, "Seconds per day mismatch for " + mapKey);
+            require(scan.daysForAMonth()[p] == daysForAMonth, "Days per month mismatch for " + mapKey);
+            require(scan.planetSize()[p] == size, "Planet size mismatch for " + mapKey);
+            require(scan.mineralDensity()[p] == mineralDensity, "Mineral density mismatch for " + mapKey);
+            return;
+        }
+        throw new IllegalStateException("Planet not found in scan: " + mapKey);
+    }
+
     private static void require(boolean condition, String message) {
         if (!condition) throw new IllegalStateException(message);
     }
@@ -1,19 +1,30 @@
 from __future__ import annotations
 
+import base64
+import gzip
+import hashlib
 import json
+import mmap
 import os
 import inspect
 import math
+import struct
+import sys
 import threading
 import time
 from concurrent.futures import ThreadPoolExecutor, as_completed
-from collections import Counter, defaultdict
+from collections import Counter, OrderedDict, defaultdict
 from dataclasses import asdict, dataclass
 from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
 from typing import Dict, Iterable, List, Optional, Tuple
 from urllib.parse import parse_qs, unquote
 from urllib.request import urlopen
 
+try:
+    import numpy as np  # 可选，仅用于批量哈希
+except ImportError:
+    np = None
+
 MASK32 = 0xFFFFFFFF
 UNIVERSE_SIZE = 100
 GALAXY_SIZE = 100
@@ -78,6 +89,29 @@ class HashUtility:
         raw = u32(offset * width + height + i + j * width)
         return HashUtility.hash_uint(raw)
 
+    @staticmethod
+    def hash_uint_batch(values: Iterable[int]) -> List[int]:
+        """逐个 hash_uint；有 numpy 时按 uint32 向量计算，结果与标量版一致"""
+        if np is None:
+            return [HashUtility.hash_uint(v) for v in values]
+        a = np.asarray(values, dtype=np.uint32)
+        a = (a ^ np.uint32(61)) ^ (a >> np.uint32(16))
+        a = a + (a << np.uint32(3))
+        a = a ^ (a >> np.uint32(4))
+        a = a * np.uint32(0x27D4EB2D)
+        a = a ^ (a >> np.uint32(15))
+        return a.tolist()
+
+    @staticmethod
+    def hash_tiles(width: int, height: int, offset: int = 0) -> List[int]:
+        """整张地图每格的 hash_tile，按 i + j * width 排列。各格种子是连续整数"""
+        base = u32(offset * width + height)
+        count = width * height
+        if np is None:
+            return [HashUtility.hash_uint(u32(base + k)) for k in range(count)]
+        seeds = ((np.arange(count, dtype=np.uint64) + np.uint64(base)) & np.uint64(MASK32)).astype(np.uint32)
+        return HashUtility.hash_uint_batch(seeds)
+
 
 @dataclass(frozen=True)
 class PlanetRecord:
@@ -335,8 +369,220 @@ def verify_samples() -> None:
             raise AssertionError(f"样例不匹配: {k}\n got={got}\n exp={expected}")
 
 
+INDEX_MAGIC = b"WUIX"
+INDEX_VERSION = 1
+DEFAULT_INDEX_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "universe.idx")
+# 与 Java CelestialGeneration.StarType / BodyType 的枚举序号一致（BodyType 前 8 项即 PLANET_TYPES 的顺序）
+PLANET_TYPE_CODES = tuple(PLANET_TYPES.values())
+STAR_TYPE_CODES = tuple(STAR_TYPES[i] for i in range(len(STAR_TYPES)))
+
+GalaxyData = Tuple[Dict[str, object], Dict[Tuple[int, int, int, int], Dict[str, object]], Dict[str, PlanetRecord]]
+
+
+class UniverseIndex:
+    """
+    预计算的宇宙索引文件，只读 mmap 后直接按偏移查询。格式（小端）：
+    - 头部：magic, version, 星系数 G, 恒星系数 S, 行星数 P
+    - 星系表 G+1 项：x, y, 首个恒星系序号（最后一项为哨兵，只有序号有效）
+    - 恒星系表 S+1 项：x, y, 恒星类型, 首个行星序号（同上）
+    - 行星表 P 项：x, y, 行星类型, 矿物稀疏度, 大小, 昼夜秒数, 每月天数
+    星系按 (y, x) 排序，恒星系、行星按所属上级连续存放且各自按 (y, x) 排序，与扫描顺序一致。
+    由 Java UniverseScanner 或 `python3 planet_info.py --build-index` 生成。
+    """
+
+    HEADER = struct.Struct("<4sIIII")
+    GALAXY = struct.Struct("<BBxxI")
+    SYSTEM = struct.Struct("<BBBxI")
+    PLANET = struct.Struct("<BBBBHHBx")
+
+    def __init__(self, path: str) -> None:
+        self.path = path
+        with open(path, "rb") as f:
+            self._mm = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, version, self.galaxy_count, self.system_count, self.planet_count = self.HEADER.unpack_from(self._mm, 0)
+        if magic != INDEX_MAGIC:
+            raise ValueError("索引文件格式错误")
+        if version != INDEX_VERSION:
+            raise ValueError(f"索引文件版本 {version} 与当前版本 {INDEX_VERSION} 不一致，需要重新生成")
+        self._galaxy_offset = self.HEADER.size
+        self._system_offset = self._galaxy_offset + self.GALAXY.size * (self.galaxy_count + 1)
+        self._planet_offset = self._system_offset + self.SYSTEM.size * (self.system_count + 1)
+        if len(self._mm) != self._planet_offset + self.PLANET.size * self.planet_count:
+            raise ValueError("索引文件长度不符")
+        self._galaxy_slots = {self.galaxy(g)[:2]: g for g in range(self.galaxy_count)}
+        st = os.stat(path)
+        self.version_tag = f"index-{st.st_size}-{st.st_mtime_ns}"
+
+    @classmethod
+    def open(cls, path: str) -> Optional["UniverseIndex"]:
+        if not os.path.exists(path):
+            return None
+        try:
+            return cls(path)
+        except (OSError, ValueError, struct.error) as exc:
+            print(f"[PlanetInfo] 忽略宇宙索引 {path}: {exc}")
+            return None
+
+    def galaxy(self, g: int) -> Tuple[int, int, int, int]:
+        """(x, y, 恒星系起始序号, 恒星系结束序号)"""
+        x, y, start = self.GALAXY.unpack_from(self._mm, self._galaxy_offset + self.GALAXY.size * g)
+        end = self.GALAXY.unpack_from(self._mm, self._galaxy_offset + self.GALAXY.size * (g + 1))[2]
+        return x, y, start, end
+
+    def system(self, s: int) -> Tuple[int, int, int, int, int]:
+        """(x, y, 恒星类型序号, 行星起始序号, 行星结束序号)"""
+        x, y, star, start = self.SYSTEM.unpack_from(self._mm, self._system_offset + self.SYSTEM.size * s)
+        end = self.SYSTEM.unpack_from(self._mm, self._system_offset + self.SYSTEM.size * (s + 1))[3]
+        return x, y, star, start, end
+
+    def planet(self, p: int) -> Tuple[int, int, int, int, int, int, int]:
+        """(x, y, 行星类型序号, 矿物稀疏度, 大小, 昼夜秒数, 每月天数)"""
+        return self.PLANET.unpack_from(self._mm, self._planet_offset + self.PLANET.size * p)
+
+    def galaxy_summaries(self) -> List[Tuple[int, int, int]]:
+        """[(x, y, 行星数)]"""
+        out = []
+        for g in range(self.galaxy_count):
+            x, y, s0, s1 = self.galaxy(g)
+            out.append((x, y, self._planet_start(s1) - self._planet_start(s0)))
+        return out
+
+    def _planet_start(self, s: int) -> int:
+        # s 可以是哨兵项
+        return self.SYSTEM.unpack_from(self._mm, self._system_offset + self.SYSTEM.size * s)[3]
+
+    def _planet_record(self, gx: int, gy: int, sx: int, sy: int, star_type: str, p: int) -> PlanetRecord:
+        px, py, kind, mineral, size, seconds, days_per_month = self.planet(p)
+        return PlanetRecord(
+            map_key=build_map_key("MapOfPlanet", [(gx, gy), (sx, sy), (px, py)]),
+            galaxy_x=gx,
+            galaxy_y=gy,
+            star_system_x=sx,
+            star_system_y=sy,
+            planet_x=px,
+            planet_y=py,
+            star_type=star_type,
+            planet_type=PLANET_TYPE_CODES[kind],
+            seconds_for_a_day=seconds,
+            days_for_a_month=days_per_month,
+            days_for_a_year=MONTH_FOR_A_YEAR * days_per_month,
+            month_for_a_year=MONTH_FOR_A_YEAR,
+            planet_size=size,
+            mineral_density=mineral,
+        )
+
+    def load_galaxy(self, gx: int, gy: int) -> GalaxyData:
+        """与 UniverseService._scan_galaxy 结构相同的单个星系数据"""
+        g = self._galaxy_slots[(gx, gy)]
+        _, _, s0, s1 = self.galaxy(g)
+        galaxy = {"x": gx, "y": gy, "system_keys": [], "planet_count": 0, "star_type_counter": Counter()}
+        systems: Dict[Tuple[int, int, int, int], Dict[str, object]] = {}
+        planets: Dict[str, PlanetRecord] = {}
+        for s in range(s0, s1):
+            sx, sy, star, p0, p1 = self.system(s)
+            star_type = STAR_TYPE_CODES[star]
+            skey = (gx, gy, sx, sy)
+            galaxy["system_keys"].append(skey)
+            galaxy["star_type_counter"][star_type] += 1
+            system = {
+                "gx": gx,
+                "gy": gy,
+                "sx": sx,
+                "sy": sy,
+                "star_type": star_type,
+                "planet_keys": [],
+                "planet_count": p1 - p0,
+                "planet_type_counter": Counter(),
+            }
+            for p in range(p0, p1):
+                record = self._planet_record(gx, gy, sx, sy, star_type, p)
+                planets[record.map_key] = record
+                system["planet_keys"].append(record.map_key)
+                system["planet_type_counter"][record.planet_type] += 1
+            systems[skey] = system
+            galaxy["planet_count"] += p1 - p0
+        return galaxy, systems, planets
+
+    def iter_system_planets(self) -> Iterable[Tuple[Dict[str, object], List[Tuple[int, int]]]]:
+        """逐个恒星系给出 (恒星系信息, [(行星大小, 矿物稀疏度)])，不构造 PlanetRecord"""
+        for g in range(self.galaxy_count):
+            gx, gy, s0, s1 = self.galaxy(g)
+            for s in range(s0, s1):
+                sx, sy, star, p0, p1 = self.system(s)
+                counter: Counter = Counter()
+                planets = []
+                for p in range(p0, p1):
+                    _, _, kind, mineral, size, _, _ = self.planet(p)
+                    counter[PLANET_TYPE_CODES[kind]] += 1
+                    planets.append((size, mineral))
+                system = {
+                    "gx": gx,
+                    "gy": gy,
+                    "sx": sx,
+                    "sy": sy,
+                    "star_type": STAR_TYPE_CODES[star],
+                    "planet_count": p1 - p0,
+                    "planet_type_counter": counter,
+                }
+                yield system, planets
+
+    def close(self) -> None:
+        self._mm.close()
+
+    @classmethod
+    def write(
+        cls,
+        path: str,
+        galaxies: Dict[Tuple[int, int], Dict[str, object]],
+        systems: Dict[Tuple[int, int, int, int], Dict[str, object]],
+        planets_by_key: Dict[str, PlanetRecord],
+    ) -> None:
+        planet_codes = {name: code for code, name in enumerate(PLANET_TYPE_CODES)}
+        star_codes = {name: code for code, name in enumerate(STAR_TYPE_CODES)}
+        galaxy_table = bytearray()
+        system_table = bytearray()
+        planet_table = bytearray()
+        system_count = 0
+        planet_count = 0
+        for gkey in sorted(galaxies, key=lambda k: (k[1], k[0])):
+            g = galaxies[gkey]
+            galaxy_table += cls.GALAXY.pack(g["x"], g["y"], system_count)
+            for skey in g["system_keys"]:
+                s = systems[skey]
+                system_table += cls.SYSTEM.pack(s["sx"], s["sy"], star_codes[s["star_type"]], planet_count)
+                system_count += 1
+                for map_key in s["planet_keys"]:
+                    r = planets_by_key[map_key]
+                    planet_table += cls.PLANET.pack(
+                        r.planet_x, r.planet_y, planet_codes[r.planet_type], r.mineral_density,
+                        r.planet_size, r.seconds_for_a_day, r.days_for_a_month,
+                    )
+                    planet_count += 1
+        galaxy_table += cls.GALAXY.pack(0, 0, system_count)
+        system_table += cls.SYSTEM.pack(0, 0, 0, planet_count)
+
+        tmp = path + ".tmp"
+        with open(tmp, "wb") as f:
+            f.write(cls.HEADER.pack(INDEX_MAGIC, INDEX_VERSION, len(galaxies), system_count, planet_count))
+            f.write(galaxy_table)
+            f.write(system_table)
+            f.write(planet_table)
+        os.replace(tmp, path)
+
+
 class UniverseService:
-    def __init__(self) -> None:
+    # 没有索引文件时，按星系懒扫描，最近用过的星系留在缓存里
+    GALAXY_CACHE_SIZE = 32
+    # 排好序的列表（排序索引）按数据版本缓存，每项记下自己的版本，版本变化时失效
+    SORTED_CACHE_SIZE = 512
+    # 数据版本的范围。懒扫描时只有星系列表的行星数随扫描进度变化，排行榜也用这个全局版本；
+    # 恒星系、行星列表和详情只由坐标决定，扫描进度变化时不失效
+    SCOPE_GLOBAL = "global"
+    SCOPE_STATIC = "static"
+    DEFAULT_PAGE_SIZE = 50
+    MAX_PAGE_SIZE = 500
+
+    def __init__(self, index_path: Optional[str] = None, use_index: bool = True) -> None:
         self.preloaded = False
         self.preloading = False
         self.preload_seconds = 0.0
@@ -347,8 +593,25 @@ class UniverseService:
         self._preload_thread: Optional[threading.Thread] = None
         self._preload_rows_done = 0
         self._preload_rows_total = UNIVERSE_SIZE
+        self.index: Optional[UniverseIndex] = None
+        if use_index:
+            self.index = UniverseIndex.open(index_path or os.environ.get("PLANETINFO_INDEX") or DEFAULT_INDEX_PATH)
+        if self.index is not None:
+            print(
+                f"[PlanetInfo] 使用宇宙索引 {self.index.path}: 星系={self.index.galaxy_count}, "
+                f"恒星系={self.index.system_count}, 行星={self.index.planet_count}"
+            )
+        self._galaxy_cache: "OrderedDict[Tuple[int, int], GalaxyData]" = OrderedDict()
+        self._galaxy_cache_lock = threading.Lock()
+        self._galaxy_planet_counts: Dict[Tuple[int, int], int] = {}
+        self._galaxy_positions: Optional[List[Tuple[int, int]]] = None
+        self._sorted_cache: "OrderedDict[Tuple, Tuple[str, object]]" = OrderedDict()
+        self._sorted_cache_lock = threading.Lock()
 
     def ensure_preload_started(self) -> None:
+        # 有索引时不需要预加载；没有索引时在后台补全排行榜和星系行星数需要的全量数据，不影响浏览
+        if self.index is not None:
+            return
         with self._preload_lock:
             if self.preloaded or self.preloading:
                 return
@@ -357,11 +620,25 @@ class UniverseService:
             self._preload_thread.start()
 
     def preload_status(self) -> Dict[str, object]:
+        if self.index is not None:
+            return {
+                "ready": True,
+                "mode": "index",
+                "preloading": False,
+                "progress_percent": 100,
+                "rows_done": UNIVERSE_SIZE,
+                "rows_total": UNIVERSE_SIZE,
+                "galaxy_count": self.index.galaxy_count,
+                "system_count": self.index.system_count,
+                "planet_count": self.index.planet_count,
+                "preload_seconds": 0.0,
+            }
         progress = min(100, int((self._preload_rows_done / max(1, self._preload_rows_total)) * 100))
         if self.preloaded:
             progress = 100
         return {
-            "ready": self.preloaded,
+            "ready": True,
+            "mode": "lazy",
             "preloading": self.preloading,
             "progress_percent": progress,
             "rows_done": self._preload_rows_done,
@@ -372,6 +649,68 @@ class UniverseService:
             "preload_seconds": round(self.preload_seconds, 2),
         }
 
+    @staticmethod
+    def _scan_galaxy(gx: int, gy: int) -> GalaxyData:
+        galaxy: Dict[str, object] = {
+            "x": gx,
+            "y": gy,
+            "system_keys": [],
+            "planet_count": 0,
+            "star_type_counter": Counter(),
+        }
+        systems: Dict[Tuple[int, int, int, int], Dict[str, object]] = {}
+        planets: Dict[str, PlanetRecord] = {}
+
+        galaxy_hash = HashUtility.hash_string(build_map_key("MapOfGalaxy", [(gx, gy)]))
+        system_tiles = HashUtility.hash_tiles(GALAXY_SIZE, GALAXY_SIZE, csharp_int32(galaxy_hash))
+        for sy in range(GALAXY_SIZE):
+            for sx in range(GALAXY_SIZE):
+                if system_tiles[sx + sy * GALAXY_SIZE] % 200 != 0:  # 同 is_star_system
+                    continue
+                ss_map_key = build_map_key("MapOfStarSystem", [(gx, gy), (sx, sy)])
+                star_type = calculate_star_type(ss_map_key)
+
+                skey = (gx, gy, sx, sy)
+                galaxy["system_keys"].append(skey)
+                galaxy["star_type_counter"][star_type] += 1
+
+                systems[skey] = {
+                    "gx": gx,
+                    "gy": gy,
+                    "sx": sx,
+                    "sy": sy,
+                    "star_type": star_type,
+                    "planet_keys": [],
+                    "planet_count": 0,
+                    "planet_type_counter": Counter(),
+                }
+
+                ss_hash_i = csharp_int32(HashUtility.hash_string(ss_map_key))
+                main_star, second_star = _star_positions(ss_map_key)
+
+                # 天体判定的前两轮哈希（% 50 为虚空）整批计算，只有约 2% 的格子继续
+                tiles = HashUtility.hash_tiles(STAR_SYSTEM_SIZE, STAR_SYSTEM_SIZE, ss_hash_i)
+                rounds = HashUtility.hash_uint_batch(HashUtility.hash_uint_batch(tiles))
+                for k, h in enumerate(rounds):
+                    if h % 50 != 0:
+                        continue
+                    px, py = k % STAR_SYSTEM_SIZE, k // STAR_SYSTEM_SIZE
+                    if (px, py) == main_star or (second_star is not None and (px, py) == second_star):
+                        continue
+                    if HashUtility.hash_uint(h) % 2 != 0:
+                        continue
+                    try:
+                        p = compute_planet_record_fast(gx, gy, sx, sy, px, py, star_type, tiles[k])
+                    except ValueError:
+                        continue
+                    planets[p.map_key] = p
+                    systems[skey]["planet_keys"].append(p.map_key)
+                    systems[skey]["planet_count"] += 1
+                    systems[skey]["planet_type_counter"][p.planet_type] += 1
+                    galaxy["planet_count"] += 1
+
+        return galaxy, systems, planets
+
     @staticmethod
     def _scan_galaxy_rows(
         gy_start: int, gy_end: int
@@ -384,67 +723,60 @@ class UniverseService:
             for gx in range(UNIVERSE_SIZE):
                 if not is_galaxy((gx, gy)):
                     continue
-                gkey = (gx, gy)
-                chunk_galaxies[gkey] = {
-                    "x": gx,
-                    "y": gy,
-                    "system_keys": [],
-                    "planet_count": 0,
-                    "star_type_counter": Counter(),
-                }
-
-                for sy in range(GALAXY_SIZE):
-                    for sx in range(GALAXY_SIZE):
-                        if not is_star_system((gx, gy), (sx, sy)):
-                            continue
-                        ss_map_key = build_map_key("MapOfStarSystem", [(gx, gy), (sx, sy)])
-                        star_type = calculate_star_type(ss_map_key)
-
-                        skey = (gx, gy, sx, sy)
-                        chunk_galaxies[gkey]["system_keys"].append(skey)
-                        chunk_galaxies[gkey]["star_type_counter"][star_type] += 1
-
-                        chunk_systems[skey] = {
-                            "gx": gx,
-                            "gy": gy,
-                            "sx": sx,
-                            "sy": sy,
-                            "star_type": star_type,
-                            "planet_keys": [],
-                            "planet_count": 0,
-                            "planet_type_counter": Counter(),
-                        }
-
-                        ss_hash_i = csharp_int32(HashUtility.hash_string(ss_map_key))
-                        main_star, second_star = _star_positions(ss_map_key)
-
-                        for py in range(STAR_SYSTEM_SIZE):
-                            for px in range(STAR_SYSTEM_SIZE):
-                                is_star_tile = (px, py) == main_star or (second_star is not None and (px, py) == second_star)
-                                tile_hash = HashUtility.hash_tile(px, py, STAR_SYSTEM_SIZE, STAR_SYSTEM_SIZE, ss_hash_i)
-                                h = HashUtility.hash_uint(tile_hash)
-
-                                if is_star_tile:
-                                    continue
-                                h = HashUtility.hash_uint(h)
-                                if h % 50 != 0:
-                                    continue
-                                h = HashUtility.hash_uint(h)
-                                if h % 2 != 0:
-                                    continue
-
-                                try:
-                                    p = compute_planet_record_fast(gx, gy, sx, sy, px, py, star_type, tile_hash)
-                                except ValueError:
-                                    continue
-                                chunk_planets[p.map_key] = p
-                                chunk_systems[skey]["planet_keys"].append(p.map_key)
-                                chunk_systems[skey]["planet_count"] += 1
-                                chunk_systems[skey]["planet_type_counter"][p.planet_type] += 1
-                                chunk_galaxies[gkey]["planet_count"] += 1
+                galaxy, systems, planets = UniverseService._scan_galaxy(gx, gy)
+                chunk_galaxies[(gx, gy)] = galaxy
+                chunk_systems.update(systems)
+                chunk_planets.update(planets)
 
         return gy_end - gy_start, chunk_galaxies, chunk_systems, chunk_planets
 
+    def _galaxy_data(self, gx: int, gy: int) -> GalaxyData:
+        key = (gx, gy)
+        with self._galaxy_cache_lock:
+            data = self._galaxy_cache.get(key)
+            if data is not None:
+                self._galaxy_cache.move_to_end(key)
+                return data
+        if self.index is not None:
+            data = self.index.load_galaxy(gx, gy)
+        elif is_galaxy(key):
+            data = self._scan_galaxy(gx, gy)
+        else:
+            raise KeyError(key)
+        with self._galaxy_cache_lock:
+            self._galaxy_cache[key] = data
+            self._galaxy_planet_counts[key] = data[0]["planet_count"]
+            while len(self._galaxy_cache) > self.GALAXY_CACHE_SIZE:
+                self._galaxy_cache.popitem(last=False)
+        return data
+
+    def _galaxy(self, gx: int, gy: int) -> Dict[str, object]:
+        if self.preloaded:
+            return self.galaxies[(gx, gy)]
+        return self._galaxy_data(gx, gy)[0]
+
+    def _system(self, gx: int, gy: int, sx: int, sy: int) -> Dict[str, object]:
+        if self.preloaded:
+            return self.systems[(gx, gy, sx, sy)]
+        return self._galaxy_data(gx, gy)[1][(gx, gy, sx, sy)]
+
+    def _planet(self, map_key: str) -> PlanetRecord:
+        if self.preloaded:
+            return self.planets_by_key[map_key]
+        (gx, gy), _, _ = parse_map_key(map_key)
+        return self._galaxy_data(gx, gy)[2][map_key]
+
+    def _lazy_galaxy_positions(self) -> List[Tuple[int, int]]:
+        if self._galaxy_positions is None:
+            universe_hash = csharp_int32(HashUtility.hash_string("Weathering.MapOfUniverse#"))
+            self._galaxy_positions = [
+                (gx, gy)
+                for gy in range(UNIVERSE_SIZE)
+                for gx in range(UNIVERSE_SIZE)
+                if HashUtility.hash_tile(gx, gy, UNIVERSE_SIZE, UNIVERSE_SIZE, universe_hash) % 50 == 0
+            ]
+        return self._galaxy_positions
+
     def preload_all(self) -> None:
         wait_thread: Optional[threading.Thread] = None
         with self._preload_lock:
@@ -474,6 +806,8 @@ class UniverseService:
             for future in as_completed(future_map):
                 rows_done, row_galaxies, row_systems, row_planets = future.result()
                 self.galaxies.update(row_galaxies)
+                for gkey, g in row_galaxies.items():
+                    self._galaxy_planet_counts[gkey] = g["planet_count"]
                 self.systems.update(row_systems)
                 self.planets_by_key.update(row_planets)
                 self._preload_rows_done += rows_done
@@ -494,6 +828,75 @@ class UniverseService:
             f"行星={len(self.planets_by_key)}, 耗时={self.preload_seconds:.2f}s"
         )
 
+    def data_version(self, scope: str = SCOPE_GLOBAL) -> str:
+        """数据版本；排序索引、cursor 和 HTTP 响应缓存都以它为准。使用索引文件时只随文件变化"""
+        if self.index is not None:
+            return self.index.version_tag
+        if scope == self.SCOPE_STATIC:
+            return "lazy"
+        return f"lazy-{int(self.preloaded)}-{len(self._galaxy_planet_counts)}"
+
+    def _memo(self, key: Tuple, build, scope: str = SCOPE_GLOBAL):
+        version = self.data_version(scope)
+        with self._sorted_cache_lock:
+            entry = self._sorted_cache.get(key)
+            if entry is not None and entry[0] == version:
+                self._sorted_cache.move_to_end(key)
+                return entry[1]
+        value = build()
+        with self._sorted_cache_lock:
+            if self.data_version(scope) == version:
+                self._sorted_cache[key] = (version, value)
+                self._sorted_cache.move_to_end(key)
+                while len(self._sorted_cache) > self.SORTED_CACHE_SIZE:
+                    self._sorted_cache.popitem(last=False)
+        return value
+
+    def encode_cursor(self, offset: int, scope: str = SCOPE_GLOBAL) -> str:
+        raw = f"{self.data_version(scope)}:{offset}".encode("utf-8")
+        return base64.urlsafe_b64encode(raw).decode("ascii").rstrip("=")
+
+    def decode_cursor(self, cursor: str, scope: str = SCOPE_GLOBAL) -> int:
+        try:
+            raw = base64.urlsafe_b64decode(cursor + "=" * (-len(cursor) % 4)).decode("utf-8")
+            version, offset = raw.rsplit(":", 1)
+        except Exception:
+            raise ValueError("无效的 cursor")
+        if version != self.data_version(scope):
+            raise ValueError("cursor 已过期，请从第一页重新请求")
+        return int(offset)
+
+    def paginate(
+        self,
+        rows: List[Dict[str, object]],
+        offset: int = 0,
+        limit: Optional[int] = None,
+        cursor: Optional[str] = None,
+        scope: str = SCOPE_GLOBAL,
+    ) -> Dict[str, object]:
+        """按 offset 或 cursor 取一页；rows 是已排好序的列表，只切片不复制全量"""
+        if cursor:
+            offset = self.decode_cursor(cursor, scope)
+        offset = max(0, offset)
+        limit = max(1, min(self.MAX_PAGE_SIZE, limit or self.DEFAULT_PAGE_SIZE))
+        page = rows[offset:offset + limit]
+        next_offset = offset + len(page)
+        return {
+            "rows": page,
+            "offset": offset,
+            "limit": limit,
+            "total": len(rows),
+            "next_cursor": self.encode_cursor(next_offset, scope) if next_offset < len(rows) else None,
+        }
+
+    @staticmethod
+    def _filter_position(rows: List[Dict[str, object]], search: str) -> List[Dict[str, object]]:
+        try:
+            sx, sy = [int(x.strip()) for x in search.split(",")]
+        except Exception:
+            return []
+        return [r for r in rows if r["x"] == sx and r["y"] == sy]
+
     @staticmethod
     def _sort_rows(rows: List[Dict[str, object]], key: str, desc: bool) -> List[Dict[str, object]]:
         if not rows:
@@ -504,22 +907,26 @@ class UniverseService:
             return sorted(rows, key=lambda r: (r["x"], r["y"]), reverse=desc)
         if key == "y" and "x" in rows[0]:
             return sorted(rows, key=lambda r: (r["y"], r["x"]), reverse=desc)
-        return sorted(rows, key=lambda r: (r[key], r.get("x", 0), r.get("y", 0)), reverse=desc)
+        # 懒加载模式下未扫描的星系行星数为 None，排在最前（升序）
+        return sorted(rows, key=lambda r: (-1 if r[key] is None else r[key], r.get("x", 0), r.get("y", 0)), reverse=desc)
 
     def list_galaxies(self, sort_key: str = "x", desc: bool = False, search: str = "") -> List[Dict[str, object]]:
-        self.preload_all()
-        rows = [{"x": g["x"], "y": g["y"], "planet_count": g["planet_count"]} for g in self.galaxies.values()]
-        if search:
-            try:
-                sx, sy = [int(x.strip()) for x in search.split(",")]
-                rows = [r for r in rows if r["x"] == sx and r["y"] == sy]
-            except Exception:
-                rows = []
-        return self._sort_rows(rows, sort_key, desc)
+        """返回缓存的排序列表，调用方不要修改"""
+        rows = self._memo(("galaxies", sort_key, desc), lambda: self._sort_rows(self._galaxy_rows(), sort_key, desc))
+        return self._filter_position(rows, search) if search else rows
+
+    def _galaxy_rows(self) -> List[Dict[str, object]]:
+        if self.index is not None:
+            rows = [{"x": x, "y": y, "planet_count": n} for x, y, n in self.index.galaxy_summaries()]
+        elif self.preloaded:
+            rows = [{"x": g["x"], "y": g["y"], "planet_count": g["planet_count"]} for g in self.galaxies.values()]
+        else:
+            counts = self._galaxy_planet_counts
+            rows = [{"x": x, "y": y, "planet_count": counts.get((x, y))} for x, y in self._lazy_galaxy_positions()]
+        return rows
 
     def galaxy_info(self, gx: int, gy: int) -> Dict[str, object]:
-        self.preload_all()
-        g = self.galaxies[(gx, gy)]
+        g = self._galaxy(gx, gy)
         return {
             "level": "galaxy",
             "x": gx,
@@ -530,28 +937,29 @@ class UniverseService:
         }
 
     def list_systems(self, gx: int, gy: int, sort_key: str = "x", desc: bool = False, search: str = "") -> List[Dict[str, object]]:
-        self.preload_all()
-        g = self.galaxies[(gx, gy)]
+        """返回缓存的排序列表，调用方不要修改"""
+        rows = self._memo(
+            ("systems", gx, gy, sort_key, desc),
+            lambda: self._sort_rows(self._system_rows(gx, gy), sort_key, desc),
+            self.SCOPE_STATIC,
+        )
+        return self._filter_position(rows, search) if search else rows
+
+    def _system_rows(self, gx: int, gy: int) -> List[Dict[str, object]]:
+        g = self._galaxy(gx, gy)
         rows = []
         for skey in g["system_keys"]:
-            s = self.systems[skey]
+            s = self._system(*skey)
             rows.append({
                 "x": s["sx"],
                 "y": s["sy"],
                 "star_type": s["star_type"],
                 "planet_count": s["planet_count"],
             })
-        if search:
-            try:
-                sx, sy = [int(x.strip()) for x in search.split(",")]
-                rows = [r for r in rows if r["x"] == sx and r["y"] == sy]
-            except Exception:
-                rows = []
-        return self._sort_rows(rows, sort_key, desc)
+        return rows
 
     def system_info(self, gx: int, gy: int, sx: int, sy: int) -> Dict[str, object]:
-        self.preload_all()
-        s = self.systems[(gx, gy, sx, sy)]
+        s = self._system(gx, gy, sx, sy)
         return {
             "level": "system",
             "gx": gx,
@@ -564,20 +972,34 @@ class UniverseService:
         }
 
     def list_planets(self, gx: int, gy: int, sx: int, sy: int, sort_key: str = "planet_x", desc: bool = False) -> List[Dict[str, object]]:
-        self.preload_all()
-        s = self.systems[(gx, gy, sx, sy)]
-        rows = [asdict(self.planets_by_key[k]) for k in s["planet_keys"]]
-        if rows and sort_key not in rows[0]:
-            sort_key = "planet_x"
-        rows = sorted(rows, key=lambda x: x[sort_key], reverse=desc)
-        return rows
+        """返回缓存的排序列表，调用方不要修改"""
+        def build() -> List[Dict[str, object]]:
+            s = self._system(gx, gy, sx, sy)
+            rows = [asdict(self._planet(k)) for k in s["planet_keys"]]
+            key = sort_key if rows and sort_key in rows[0] else "planet_x"
+            return sorted(rows, key=lambda x: x[key], reverse=desc)
+
+        return self._memo(("planets", gx, gy, sx, sy, sort_key, desc), build, self.SCOPE_STATIC)
 
     def planet_info(self, map_key: str) -> Dict[str, object]:
-        self.preload_all()
-        return asdict(self.planets_by_key[map_key])
+        return asdict(self._planet(map_key))
 
     def app_info(self) -> Dict[str, object]:
-        self.preload_all()
+        if self.index is not None:
+            return {
+                "galaxy_count": self.index.galaxy_count,
+                "system_count": self.index.system_count,
+                "planet_count": self.index.planet_count,
+                "preload_seconds": 0.0,
+            }
+        if not self.preloaded:
+            # 后台预加载尚未完成时只给出已扫描部分的数量
+            return {
+                "galaxy_count": len(self._lazy_galaxy_positions()),
+                "system_count": len(self.systems),
+                "planet_count": len(self.planets_by_key),
+                "preload_seconds": round(self.preload_seconds, 2),
+            }
         return {
             "galaxy_count": len(self.galaxies),
             "system_count": len(self.systems),
@@ -585,31 +1007,81 @@ class UniverseService:
             "preload_seconds": round(self.preload_seconds, 2),
         }
 
+    def _iter_system_planets(self) -> Iterable[Tuple[Dict[str, object], List[Tuple[int, int]]]]:
+        """逐个恒星系给出 (恒星系信息, [(行星大小, 矿物稀疏度)])；没有索引时需要全量数据"""
+        if self.index is not None:
+            yield from self.index.iter_system_planets()
+            return
+        self.preload_all()
+        for s in self.systems.values():
+            yield s, [(p.planet_size, p.mineral_density) for p in (self.planets_by_key[k] for k in s["planet_keys"])]
+
     def list_system_rankings(
         self,
         sort_key: str = "overall_area",
         desc: Optional[bool] = None,
         page: int = 1,
         page_size: int = 25,
+        cursor: Optional[str] = None,
     ) -> Dict[str, object]:
-        self.preload_all()
+        valid_keys = {"overall_area", "avg_mineral_density", "score_v", "planet_count", "gx", "gy", "sx", "sy"}
+        if sort_key not in valid_keys:
+            sort_key = "overall_area"
+
+        if desc is None:
+            desc = sort_key != "avg_mineral_density"
+
+        # 每个排序键只排序一次，之后每页只是切片
+        rows = self._memo(
+            ("rankings", sort_key, desc),
+            lambda: sorted(
+                self._ranking_rows(),
+                key=lambda r: (r[sort_key], r["gx"], r["gy"], r["sx"], r["sy"]),
+                reverse=desc,
+            ),
+        )
+
+        page_size = max(1, min(100, page_size))
+        total = len(rows)
+        total_pages = max(1, (total + page_size - 1) // page_size)
+        if cursor:
+            begin = min(self.decode_cursor(cursor), total)
+            page = begin // page_size + 1
+        else:
+            page = min(max(1, page), total_pages)
+            begin = (page - 1) * page_size
+        end = begin + page_size
+        return {
+            "rows": rows[begin:end],
+            "page": page,
+            "page_size": page_size,
+            "total": total,
+            "total_pages": total_pages,
+            "sort_key": sort_key,
+            "desc": desc,
+            "next_cursor": self.encode_cursor(end) if end < total else None,
+        }
+
+    def _ranking_rows(self) -> List[Dict[str, object]]:
+        return self._memo(("ranking_rows",), self._compute_ranking_rows)
+
+    def _compute_ranking_rows(self) -> List[Dict[str, object]]:
         rows: List[Dict[str, object]] = []
         threshold_t = 50
 
-        for s in self.systems.values():
-            planets = [self.planets_by_key[k] for k in s["planet_keys"]]
+        for s, planets in self._iter_system_planets():
             if not planets:
                 continue
 
-            overall_area = sum(p.planet_size**2 for p in planets)
-            avg_mineral_density = sum(p.mineral_density for p in planets) / len(planets)
+            overall_area = sum(size**2 for size, _ in planets)
+            avg_mineral_density = sum(mineral for _, mineral in planets) / len(planets)
             planet_count = len(planets)
             avg_area = overall_area / planet_count
 
             single_planet_score_sum = 0.0
-            for p in planets:
-                planet_area = p.planet_size**2
-                abundance = max(p.mineral_density, 1.000000001)
+            for size, mineral in planets:
+                planet_area = size**2
+                abundance = max(mineral, 1.000000001)
                 single_planet_score_sum += planet_area / ((abundance - 1) ** 2.5)
 
             system_weight = math.sqrt(planet_count) / math.log2((avg_area / threshold_t) + 2)
@@ -631,36 +1103,7 @@ class UniverseService:
                     "planet_type_stats": dict(s["planet_type_counter"]),
                 }
             )
-
-        valid_keys = {"overall_area", "avg_mineral_density", "score_v", "planet_count", "gx", "gy", "sx", "sy"}
-        if sort_key not in valid_keys:
-            sort_key = "overall_area"
-
-        if desc is None:
-            desc = sort_key != "avg_mineral_density"
-
-        rows = sorted(
-            rows,
-            key=lambda r: (r[sort_key], r["gx"], r["gy"], r["sx"], r["sy"]),
-            reverse=desc,
-        )
-
-        page = max(1, page)
-        page_size = max(1, min(100, page_size))
-        total = len(rows)
-        total_pages = max(1, (total + page_size - 1) // page_size)
-        page = min(page, total_pages)
-        begin = (page - 1) * page_size
-        end = begin + page_size
-        return {
-            "rows": rows[begin:end],
-            "page": page,
-            "page_size": page_size,
-            "total": total,
-            "total_pages": total_pages,
-            "sort_key": sort_key,
-            "desc": desc,
-        }
+        return rows
 
 
 HTML = """<!doctype html>
@@ -945,7 +1388,7 @@ async function loadList(search=''){
     for (const r of rows){
       const div = document.createElement('div');
       div.className = 'node';
-      div.textContent = `星系 ${r.x},${r.y} · 星球 ${r.planet_count}`;
+      div.textContent = `星系 ${r.x},${r.y} · 星球 ${r.planet_count ?? '?'}`;
       div.onclick = async ()=>{
         state.level = 'system';
         state.gx = r.x; state.gy = r.y;
@@ -1335,6 +1778,22 @@ poll();
 
 class AppHTTP(BaseHTTPRequestHandler):
     service = UniverseService()
+    # 数据接口的结果只随数据版本变化，按 (版本, 路径, 参数) 缓存序列化后的响应体
+    # 只有星系列表和排行榜用全局版本，其余接口的结果只由坐标决定
+    GLOBAL_VERSION_PATHS = {"/api/galaxies", "/api/system_rankings"}
+    CACHEABLE = {
+        "/api/galaxies",
+        "/api/galaxy_info",
+        "/api/systems",
+        "/api/system_info",
+        "/api/planets",
+        "/api/planet",
+        "/api/system_rankings",
+    }
+    RESPONSE_CACHE_SIZE = 256
+    GZIP_MIN_SIZE = 1024
+    _response_cache: "OrderedDict[str, List]" = OrderedDict()
+    _response_cache_lock = threading.Lock()
 
     def _json(self, data: object, status: int = 200) -> None:
         raw = json.dumps(data, ensure_ascii=False).encode("utf-8")
@@ -1352,6 +1811,152 @@ class AppHTTP(BaseHTTPRequestHandler):
         self.end_headers()
         self.wfile.write(raw)
 
+    @staticmethod
+    def _etag(version: str, path: str, params: Dict[str, str]) -> str:
+        text = "|".join([version, path] + [f"{k}={params[k]}" for k in sorted(params)])
+        return 'W/"' + hashlib.sha1(text.encode("utf-8")).hexdigest()[:16] + '"'
+
+    def _not_modified(self, etag: str) -> bool:
+        header = self.headers.get("If-None-Match")
+        if not header:
+            return False
+        tags = [t.strip() for t in header.split(",")]
+        return "*" in tags or etag in tags
+
+    @staticmethod
+    def _accepts_gzip(header: str) -> bool:
+        """按 Accept-Encoding 的 q 值判断，显式的 gzip 优先于 *，q=0 表示拒绝。"""
+        qualities: Dict[str, float] = {}
+        for item in header.split(","):
+            coding, _, rest = item.partition(";")
+            coding = coding.strip().lower()
+            if not coding:
+                continue
+            q = 1.0
+            for param in rest.split(";"):
+                key, _, value = param.partition("=")
+                if key.strip().lower() == "q":
+                    try:
+                        q = float(value.strip())
+                    except ValueError:
+                        q = 0.0
+            qualities[coding] = q
+        for coding in ("gzip", "x-gzip", "*"):
+            if coding in qualities:
+                return qualities[coding] > 0
+        return False
+
+    def _scope(self, path: str) -> str:
+        return UniverseService.SCOPE_GLOBAL if path in self.GLOBAL_VERSION_PATHS else UniverseService.SCOPE_STATIC
+
+    def _cached_json(self, path: str, params: Dict[str, str]) -> None:
+        scope = self._scope(path)
+        etag = self._etag(self.service.data_version(scope), path, params)
+        if self._not_modified(etag):
+            self.send_response(304)
+            self.send_header("ETag", etag)
+            self.send_header("Cache-Control", "no-cache")
+            self.end_headers()
+            return
+
+        with self._response_cache_lock:
+            entry = self._response_cache.get(etag)
+            if entry is not None:
+                self._response_cache.move_to_end(etag)
+        if entry is None:
+            raw = json.dumps(self._api(path, params), ensure_ascii=False).encode("utf-8")
+            # 懒扫描模式下本次请求可能让版本前进，按算完后的版本存
+            etag = self._etag(self.service.data_version(scope), path, params)
+            entry = [raw, None]
+            with self._response_cache_lock:
+                self._response_cache[etag] = entry
+                while len(self._response_cache) > self.RESPONSE_CACHE_SIZE:
+                    self._response_cache.popitem(last=False)
+
+        raw = entry[0]
+        use_gzip = len(raw) >= self.GZIP_MIN_SIZE and self._accepts_gzip(self.headers.get("Accept-Encoding", ""))
+        if use_gzip:
+            if entry[1] is None:
+                entry[1] = gzip.compress(raw, compresslevel=5)
+            raw = entry[1]
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json; charset=utf-8")
+        self.send_header("ETag", etag)
+        self.send_header("Cache-Control", "no-cache")
+        self.send_header("Vary", "Accept-Encoding")
+        if use_gzip:
+            self.send_header("Content-Encoding", "gzip")
+        self.send_header("Content-Length", str(len(raw)))
+        self.end_headers()
+        self.wfile.write(raw)
+
+    def _page(self, rows: List[Dict[str, object]], params: Dict[str, str], scope: str) -> object:
+        """带 offset / limit / cursor 参数时返回分页结构，否则保持原来的完整列表"""
+        if not any(k in params for k in ("offset", "limit", "cursor")):
+            return rows
+        limit = params.get("limit")
+        return self.service.paginate(
+            rows,
+            offset=int(params.get("offset", "0")),
+            limit=int(limit) if limit else None,
+            cursor=params.get("cursor") or None,
+            scope=scope,
+        )
+
+    def _api(self, path: str, params: Dict[str, str]) -> object:
+        if path == "/api/galaxies":
+            return self._page(
+                self.service.list_galaxies(
+                    sort_key=params.get("sort_key", "x"),
+                    desc=params.get("desc", "0") == "1",
+                    search=params.get("search", ""),
+                ),
+                params,
+                self._scope(path),
+            )
+        if path == "/api/galaxy_info":
+            return self.service.galaxy_info(int(params["gx"]), int(params["gy"]))
+        if path == "/api/systems":
+            return self._page(
+                self.service.list_systems(
+                    int(params["gx"]),
+                    int(params["gy"]),
+                    sort_key=params.get("sort_key", "x"),
+                    desc=params.get("desc", "0") == "1",
+                    search=params.get("search", ""),
+                ),
+                params,
+                self._scope(path),
+            )
+        if path == "/api/system_info":
+            return self.service.system_info(int(params["gx"]), int(params["gy"]), int(params["sx"]), int(params["sy"]))
+        if path == "/api/planets":
+            return self._page(
+                self.service.list_planets(
+                    int(params["gx"]),
+                    int(params["gy"]),
+                    int(params["sx"]),
+                    int(params["sy"]),
+                    sort_key=params.get("sort_key", "planet_x"),
+                    desc=params.get("desc", "0") == "1",
+                ),
+                params,
+                self._scope(path),
+            )
+        if path == "/api/planet":
+            return self.service.planet_info(params["map_key"])
+        if path == "/api/system_rankings":
+            desc_value = params.get("desc")
+            desc = None if desc_value is None else desc_value == "1"
+            return self.service.list_system_rankings(
+                sort_key=params.get("sort_key", "overall_area"),
+                desc=desc,
+                page=int(params.get("page", "1")),
+                page_size=int(params.get("page_size", "25")),
+                cursor=params.get("cursor") or None,
+            )
+        raise KeyError(path)
+
     def do_GET(self) -> None:  # noqa: N802
         path, _, query = self.path.partition("?")
         params_raw = parse_qs(query, keep_blank_values=True)
@@ -1373,58 +1978,8 @@ class AppHTTP(BaseHTTPRequestHandler):
             if path == "/api/app_info":
                 self._json(self.service.app_info())
                 return
-            if path == "/api/galaxies":
-                self._json(
-                    self.service.list_galaxies(
-                        sort_key=params.get("sort_key", "x"),
-                        desc=params.get("desc", "0") == "1",
-                        search=params.get("search", ""),
-                    )
-                )
-                return
-            if path == "/api/galaxy_info":
-                self._json(self.service.galaxy_info(int(params["gx"]), int(params["gy"])))
-                return
-            if path == "/api/systems":
-                self._json(
-                    self.service.list_systems(
-                        int(params["gx"]),
-                        int(params["gy"]),
-                        sort_key=params.get("sort_key", "x"),
-                        desc=params.get("desc", "0") == "1",
-                        search=params.get("search", ""),
-                    )
-                )
-                return
-            if path == "/api/system_info":
-                self._json(self.service.system_info(int(params["gx"]), int(params["gy"]), int(params["sx"]), int(params["sy"])))
-                return
-            if path == "/api/planets":
-                self._json(
-                    self.service.list_planets(
-                        int(params["gx"]),
-                        int(params["gy"]),
-                        int(params["sx"]),
-                        int(params["sy"]),
-                        sort_key=params.get("sort_key", "planet_x"),
-                        desc=params.get("desc", "0") == "1",
-                    )
-                )
-                return
-            if path == "/api/planet":
-                self._json(self.service.planet_info(params["map_key"]))
-                return
-            if path == "/api/system_rankings":
-                desc_value = params.get("desc")
-                desc = None if desc_value is None else desc_value == "1"
-                self._json(
-                    self.service.list_system_rankings(
-                        sort_key=params.get("sort_key", "overall_area"),
-                        desc=desc,
-                        page=int(params.get("page", "1")),
-                        page_size=int(params.get("page_size", "25")),
-                    )
-                )
+            if path in self.CACHEABLE:
+                self._cached_json(path, params)
                 return
             self._json({"error": "not found"}, status=404)
         except Exception as e:
@@ -1504,8 +2059,6 @@ def run_app() -> None:
     def bootstrap():
         wait_http_ready(15.0)
         AppHTTP.service.ensure_preload_started()
-        while not AppHTTP.service.preloaded:
-            time.sleep(0.2)
 
         def open_main_window() -> None:
             nonlocal loading_window
@@ -1545,12 +2098,24 @@ def run_app() -> None:
 
 
 
+def build_index(path: str = DEFAULT_INDEX_PATH) -> None:
+    """全量扫描后写出宇宙索引；Java UniverseScanner 可生成相同格式的文件，速度更快。"""
+    verify_samples()
+    service = UniverseService(use_index=False)
+    service.preload_all()
+    UniverseIndex.write(path, service.galaxies, service.systems, service.planets_by_key)
+    print(f"[PlanetInfo] 已写出宇宙索引: {path}")
+
+
 if __name__ == "__main__":
-    if not os.environ.get("DISPLAY") and os.name != "nt":
+    if len(sys.argv) > 1 and sys.argv[1] == "--build-index":
+        build_index(sys.argv[2] if len(sys.argv) > 2 else DEFAULT_INDEX_PATH)
+    elif not os.environ.get("DISPLAY") and os.name != "nt":
         verify_samples()
-        AppHTTP.service.ensure_preload_started()
-        while not AppHTTP.service.preloaded:
-            time.sleep(0.2)
-        print("验证通过（当前无图形环境，已预加载全部数据，跳过 Edge WebView 启动）")
+        if AppHTTP.service.index is None:
+            AppHTTP.service.preload_all()
+            print("验证通过（当前无图形环境，已预加载全部数据，跳过 Edge WebView 启动）")
+        else:
+            print("验证通过（当前无图形环境，使用宇宙索引，跳过 Edge WebView 启动）")
     else:
         run_app()